@@ -0,0 +1,170 @@
+#include "append_log.h"
+
+#include <iostream>
+#include <cstring>
+#include <unistd.h>
+
+int append_log_check_header(const unsigned char* data, size_t size, const char* magic, uint32_t version) {
+    if (size < APPEND_LOG_HEADER_SIZE || memcmp(data, magic, 4)) {
+        return 1;
+    }
+    uint32_t file_version;
+    memcpy(&file_version, data + 4, sizeof(file_version));
+
+    return file_version != version;
+}
+
+append_log_t::~append_log_t() {
+    close();
+}
+
+int append_log_t::open(const std::string& path, const char* magic, uint32_t version, const char* name, std::vector<unsigned char>* contents) {
+    close();
+    m_path = path;
+    m_name = name;
+    contents->clear();
+
+    m_file = fopen(m_path.c_str(), "a+b");
+    if (!m_file) {
+        std::cerr << "CLIENT failed to open " << m_name << " '" << m_path << "'" << std::endl;
+        return 1;
+    }
+
+    fseek(m_file, 0, SEEK_END);
+    const long file_size = ftell(m_file);
+    if (file_size <= 0) {
+        contents->resize(APPEND_LOG_HEADER_SIZE);
+        memcpy(contents->data(), magic, 4);
+        memcpy(contents->data() + 4, &version, sizeof(version));
+        if (file_size < 0 || fwrite(contents->data(), 1, contents->size(), m_file) != contents->size() || fflush(m_file)) {
+            std::cerr << "CLIENT failed to write the header of " << m_name << " '" << m_path << "'" << std::endl;
+            close();
+            return 1;
+        }
+        m_size = APPEND_LOG_HEADER_SIZE;
+        return 0;
+    }
+
+    contents->resize(file_size);
+    fseek(m_file, 0, SEEK_SET);
+    if (fread(contents->data(), 1, contents->size(), m_file) != contents->size()) {
+        std::cerr << "CLIENT failed to read " << m_name << " '" << m_path << "'" << std::endl;
+        close();
+        return 1;
+    }
+    if (append_log_check_header(contents->data(), contents->size(), magic, version)) {
+        std::cerr << "CLIENT '" << m_path << "' is not a version " << version << " " << m_name << " file" << std::endl;
+        close();
+        return 1;
+    }
+    fseek(m_file, 0, SEEK_END);
+    m_size = contents->size();
+
+    return 0;
+}
+
+void append_log_t::close() {
+    if (m_file) {
+        fclose(m_file);
+        m_file = 0;
+    }
+    m_size = 0;
+}
+
+bool append_log_t::is_open() const {
+    return m_file != 0;
+}
+
+int append_log_t::truncate_torn_tail(uint64_t size) {
+    if (!m_file || m_size <= size) {
+        return 0;
+    }
+
+    std::cerr << "CLIENT " << m_name << " '" << m_path << "' truncated from " << m_size << " to " << size << " bytes" << std::endl;
+    fflush(m_file);
+    if (ftruncate(fileno(m_file), size) || fseek(m_file, 0, SEEK_END)) {
+        std::cerr << "CLIENT failed to truncate " << m_name << " '" << m_path << "'" << std::endl;
+        close();
+        return 1;
+    }
+    m_size = size;
+
+    return 0;
+}
+
+int append_log_t::append(const void* data, size_t size) {
+    if (!m_file) {
+        return 1;
+    }
+    if (fwrite(data, 1, size, m_file) == size && fflush(m_file) == 0) {
+        m_size += size;
+        return 0;
+    }
+
+    // a torn record in the middle would hide every record after it from the next open
+    clearerr(m_file);
+    if (ftruncate(fileno(m_file), m_size) || fseek(m_file, 0, SEEK_END)) {
+        std::cerr << "CLIENT failed to roll back a " << m_name << " record, '" << m_path << "' is not written to for the rest of the session" << std::endl;
+        close();
+    } else {
+        std::cerr << "CLIENT failed to append to " << m_name << " '" << m_path << "'" << std::endl;
+    }
+
+    return 1;
+}
+
+int append_log_t::clear() {
+    if (!m_file) {
+        return 1;
+    }
+
+    fflush(m_file);
+    if (ftruncate(fileno(m_file), APPEND_LOG_HEADER_SIZE) || fseek(m_file, 0, SEEK_END)) {
+        std::cerr << "CLIENT failed to clear " << m_name << " '" << m_path << "'" << std::endl;
+        close();
+        return 1;
+    }
+    m_size = APPEND_LOG_HEADER_SIZE;
+
+    return 0;
+}
+
+int append_log_t::sync() {
+    if (!m_file) {
+        return 1;
+    }
+
+    return fflush(m_file) || fsync(fileno(m_file));
+}
+
+int append_log_t::rewrite(const std::vector<unsigned char>& contents) {
+    if (!m_file) {
+        return 1;
+    }
+
+    const std::string tmp_path = m_path + ".tmp";
+    FILE* tmp_file = fopen(tmp_path.c_str(), "wb");
+    bool is_written = tmp_file != 0;
+    if (tmp_file) {
+        is_written = fwrite(contents.data(), 1, contents.size(), tmp_file) == contents.size();
+        is_written = fflush(tmp_file) == 0 && fsync(fileno(tmp_file)) == 0 && is_written;
+        is_written = fclose(tmp_file) == 0 && is_written;
+    }
+    if (!is_written || rename(tmp_path.c_str(), m_path.c_str())) {
+        std::cerr << "CLIENT failed to rewrite " << m_name << " '" << m_path << "'" << std::endl;
+        remove(tmp_path.c_str());
+        return 1;
+    }
+
+    fclose(m_file);
+    m_file = fopen(m_path.c_str(), "a+b");
+    if (!m_file) {
+        std::cerr << "CLIENT failed to reopen " << m_name << " '" << m_path << "'" << std::endl;
+        m_size = 0;
+        return 1;
+    }
+    fseek(m_file, 0, SEEK_END);
+    m_size = contents.size();
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+#ifndef APPEND_LOG_H
+# define APPEND_LOG_H
+
+# include <string>
+# include <vector>
+# include <cstdio>
+# include <cstdint>
+
+// 4 byte magic, u32 version
+# define APPEND_LOG_HEADER_SIZE 8
+
+// returns 0 if data starts with the header of a log of that magic and version
+int append_log_check_header(const unsigned char* data, size_t size, const char* magic, uint32_t version);
+
+/**
+ * Append-only file of records behind a magic and version header, what the stores that replay their file on open have in common.
+ * The records are the store's own, the log only guarantees a crash never leaves anything but whole records followed by at most one torn one,
+ * which the store drops on open with truncate_torn_tail once it found where its last whole record ends.
+ * Not thread safe, the store's lock covers it.
+ *
+ * Example call:
+ * append_log_t log;
+ * std::vector<unsigned char> contents;
+ * if (log.open("history.bin", "LTHS", 1, "history", &contents) == 0) {
+ *   const size_t valid_size = decode_records(contents, APPEND_LOG_HEADER_SIZE);
+ *   log.truncate_torn_tail(valid_size);
+ * }
+ * log.append(record.data(), record.size());
+*/
+struct append_log_t {
+    append_log_t() = default;
+    append_log_t(const append_log_t&) = delete;
+    append_log_t& operator=(const append_log_t&) = delete;
+    ~append_log_t();
+
+    /**
+     * Creates the file with its header if it is missing or empty, otherwise checks the header and reads the whole file into contents,
+     * the records start at APPEND_LOG_HEADER_SIZE. name is how the file is called in the logs, e.g. "history".
+    */
+    int  open(const std::string& path, const char* magic, uint32_t version, const char* name, std::vector<unsigned char>* contents);
+    void close();
+    bool is_open() const;
+
+    // the first size bytes of the file are whole records, the rest was torn by a crash and is dropped so appends stay decodable
+    int  truncate_torn_tail(uint64_t size);
+    // writes the record whole or rolls the file back to where it was, the log is closed if even that fails
+    int  append(const void* data, size_t size);
+    // drops every record
+    int  clear();
+    // the appended records reach the disk, appends only reach the os
+    int  sync();
+    // replaces the file by contents, header included, through a temporary file so a crash leaves either version
+    int  rewrite(const std::vector<unsigned char>& contents);
+
+    std::string m_path;
+    std::string m_name;
+    FILE*       m_file = 0;
+    // header included
+    uint64_t    m_size = 0;
+};
+
+#endif // APPEND_LOG_H
@@ -0,0 +1,454 @@
+#include "attribution.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cctype>
+
+#define ATTRIBUTION_MAGIC "LTCA"
+#define ATTRIBUTION_VERSION 1
+
+static const double no_max = 1e300;
+
+// challenge_id, source, field, queue, min, max, is_counted, is_win_required, is_distinct_per_champion, before_ms
+static const attribution_rule_t attribution_rules[] = {
+    { 101101, ATTRIBUTION_SOURCE_STAT, "challenges.damagePerMinute", ATTRIBUTION_QUEUE_ARAM, 1800.0, no_max, true, false, false, 0 },
+    { 101102, ATTRIBUTION_SOURCE_STAT, "pentaKills", ATTRIBUTION_QUEUE_ARAM, 2.0, no_max, true, false, false, 0 },
+    { 103201, ATTRIBUTION_SOURCE_STAT, "challenges.takedownsInAlcove", ATTRIBUTION_QUEUE_ARAM, 0.0, no_max, false, false, false, 0 },
+    { 120001, ATTRIBUTION_SOURCE_ONE, 0, ATTRIBUTION_QUEUE_COOP_VS_AI, 0.0, no_max, true, true, false, 0 },
+    { 120002, ATTRIBUTION_SOURCE_ONE, 0, ATTRIBUTION_QUEUE_COOP_VS_AI, 0.0, no_max, true, true, true, 0 },
+    { 120003, ATTRIBUTION_SOURCE_STAT, "kills", ATTRIBUTION_QUEUE_COOP_VS_AI, 0.0, no_max, false, false, false, 0 },
+    { 201001, ATTRIBUTION_SOURCE_STAT, "challenges.takedownOnFirstTurret", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 0.0, no_max, false, false, false, 0 },
+    { 201002, ATTRIBUTION_SOURCE_STAT, "challenges.laneMinionsFirst10Minutes", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 80.0, no_max, true, false, false, 0 },
+    { 202101, ATTRIBUTION_SOURCE_STAT, "challenges.maxCsAdvantageOnLaneOpponent", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 100.0, no_max, true, true, false, 0 },
+    { 202105, ATTRIBUTION_SOURCE_STAT, "challenges.maxLevelLeadLaneOpponent", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 3.0, no_max, true, false, false, 0 },
+    { 202204, ATTRIBUTION_SOURCE_STAT, "challenges.damagePerMinute", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 700.0, no_max, true, false, false, 0 },
+    { 202303, ATTRIBUTION_SOURCE_STAT, "deaths", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 0.0, 0.0, true, true, true, 0 },
+    { 202304, ATTRIBUTION_SOURCE_STAT, "pentaKills", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 2.0, no_max, true, false, false, 0 },
+    { 202305, ATTRIBUTION_SOURCE_STAT, "challenges.goldPerMinute", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 450.0, no_max, true, false, false, 0 },
+    { 203102, ATTRIBUTION_SOURCE_STAT, "challenges.dodgeSkillShotsSmallWindow", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 0.0, no_max, false, false, false, 0 },
+    { 203301, ATTRIBUTION_SOURCE_STAT, "challenges.soloKills", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 0.0, no_max, false, false, false, 0 },
+    { 203409, ATTRIBUTION_SOURCE_STAT, "challenges.epicMonsterSteals", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 2.0, no_max, true, false, false, 0 },
+    { 204102, ATTRIBUTION_SOURCE_STAT, "challenges.visionScorePerMinute", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 2.0, no_max, true, false, false, 0 },
+    { 204201, ATTRIBUTION_SOURCE_TIMELINE_EVENTS, "WARD_KILL", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 10.0, no_max, true, false, false, 20 * 60 * 1000 },
+    { 210002, ATTRIBUTION_SOURCE_STAT, "pentaKills", ATTRIBUTION_QUEUE_ANY, 1.0, no_max, true, false, true, 0 },
+    { 210005, ATTRIBUTION_SOURCE_STAT, "challenges.kda", ATTRIBUTION_QUEUE_RANKED_SOLO, 3.0, no_max, true, false, false, 0 },
+    { 301101, ATTRIBUTION_SOURCE_STAT, "challenges.epicMonsterKillsWithin30SecondsOfSpawn", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 0.0, no_max, false, false, false, 0 },
+    { 302101, ATTRIBUTION_SOURCE_STAT, "challenges.takedownsBeforeJungleMinionSpawn", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 0.0, no_max, false, false, false, 0 },
+    { 302202, ATTRIBUTION_SOURCE_TIMELINE_EVENTS, "BUILDING_KILL", ATTRIBUTION_QUEUE_SUMMONERS_RIFT, 0.0, no_max, false, false, false, 14 * 60 * 1000 },
+    // premade is not part of the match data, any 5 stack of the faction counts
+    { 303501, ATTRIBUTION_SOURCE_FACTION_TEAM, "bandlecity", ATTRIBUTION_QUEUE_ANY, 1.0, 1.0, true, true, false, 0 },
+    { 303502, ATTRIBUTION_SOURCE_FACTION_TEAM, "bilgewater", ATTRIBUTION_QUEUE_ANY, 1.0, 1.0, true, true, false, 0 },
+    { 303503, ATTRIBUTION_SOURCE_FACTION_TEAM, "demacia", ATTRIBUTION_QUEUE_ANY, 1.0, 1.0, true, true, false, 0 },
+    { 303504, ATTRIBUTION_SOURCE_FACTION_TEAM, "freljord", ATTRIBUTION_QUEUE_ANY, 1.0, 1.0, true, true, false, 0 },
+    { 303505, ATTRIBUTION_SOURCE_FACTION_TEAM, "ionia", ATTRIBUTION_QUEUE_ANY, 1.0, 1.0, true, true, false, 0 },
+    { 303506, ATTRIBUTION_SOURCE_FACTION_TEAM, "ixtal", ATTRIBUTION_QUEUE_ANY, 1.0, 1.0, true, true, false, 0 },
+    { 303507, ATTRIBUTION_SOURCE_FACTION_TEAM, "noxus", ATTRIBUTION_QUEUE_ANY, 1.0, 1.0, true, true, false, 0 },
+    { 303508, ATTRIBUTION_SOURCE_FACTION_TEAM, "piltover", ATTRIBUTION_QUEUE_ANY, 1.0, 1.0, true, true, false, 0 },
+    { 303509, ATTRIBUTION_SOURCE_FACTION_TEAM, "shadowisles", ATTRIBUTION_QUEUE_ANY, 1.0, 1.0, true, true, false, 0 },
+    { 303510, ATTRIBUTION_SOURCE_FACTION_TEAM, "shurima", ATTRIBUTION_QUEUE_ANY, 1.0, 1.0, true, true, false, 0 },
+    { 303511, ATTRIBUTION_SOURCE_FACTION_TEAM, "targon", ATTRIBUTION_QUEUE_ANY, 1.0, 1.0, true, true, false, 0 },
+    { 303512, ATTRIBUTION_SOURCE_FACTION_TEAM, "void", ATTRIBUTION_QUEUE_ANY, 1.0, 1.0, true, true, false, 0 },
+    { 303513, ATTRIBUTION_SOURCE_FACTION_TEAM, "zaun", ATTRIBUTION_QUEUE_ANY, 1.0, 1.0, true, true, false, 0 },
+    { 402501, ATTRIBUTION_SOURCE_STAT, "challenges.effectiveHealAndShielding", ATTRIBUTION_QUEUE_ANY, 0.0, no_max, false, false, false, 0 },
+    { 402502, ATTRIBUTION_SOURCE_STAT, "challenges.enemyChampionImmobilizations", ATTRIBUTION_QUEUE_ANY, 0.0, no_max, false, false, false, 0 },
+    { 402503, ATTRIBUTION_SOURCE_STAT, "challenges.abilityUses", ATTRIBUTION_QUEUE_ANY, 0.0, no_max, false, false, false, 0 }
+};
+
+const attribution_rule_t* attribution_find_rule(int challenge_id) {
+    for (const attribution_rule_t& rule : attribution_rules) {
+        if (rule.challenge_id == challenge_id) {
+            return &rule;
+        }
+    }
+
+    return 0;
+}
+
+static bool is_queue_matching(attribution_queue_t queue, int queue_id) {
+    switch (queue) {
+    case ATTRIBUTION_QUEUE_ANY: return true;
+    case ATTRIBUTION_QUEUE_SUMMONERS_RIFT: return queue_id == 400 || queue_id == 420 || queue_id == 430 || queue_id == 440 || queue_id == 490 || queue_id == 700;
+    case ATTRIBUTION_QUEUE_RANKED_SOLO: return queue_id == 420;
+    case ATTRIBUTION_QUEUE_ARAM: return queue_id == 450;
+    case ATTRIBUTION_QUEUE_COOP_VS_AI: return 830 <= queue_id && queue_id <= 890;
+    default: return false;
+    }
+}
+
+static bool is_game_mode_matching(attribution_queue_t queue, const std::string& game_mode) {
+    switch (queue) {
+    case ATTRIBUTION_QUEUE_ANY: return true;
+    case ATTRIBUTION_QUEUE_SUMMONERS_RIFT:
+    case ATTRIBUTION_QUEUE_RANKED_SOLO:
+    case ATTRIBUTION_QUEUE_COOP_VS_AI: return game_mode == "CLASSIC";
+    case ATTRIBUTION_QUEUE_ARAM: return game_mode == "ARAM";
+    default: return false;
+    }
+}
+
+// "Shadow Isles", "shadow-isles" and "shadowisles" compare equal
+static std::string normalize_name(const std::string& name) {
+    std::string result;
+    for (char c : name) {
+        if (isalnum(static_cast<unsigned char>(c))) {
+            result.push_back(static_cast<char>(tolower(static_cast<unsigned char>(c))));
+        }
+    }
+
+    return result;
+}
+
+// returns false if the participant lacks the stat
+static bool find_stat(const nlohmann::json& participant, const char* path, double* value) {
+    const nlohmann::json* node = &participant;
+    const char* dot = strchr(path, '.');
+    if (dot) {
+        auto parent_it = participant.find(std::string(path, dot));
+        if (parent_it == participant.end()) {
+            return false;
+        }
+        node = &*parent_it;
+        path = dot + 1;
+    }
+    auto stat_it = node->find(path);
+    if (stat_it == node->end() || !(stat_it->is_number() || stat_it->is_boolean())) {
+        return false;
+    }
+    *value = stat_it->get<double>();
+
+    return true;
+}
+
+static double count_timeline_events(const match_timeline_t& match_timeline, const char* event_type, int participant_id, int64_t before_ms) {
+    int kind = 0;
+    while (kind < _TIMELINE_EVENT_SIZE && strcmp(timeline_event_kind_to_str(static_cast<timeline_event_kind_t>(kind)), event_type)) {
+        ++kind;
+    }
+    if (kind == _TIMELINE_EVENT_SIZE) {
+        return 0.0;
+    }
+
+    double result = 0.0;
+    for (const timeline_event_t& event : match_timeline.events(static_cast<timeline_event_kind_t>(kind))) {
+        if (before_ms && before_ms <= event.timestamp_ms) {
+            // events are in game time order
+            break ;
+        }
+        result += event.kind == kind && event.participant_id == participant_id;
+    }
+
+    return result;
+}
+
+attribution_engine_t::~attribution_engine_t() {
+    close();
+}
+
+int attribution_engine_t::open(const std::string& path, const nlohmann::json& champions_info) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_champion_id_to_faction.clear();
+    for (const nlohmann::json& champion : champions_info) {
+        auto id_it = champion.find("id");
+        auto faction_it = champion.find("faction");
+        if (id_it != champion.end() && id_it->is_number() && faction_it != champion.end() && faction_it->is_string()) {
+            m_champion_id_to_faction[id_it->get<int>()] = normalize_name(faction_it->get<std::string>());
+        }
+    }
+
+    m_puuid_to_account.clear();
+    std::vector<unsigned char> buffer;
+    if (m_log.open(path, ATTRIBUTION_MAGIC, ATTRIBUTION_VERSION, "attribution", &buffer)) {
+        return 1;
+    }
+
+    const unsigned char* cur = buffer.data() + APPEND_LOG_HEADER_SIZE;
+    const unsigned char* end = buffer.data() + buffer.size();
+    auto read_string = [&](std::string* value) {
+        uint32_t size;
+        if (end - cur < 4) {
+            return 1;
+        }
+        memcpy(&size, cur, sizeof(size));
+        if (end - cur - 4 < static_cast<ptrdiff_t>(size)) {
+            return 1;
+        }
+        value->assign(reinterpret_cast<const char*>(cur + 4), size);
+        cur += 4 + size;
+        return 0;
+    };
+    const unsigned char* last_complete_record = cur;
+    while (cur < end) {
+        std::string puuid;
+        match_attribution_t match;
+        uint32_t n;
+        if (read_string(&puuid) || read_string(&match.match_id) || end - cur < 8) {
+            break ;
+        }
+        memcpy(&match.game_creation, cur, sizeof(match.game_creation));
+        cur += 8;
+        if (read_string(&match.champion_name) || end - cur < 4) {
+            break ;
+        }
+        memcpy(&n, cur, sizeof(n));
+        cur += 4;
+        if ((end - cur) / 12 < static_cast<ptrdiff_t>(n)) {
+            break ;
+        }
+        for (uint32_t contribution_index = 0; contribution_index < n; ++contribution_index) {
+            attribution_contribution_t& contribution = match.contributions.emplace_back();
+            int32_t challenge_id;
+            memcpy(&challenge_id, cur, sizeof(challenge_id));
+            memcpy(&contribution.value, cur + 4, sizeof(contribution.value));
+            contribution.challenge_id = challenge_id;
+            cur += 12;
+        }
+        apply(&m_puuid_to_account[puuid], std::move(match));
+        last_complete_record = cur;
+    }
+
+
+    return m_log.truncate_torn_tail(last_complete_record - buffer.data());
+}
+
+void attribution_engine_t::close() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_log.close();
+}
+
+void attribution_engine_t::track(const std::string& puuid) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_tracked_puuids.insert(puuid);
+}
+
+void attribution_engine_t::apply(account_attribution_t* account, match_attribution_t match) {
+    for (const attribution_contribution_t& contribution : match.contributions) {
+        challenge_attribution_t& attribution = account->challenge_id_to_attribution[contribution.challenge_id];
+        attribution.total += contribution.value;
+        attribution.champion_name_to_value[match.champion_name] += contribution.value;
+        const attribution_rule_t* rule = attribution_find_rule(contribution.challenge_id);
+        if (rule && rule->is_distinct_per_champion) {
+            account->challenge_id_to_counted_champions[contribution.challenge_id].insert(match.champion_name);
+        }
+    }
+    account->match_ids.insert(match.match_id);
+    account->matches.push_back(std::move(match));
+}
+
+int attribution_engine_t::write_record(const std::string& puuid, const match_attribution_t& match) {
+    if (!m_log.is_open()) {
+        return 1;
+    }
+
+    std::vector<unsigned char> buffer;
+    auto write_bytes = [&buffer](const void* data, size_t size) {
+        buffer.insert(buffer.end(), static_cast<const unsigned char*>(data), static_cast<const unsigned char*>(data) + size);
+    };
+    auto write_string = [&write_bytes](const std::string& value) {
+        const uint32_t size = static_cast<uint32_t>(value.size());
+        write_bytes(&size, sizeof(size));
+        write_bytes(value.data(), value.size());
+    };
+    write_string(puuid);
+    write_string(match.match_id);
+    write_bytes(&match.game_creation, sizeof(match.game_creation));
+    write_string(match.champion_name);
+    const uint32_t n = static_cast<uint32_t>(match.contributions.size());
+    write_bytes(&n, sizeof(n));
+    for (const attribution_contribution_t& contribution : match.contributions) {
+        const int32_t challenge_id = contribution.challenge_id;
+        write_bytes(&challenge_id, sizeof(challenge_id));
+        write_bytes(&contribution.value, sizeof(contribution.value));
+    }
+
+    if (m_log.append(buffer.data(), buffer.size())) {
+        std::cerr << "CLIENT failed to write attribution of '" << match.match_id << "'" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int attribution_engine_t::add_match(const std::string& match_id, const nlohmann::json& match_info, const match_timeline_t* match_timeline) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    int result = 0;
+    try {
+        const nlohmann::json& info = match_info.at("info");
+        const nlohmann::json& participants = info.at("participants");
+        const int queue_id = info.at("queueId").get<int>();
+        const int64_t game_creation = info.at("gameCreation").get<int64_t>() / 1000;
+
+        for (size_t participant_index = 0; participant_index < participants.size(); ++participant_index) {
+            const nlohmann::json& participant = participants[participant_index];
+            const std::string puuid = participant.at("puuid").get<std::string>();
+            if (!m_tracked_puuids.count(puuid)) {
+                continue ;
+            }
+            account_attribution_t& account = m_puuid_to_account[puuid];
+            if (account.match_ids.count(match_id)) {
+                continue ;
+            }
+
+            match_attribution_t match;
+            match.match_id = match_id;
+            match.game_creation = game_creation;
+            match.champion_name = participant.at("championName").get<std::string>();
+            const bool is_win = participant.at("win").get<bool>();
+            const int team_id = participant.at("teamId").get<int>();
+            const int participant_id = participant.value("participantId", static_cast<int>(participant_index) + 1);
+
+            for (const attribution_rule_t& rule : attribution_rules) {
+                if (!is_queue_matching(rule.queue, queue_id) || (rule.is_win_required && !is_win)) {
+                    continue ;
+                }
+
+                double quantity = 0.0;
+                switch (rule.source) {
+                case ATTRIBUTION_SOURCE_ONE: {
+                    quantity = 1.0;
+                } break ;
+                case ATTRIBUTION_SOURCE_STAT: {
+                    if (!find_stat(participant, rule.field, &quantity)) {
+                        continue ;
+                    }
+                } break ;
+                case ATTRIBUTION_SOURCE_FACTION_TEAM: {
+                    size_t n_of_teammates = 0;
+                    size_t n_of_faction_teammates = 0;
+                    for (const nlohmann::json& teammate : participants) {
+                        if (teammate.at("teamId").get<int>() != team_id) {
+                            continue ;
+                        }
+                        ++n_of_teammates;
+                        auto faction_it = m_champion_id_to_faction.find(teammate.value("championId", 0));
+                        n_of_faction_teammates += faction_it != m_champion_id_to_faction.end() && faction_it->second == rule.field;
+                    }
+                    quantity = n_of_teammates == 5 && n_of_faction_teammates == 5;
+                } break ;
+                case ATTRIBUTION_SOURCE_TIMELINE_EVENTS: {
+                    if (!match_timeline) {
+                        continue ;
+                    }
+                    quantity = count_timeline_events(*match_timeline, rule.field, participant_id, rule.before_ms);
+                } break ;
+                }
+
+                if (quantity < rule.min || rule.max < quantity) {
+                    continue ;
+                }
+                const double value = rule.is_counted ? 1.0 : quantity;
+                if (value == 0.0) {
+                    continue ;
+                }
+                if (rule.is_distinct_per_champion) {
+                    auto counted_it = account.challenge_id_to_counted_champions.find(rule.challenge_id);
+                    if (counted_it != account.challenge_id_to_counted_champions.end() && counted_it->second.count(match.champion_name)) {
+                        continue ;
+                    }
+                }
+                match.contributions.push_back({ .challenge_id = rule.challenge_id, .value = value });
+            }
+
+            write_record(puuid, match);
+            apply(&account, std::move(match));
+            ++result;
+        }
+    } catch (std::exception& e) {
+        std::cerr << "CLIENT failed to attribute match '" << match_id << "': " << e.what() << std::endl;
+        return -1;
+    }
+
+    return result;
+}
+
+void attribution_engine_t::recent_matches(const std::string& puuid, size_t n, std::vector<match_attribution_t>* result) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    result->clear();
+    auto account_it = m_puuid_to_account.find(puuid);
+    if (account_it == m_puuid_to_account.end()) {
+        return ;
+    }
+    *result = account_it->second.matches;
+    std::sort(result->begin(), result->end(), [](const match_attribution_t& a, const match_attribution_t& b) {
+        return a.game_creation > b.game_creation;
+    });
+    if (n < result->size()) {
+        result->resize(n);
+    }
+}
+
+void attribution_engine_t::champion_breakdown(const std::string& puuid, int challenge_id, std::vector<std::pair<std::string, double>>* result) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    result->clear();
+    auto account_it = m_puuid_to_account.find(puuid);
+    if (account_it == m_puuid_to_account.end()) {
+        return ;
+    }
+    auto attribution_it = account_it->second.challenge_id_to_attribution.find(challenge_id);
+    if (attribution_it == account_it->second.challenge_id_to_attribution.end()) {
+        return ;
+    }
+    result->assign(attribution_it->second.champion_name_to_value.begin(), attribution_it->second.champion_name_to_value.end());
+    std::sort(result->begin(), result->end(), [](const std::pair<std::string, double>& a, const std::pair<std::string, double>& b) {
+        return a.second > b.second;
+    });
+}
+
+double attribution_engine_t::total(const std::string& puuid, int challenge_id) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    auto account_it = m_puuid_to_account.find(puuid);
+    if (account_it == m_puuid_to_account.end()) {
+        return 0.0;
+    }
+    auto attribution_it = account_it->second.challenge_id_to_attribution.find(challenge_id);
+    if (attribution_it == account_it->second.challenge_id_to_attribution.end()) {
+        return 0.0;
+    }
+
+    return attribution_it->second.total;
+}
+
+void attribution_engine_t::live_contributions(
+    const std::string& puuid, const std::string& game_mode, const std::string& champion_name,
+    const std::vector<attribution_live_stat_t>& stats, std::vector<attribution_live_contribution_t>* result
+) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    result->clear();
+    auto account_it = m_puuid_to_account.find(puuid);
+    // the live client names champions for display, "Kai'Sa" for the match's "Kaisa"
+    const std::string normalized_champion_name = normalize_name(champion_name);
+    for (const attribution_rule_t& rule : attribution_rules) {
+        if (rule.source != ATTRIBUTION_SOURCE_STAT || !is_game_mode_matching(rule.queue, game_mode)) {
+            continue ;
+        }
+        auto stat_it = std::find_if(stats.begin(), stats.end(), [&rule](const attribution_live_stat_t& stat) {
+            return strcmp(stat.field, rule.field) == 0;
+        });
+        if (stat_it == stats.end() || stat_it->value < rule.min || rule.max < stat_it->value) {
+            continue ;
+        }
+        const double value = rule.is_counted ? 1.0 : stat_it->value;
+        if (value == 0.0) {
+            continue ;
+        }
+        if (rule.is_distinct_per_champion && account_it != m_puuid_to_account.end()) {
+            auto counted_it = account_it->second.challenge_id_to_counted_champions.find(rule.challenge_id);
+            if (counted_it != account_it->second.challenge_id_to_counted_champions.end() && std::any_of(
+                counted_it->second.begin(), counted_it->second.end(), [&normalized_champion_name](const std::string& counted_champion_name) {
+                    return normalize_name(counted_champion_name) == normalized_champion_name;
+                }
+            )) {
+                continue ;
+            }
+        }
+        result->push_back({ .challenge_id = rule.challenge_id, .value = value, .is_win_required = rule.is_win_required });
+    }
+}
@@ -0,0 +1,144 @@
+#ifndef ATTRIBUTION_H
+# define ATTRIBUTION_H
+
+# include <string>
+# include <vector>
+# include <unordered_map>
+# include <unordered_set>
+# include <mutex>
+# include <cstdint>
+
+# include "json.hpp"
+# include "timeline.h"
+# include "append_log.h"
+
+enum attribution_source_t {
+    ATTRIBUTION_SOURCE_ONE,             // every qualifying game counts 1
+    ATTRIBUTION_SOURCE_STAT,            // participant stat, "challenges.<name>" for the nested ones
+    ATTRIBUTION_SOURCE_FACTION_TEAM,    // 1 if every champion on the participant's team is from the faction
+    ATTRIBUTION_SOURCE_TIMELINE_EVENTS, // timeline events of a type credited to the participant, needs the timeline
+};
+
+enum attribution_queue_t {
+    ATTRIBUTION_QUEUE_ANY,
+    ATTRIBUTION_QUEUE_SUMMONERS_RIFT,
+    ATTRIBUTION_QUEUE_RANKED_SOLO,
+    ATTRIBUTION_QUEUE_ARAM,
+    ATTRIBUTION_QUEUE_COOP_VS_AI
+};
+
+/**
+ * How one challenge advances from a game: a quantity taken from the game, kept if it falls in [min, max].
+*/
+struct attribution_rule_t {
+    int                  challenge_id;
+    attribution_source_t source;
+    const char*          field;                    // stat path, faction or timeline event type, e.g. "WARD_KILL"
+    attribution_queue_t  queue;
+    double               min;
+    double               max;
+    bool                 is_counted;               // the game contributes 1 instead of the quantity
+    bool                 is_win_required;
+    bool                 is_distinct_per_champion; // "with different champions", a champion contributes once
+    int64_t              before_ms;                // timeline events at or after this game time are ignored, 0 for the whole game
+};
+
+// 0 if no rule covers the challenge
+const attribution_rule_t* attribution_find_rule(int challenge_id);
+
+struct attribution_contribution_t {
+    int    challenge_id;
+    double value;
+};
+
+// a counter of the game in progress under the name of the match stat it becomes once the game ended, e.g. "kills"
+struct attribution_live_stat_t {
+    const char* field;
+    double      value;
+};
+
+struct attribution_live_contribution_t {
+    int    challenge_id;
+    double value;
+    bool   is_win_required; // the game only counts if it is won
+};
+
+struct match_attribution_t {
+    std::string                             match_id;
+    int64_t                                 game_creation; // unix seconds
+    std::string                             champion_name;
+    std::vector<attribution_contribution_t> contributions;
+};
+
+/**
+ * Maps ingested matches to the challenge progress they earned the tracked accounts, per match and per champion.
+ * Each match is evaluated once when it arrives and folded into running totals, nothing is re-scanned.
+ * Challenges whose match field Riot does not expose (grades, premades, mastery...) have no rule and stay unattributed.
+ *
+ * File layout: "LTCA" magic, u32 version, then one record per attributed match and account:
+ *   u32 puuid size, puuid, u32 match id size, match id, i64 game creation, u32 champion size, champion,
+ *   u32 n, n * (i32 challenge id, f64 value)
+ * Records are replayed on open, contributions are stored after the per champion deduplication.
+ *
+ * Example call:
+ * attribution_engine_t attribution;
+ * attribution.open("attribution.bin", champions_info);
+ * attribution.track(puuid);
+ * attribution.add_match(match_id, match_info, 0);
+ * std::vector<std::pair<std::string, double>> champion_values;
+ * attribution.champion_breakdown(puuid, 303510, &champion_values);
+*/
+struct attribution_engine_t {
+    attribution_engine_t() = default;
+    attribution_engine_t(const attribution_engine_t&) = delete;
+    attribution_engine_t& operator=(const attribution_engine_t&) = delete;
+    ~attribution_engine_t();
+
+    // champions_info: champion summaries with "id" and "faction", for the faction rules
+    int  open(const std::string& path, const nlohmann::json& champions_info);
+    void close();
+
+    // matches added from now on are attributed to the account too
+    void track(const std::string& puuid);
+    // thread safe, match_timeline may be 0 in which case the timeline rules are skipped
+    // returns the number of tracked participants the match was attributed to, -1 if it could not be decoded
+    int  add_match(const std::string& match_id, const nlohmann::json& match_info, const match_timeline_t* match_timeline);
+
+    // most recent first
+    void   recent_matches(const std::string& puuid, size_t n, std::vector<match_attribution_t>* result);
+    // largest first
+    void   champion_breakdown(const std::string& puuid, int challenge_id, std::vector<std::pair<std::string, double>>* result);
+    double total(const std::string& puuid, int challenge_id);
+    /**
+     * What the game in progress adds so far to the challenges whose stat rule reads one of stats, as if it ended now.
+     * game_mode is the live client's, "CLASSIC" or "ARAM", so a summoner's rift rule is assumed to match the game's queue.
+    */
+    void   live_contributions(
+        const std::string& puuid, const std::string& game_mode, const std::string& champion_name,
+        const std::vector<attribution_live_stat_t>& stats, std::vector<attribution_live_contribution_t>* result
+    );
+
+    struct challenge_attribution_t {
+        double                                  total = 0.0;
+        std::unordered_map<std::string, double> champion_name_to_value;
+    };
+    struct account_attribution_t {
+        std::vector<match_attribution_t>                         matches; // in order of arrival
+        std::unordered_set<std::string>                          match_ids;
+        std::unordered_map<int, challenge_attribution_t>         challenge_id_to_attribution;
+        // champions already counted by the distinct per champion rules
+        std::unordered_map<int, std::unordered_set<std::string>> challenge_id_to_counted_champions;
+    };
+
+    // folds one match into the account's totals, m_mutex must be held
+    void apply(account_attribution_t* account, match_attribution_t match);
+    int  write_record(const std::string& puuid, const match_attribution_t& match);
+
+    std::mutex                                             m_mutex;
+    append_log_t                                           m_log;
+    std::unordered_map<int, std::string>                   m_champion_id_to_faction;
+    std::unordered_set<std::string>                        m_tracked_puuids;
+    std::unordered_map<std::string, account_attribution_t> m_puuid_to_account;
+};
+
+#endif // ATTRIBUTION_H
@@ -0,0 +1,250 @@
+#include "challenges.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cassert>
+#include <climits>
+
+static const char* tier_strs[_TIER_SIZE] = {
+    "NONE",
+    "UNRANKED",
+    "IRON",
+    "BRONZE",
+    "SILVER",
+    "GOLD",
+    "PLATINUM",
+    "EMERALD",
+    "DIAMOND",
+    "MASTER",
+    "GRANDMASTER",
+    "CHALLENGER"
+};
+
+static const char* category_strs[_CATEGORY_SIZE] = {
+    "COLLECTION",
+    "EXPERTISE",
+    "IMAGINATION",
+    "TEAMWORK",
+    "VETERANCY"
+};
+
+tier_t str_to_tier(const std::string& tier) {
+    for (int i = 0; i < _TIER_SIZE; ++i) {
+        if (tier == tier_strs[i]) {
+            return static_cast<tier_t>(i);
+        }
+    }
+
+    assert(0);
+    return TIER_NONE;
+}
+
+const char* tier_to_str(tier_t tier) {
+    assert(tier < _TIER_SIZE);
+    return tier_strs[tier];
+}
+
+tier_t tier_to_next_tier(tier_t tier) {
+    if (tier == TIER_CHALLENGER) {
+        return TIER_CHALLENGER;
+    }
+
+    return static_cast<tier_t>(tier + 1);
+}
+
+const char* category_to_str(category_t category) {
+    assert(category < _CATEGORY_SIZE);
+    return category_strs[category];
+}
+
+int find_parent_id(int id) {
+    if (id <= 0) {
+        return -1;
+    }
+
+    int divisor = 100;
+    while (id % divisor == 0) {
+        divisor *= 10;
+    }
+
+    int result = id / divisor * divisor;
+
+    if (result % 100000 == 0) {
+        return result / 100000;
+    }
+    return result;
+}
+
+double challenge_next_value(const challenge_t& challenge, double value) {
+    // the first threshold strictly above value, value itself once it is past the top
+    const std::vector<double>& values = challenge.thresholds;
+    auto next_it = std::upper_bound(values.begin(), values.end(), value);
+    if (next_it == values.end()) {
+        return value;
+    }
+
+    return *next_it;
+}
+
+int challenge_catalog_t::build(const nlohmann::json& global_challenges, const nlohmann::json& challenges_local) {
+    m_challenges.clear();
+    m_id_to_slot.clear();
+    m_root = 0;
+
+    std::unordered_map<int, const nlohmann::json*> id_to_challenge_local;
+    for (const auto& challenge : challenges_local) {
+        id_to_challenge_local.insert({ challenge["id"].get<int>(), &challenge });
+    }
+
+    // +1 for legacy, pointers into m_challenges must stay valid from here on
+    m_challenges.reserve(global_challenges.size() + 1);
+
+    const auto find_challenge_icon_paths = [&id_to_challenge_local](challenge_t* incomplete_challenge) {
+        auto challenge_it = id_to_challenge_local.find(incomplete_challenge->id);
+        if (challenge_it == id_to_challenge_local.end()) {
+            return ;
+        }
+        const auto& icon_paths = (*challenge_it->second)["levelToIconPath"];
+        for (const auto& icon_path : icon_paths.items()) {
+            incomplete_challenge->icon_paths[str_to_tier(icon_path.key())] = "assets" + icon_path.value().get<std::string>();
+        }
+    };
+
+    challenge_t& legacy = m_challenges.emplace_back();
+    legacy.id = CHALLENGE_LEGACY_ID;
+    legacy.slot = 0;
+    legacy.leaderboard = false;
+    legacy.short_description = "Legacy";
+    legacy.description = "Legacy";
+    legacy.name = "Legacy";
+    legacy.state = "DISABLED";
+    legacy.parent = 0;
+    find_challenge_icon_paths(&legacy);
+
+    for (const nlohmann::json& global_challenge : global_challenges) {
+        const int id = global_challenge["id"];
+        if (id == CHALLENGE_LEGACY_ID) {
+            continue ;
+        }
+
+        challenge_t& challenge = m_challenges.emplace_back();
+        challenge.id = id;
+        challenge.slot = static_cast<uint32_t>(m_challenges.size() - 1);
+        challenge.parent = 0;
+        challenge.leaderboard = global_challenge["leaderboard"];
+        challenge.short_description = global_challenge["localizedNames"]["en_US"]["shortDescription"];
+        challenge.description = global_challenge["localizedNames"]["en_US"]["description"];
+        challenge.name = global_challenge["localizedNames"]["en_US"]["name"];
+        challenge.state = global_challenge["state"];
+        for (const auto& j : global_challenge["thresholds"].items()) {
+            challenge.thresholds.push_back(j.value());
+        }
+        assert(!challenge.thresholds.empty());
+        std::sort(challenge.thresholds.begin(), challenge.thresholds.end());
+        find_challenge_icon_paths(&challenge);
+
+        if (challenge.id == 0) {
+            m_root = &challenge;
+        }
+    }
+
+    if (!m_root) {
+        std::cerr << "CLIENT challenge catalog has no root challenge" << std::endl;
+        return 1;
+    }
+
+    for (challenge_t& challenge : m_challenges) {
+        m_id_to_slot.insert({ challenge.id, challenge.slot });
+    }
+
+    for (challenge_t& node : m_challenges) {
+        if (&node == m_root) {
+            continue ;
+        }
+        uint32_t parent_slot = id_to_slot(find_parent_id(node.id));
+        challenge_t* parent = parent_slot == UINT32_MAX ? &legacy : &m_challenges[parent_slot];
+        node.parent = parent;
+        parent->children.push_back(&node);
+    }
+
+    for (challenge_t& node : m_challenges) {
+        node.category = -1;
+        challenge_t* category_node = &node;
+        while (category_node->parent && category_node->parent != m_root) {
+            category_node = category_node->parent;
+        }
+        for (int category = 0; category < _CATEGORY_SIZE; ++category) {
+            if (category_node->name == category_to_str(static_cast<category_t>(category))) {
+                node.category = static_cast<int8_t>(category);
+            }
+        }
+    }
+
+    return 0;
+}
+
+uint32_t challenge_catalog_t::id_to_slot(int id) const {
+    auto it = m_id_to_slot.find(id);
+    if (it == m_id_to_slot.end()) {
+        return UINT32_MAX;
+    }
+
+    return it->second;
+}
+
+template <typename number_t>
+static number_t number_or_zero(const nlohmann::json& j, const char* key) {
+    auto it = j.find(key);
+    if (it == j.end() || !it->is_number()) {
+        return 0;
+    }
+
+    return it->get<number_t>();
+}
+
+static void load_category_points(category_points_t* category_points, const nlohmann::json& j) {
+    category_points->current    = number_or_zero<int32_t>(j, "current");
+    category_points->max        = number_or_zero<int32_t>(j, "max");
+    category_points->percentile = number_or_zero<float>(j, "percentile");
+    category_points->level      = str_to_tier(j.value("level", "NONE"));
+}
+
+int account_t::load(const challenge_catalog_t& catalog, const nlohmann::json& account_challenges) {
+    if (!catalog.m_root) {
+        return 1;
+    }
+
+    m_progress.assign(catalog.m_challenges.size(), challenge_progress_t{
+        .value         = 0,
+        .achieved_time = 0,
+        .percentile    = 0,
+        .tier          = TIER_UNRANKED
+    });
+    m_progress[catalog.id_to_slot(CHALLENGE_LEGACY_ID)].tier = TIER_NONE;
+
+    try {
+        for (const nlohmann::json& account_challenge : account_challenges.at("challenges")) {
+            uint32_t slot = catalog.id_to_slot(account_challenge.at("challengeId"));
+            if (slot == UINT32_MAX) {
+                continue ;
+            }
+
+            challenge_progress_t& progress = m_progress[slot];
+            progress.tier          = str_to_tier(account_challenge.at("level"));
+            progress.percentile    = number_or_zero<float>(account_challenge, "percentile");
+            progress.value         = number_or_zero<double>(account_challenge, "value");
+            progress.achieved_time = number_or_zero<int64_t>(account_challenge, "achievedTime");
+        }
+
+        const nlohmann::json& category_points = account_challenges.at("categoryPoints");
+        for (int category = 0; category < _CATEGORY_SIZE; ++category) {
+            load_category_points(&m_category_points[category], category_points.at(category_to_str(static_cast<category_t>(category))));
+        }
+        load_category_points(&m_total_points, account_challenges.at("totalPoints"));
+    } catch (std::exception& e) {
+        std::cerr << "CLIENT failed to load account challenges: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
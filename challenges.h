@@ -0,0 +1,119 @@
+#ifndef CHALLENGES_H
+# define CHALLENGES_H
+
+# include <string>
+# include <vector>
+# include <array>
+# include <unordered_map>
+# include <cstdint>
+
+# include "json.hpp"
+
+# define CHALLENGE_LEGACY_ID 6
+
+enum tier_t : uint8_t {
+    TIER_NONE,
+    TIER_UNRANKED,
+    TIER_IRON,
+    TIER_BRONZE,
+    TIER_SILVER,
+    TIER_GOLD,
+    TIER_PLATINUM,
+    TIER_EMERALD,
+    TIER_DIAMOND,
+    TIER_MASTER,
+    TIER_GRANDMASTER,
+    TIER_CHALLENGER,
+
+    _TIER_SIZE
+};
+tier_t      str_to_tier(const std::string& tier);
+const char* tier_to_str(tier_t tier);
+tier_t      tier_to_next_tier(tier_t tier);
+
+enum category_t {
+    CATEGORY_COLLECTION,
+    CATEGORY_EXPERTISE,
+    CATEGORY_IMAGINATION,
+    CATEGORY_TEAMWORK,
+    CATEGORY_VETERANCY,
+
+    _CATEGORY_SIZE
+};
+const char* category_to_str(category_t category);
+
+/**
+ * Catalog entry, identical for every account and immutable once the catalog is built.
+ * Anything account specific lives in challenge_progress_t, indexed by 'slot'.
+ */
+struct challenge_t {
+    int                                 id;
+    uint32_t                            slot;
+    int8_t                              category; // category_t, -1 for the challenges outside of the 5 categories
+    bool                                leaderboard;
+    std::string                         short_description;
+    std::string                         description;
+    std::string                         name;
+    std::string                         state;
+    std::string                         title; // todo: add this
+    std::vector<double>                 thresholds; // sorted ascending
+    std::array<std::string, _TIER_SIZE> icon_paths;
+    std::vector<challenge_t*>           children;
+    challenge_t*                        parent;
+
+    /*
+        303510 -> champions where "faction": "shurima"
+        dependencies
+    */
+};
+
+struct challenge_catalog_t {
+    challenge_catalog_t() = default;
+    challenge_catalog_t(const challenge_catalog_t&) = delete;
+    challenge_catalog_t& operator=(const challenge_catalog_t&) = delete;
+
+    /**
+     * global_challenges: riot's challenge config, challenges_local: communitydragon's challenges.json for the icon paths
+    */
+    int build(const nlohmann::json& global_challenges, const nlohmann::json& challenges_local);
+
+    // returns UINT32_MAX if the id is not part of the catalog
+    uint32_t id_to_slot(int id) const;
+
+    std::vector<challenge_t>          m_challenges; // indexed by slot, never reallocated after build
+    std::unordered_map<int, uint32_t> m_id_to_slot;
+    challenge_t*                      m_root;
+};
+
+struct challenge_progress_t {
+    double  value;
+    int64_t achieved_time;
+    float   percentile;
+    tier_t  tier;
+};
+
+struct category_points_t {
+    int32_t current;
+    int32_t max;
+    float   percentile;
+    tier_t  level;
+};
+
+/**
+ * Per-account overlay over the shared catalog, roughly 24 bytes per challenge.
+*/
+struct account_t {
+    int load(const challenge_catalog_t& catalog, const nlohmann::json& account_challenges);
+
+    std::string                       m_game_name;
+    std::string                       m_tag_line;
+    std::string                       m_puuid;
+    std::vector<challenge_progress_t> m_progress; // indexed by catalog slot
+    category_points_t                 m_category_points[_CATEGORY_SIZE];
+    category_points_t                 m_total_points;
+};
+
+double challenge_next_value(const challenge_t& challenge, double value);
+int    find_parent_id(int id);
+
+#endif // CHALLENGES_H
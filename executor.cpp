@@ -0,0 +1,91 @@
+#include "executor.h"
+
+#include <iostream>
+
+void task_group_t::add(size_t n_of_tasks) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_n_of_pending += n_of_tasks;
+}
+
+void task_group_t::done() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (--m_n_of_pending == 0) {
+        m_cv.notify_all();
+    }
+}
+
+void task_group_t::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() {
+        return m_n_of_pending == 0;
+    });
+}
+
+executor_t::~executor_t() {
+    destroy();
+}
+
+void executor_t::init(size_t n_of_workers) {
+    m_should_stop = false;
+    if (n_of_workers == 0) {
+        n_of_workers = 1;
+    }
+
+    m_workers.reserve(n_of_workers);
+    for (size_t worker_index = 0; worker_index < n_of_workers; ++worker_index) {
+        m_workers.emplace_back([this]() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (true) {
+                m_cv.wait(lock, [this]() {
+                    return m_should_stop || !m_tasks.empty();
+                });
+                if (m_tasks.empty()) {
+                    // only reachable when stopping
+                    break ;
+                }
+
+                task_t task = std::move(m_tasks.front());
+                m_tasks.pop_front();
+                lock.unlock();
+
+                try {
+                    task.run();
+                } catch (std::exception& e) {
+                    std::cerr << "CLIENT task failed: " << e.what() << std::endl;
+                }
+                if (task.group) {
+                    task.group->done();
+                }
+
+                lock.lock();
+            }
+        });
+    }
+}
+
+void executor_t::destroy() {
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_should_stop = true;
+    }
+    m_cv.notify_all();
+
+    for (std::thread& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    m_workers.clear();
+}
+
+void executor_t::submit(std::function<void()> task, task_group_t* group) {
+    if (group) {
+        group->add();
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_tasks.push_back({ .run = std::move(task), .group = group });
+    }
+    m_cv.notify_one();
+}
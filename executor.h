@@ -0,0 +1,58 @@
+#ifndef EXECUTOR_H
+# define EXECUTOR_H
+
+# include <functional>
+# include <deque>
+# include <vector>
+# include <mutex>
+# include <condition_variable>
+# include <thread>
+
+/**
+ * Join counter, every task submitted with the group is waited on by wait(),
+ * including tasks submitted from inside other tasks of the same group before those complete.
+*/
+struct task_group_t {
+    task_group_t() = default;
+    task_group_t(const task_group_t&) = delete;
+    task_group_t& operator=(const task_group_t&) = delete;
+
+    void add(size_t n_of_tasks = 1);
+    void done();
+    // must not be called from a task running on the executor, the task would hold the worker it waits on
+    void wait();
+
+    std::mutex              m_mutex;
+    std::condition_variable m_cv;
+    size_t                  m_n_of_pending = 0;
+};
+
+/**
+ * Fixed number of worker threads over a FIFO queue, the number of workers is the concurrency limit.
+ * Submitting never spawns a thread, tasks wait in the queue until a worker is free.
+*/
+struct executor_t {
+    executor_t() = default;
+    executor_t(const executor_t&) = delete;
+    executor_t& operator=(const executor_t&) = delete;
+    ~executor_t();
+
+    void init(size_t n_of_workers);
+    // runs every task still queued, then joins the workers
+    void destroy();
+
+    void submit(std::function<void()> task, task_group_t* group = 0);
+
+    struct task_t {
+        std::function<void()> run;
+        task_group_t*         group;
+    };
+
+    std::mutex               m_mutex;
+    std::condition_variable  m_cv;
+    std::deque<task_t>       m_tasks;
+    bool                     m_should_stop = false;
+    std::vector<std::thread> m_workers;
+};
+
+#endif // EXECUTOR_H
@@ -0,0 +1,78 @@
+#include "forecast.h"
+
+#include <cmath>
+#include <climits>
+
+void forecast_update(forecast_t* forecast, int64_t timestamp, double value, double time_constant) {
+    if (forecast->last_timestamp == 0) {
+        forecast->last_timestamp = timestamp;
+        forecast->last_value = value;
+        return ;
+    }
+
+    const int64_t dt = timestamp - forecast->last_timestamp;
+    if (dt <= 0) {
+        forecast->last_value = value;
+        return ;
+    }
+
+    const double instant_rate = (value - forecast->last_value) / static_cast<double>(dt);
+    const double alpha = 1.0 - std::exp(-static_cast<double>(dt) / time_constant);
+    forecast->rate = (1.0 - alpha) * forecast->rate + alpha * instant_rate;
+    forecast->rate_weight = (1.0 - alpha) * forecast->rate_weight + alpha;
+    forecast->last_timestamp = timestamp;
+    forecast->last_value = value;
+}
+
+double forecast_rate(const forecast_t& forecast) {
+    if (forecast.rate_weight <= 0.0) {
+        return 0.0;
+    }
+
+    return forecast.rate / forecast.rate_weight;
+}
+
+int64_t forecast_eta(const forecast_t& forecast, double target_value) {
+    const double rate = forecast_rate(forecast);
+    if (rate <= 0.0 || target_value <= forecast.last_value) {
+        return 0;
+    }
+
+    const double seconds_left = (target_value - forecast.last_value) / rate;
+    if (static_cast<double>(INT64_MAX - forecast.last_timestamp) <= seconds_left) {
+        return 0;
+    }
+
+    return forecast.last_timestamp + static_cast<int64_t>(seconds_left);
+}
+
+void forecaster_t::update(history_store_t* history, const challenge_catalog_t& catalog, const account_t& account, int64_t timestamp) {
+    auto forecasts_it = m_puuid_to_forecasts.find(account.m_puuid);
+    if (forecasts_it == m_puuid_to_forecasts.end() || forecasts_it->second.size() != catalog.m_challenges.size()) {
+        std::vector<forecast_t> forecasts(catalog.m_challenges.size(), forecast_t{});
+        if (history) {
+            std::vector<history_point_t> points;
+            for (const challenge_t& challenge : catalog.m_challenges) {
+                history->range(account.m_puuid, challenge.id, INT64_MIN, timestamp, &points);
+                for (const history_point_t& point : points) {
+                    forecast_update(&forecasts[challenge.slot], point.timestamp, point.value, m_time_constant);
+                }
+            }
+        }
+        forecasts_it = m_puuid_to_forecasts.insert_or_assign(account.m_puuid, std::move(forecasts)).first;
+    }
+
+    std::vector<forecast_t>& forecasts = forecasts_it->second;
+    for (size_t slot = 0; slot < forecasts.size(); ++slot) {
+        forecast_update(&forecasts[slot], timestamp, account.m_progress[slot].value, m_time_constant);
+    }
+}
+
+const forecast_t* forecaster_t::find(const std::string& puuid, uint32_t slot) const {
+    auto forecasts_it = m_puuid_to_forecasts.find(puuid);
+    if (forecasts_it == m_puuid_to_forecasts.end() || forecasts_it->second.size() <= slot) {
+        return 0;
+    }
+
+    return &forecasts_it->second[slot];
+}
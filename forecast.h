@@ -0,0 +1,43 @@
+#ifndef FORECAST_H
+# define FORECAST_H
+
+# include "challenges.h"
+# include "history.h"
+
+# include <string>
+# include <vector>
+# include <unordered_map>
+# include <cstdint>
+
+/**
+ * Exponentially weighted average of the rate of gain, weighted by elapsed time rather than by the number of polls,
+ * so frequent polls without progress pull the rate down only as much as the time they cover.
+*/
+struct forecast_t {
+    int64_t last_timestamp; // 0 before the first point
+    double  last_value;
+    double  rate;           // value per second, divide by rate_weight for the bias corrected rate
+    double  rate_weight;
+};
+
+void    forecast_update(forecast_t* forecast, int64_t timestamp, double value, double time_constant);
+// bias corrected rate, value per second
+double  forecast_rate(const forecast_t& forecast);
+// estimated unix time for reaching target_value, 0 if there is no estimate
+int64_t forecast_eta(const forecast_t& forecast, double target_value);
+
+struct forecaster_t {
+    /**
+     * O(1) per challenge, except for the first update of an account which replays its history
+     * history: may be 0, only used to seed accounts seen for the first time
+    */
+    void update(history_store_t* history, const challenge_catalog_t& catalog, const account_t& account, int64_t timestamp);
+
+    // 0 if the account is unknown
+    const forecast_t* find(const std::string& puuid, uint32_t slot) const;
+
+    double m_time_constant = 7.0 * 24.0 * 60.0 * 60.0;
+    std::unordered_map<std::string, std::vector<forecast_t>> m_puuid_to_forecasts; // indexed by catalog slot
+};
+
+#endif // FORECAST_H
@@ -0,0 +1,459 @@
+#include "heatmap.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <thread>
+
+#define HEATMAP_MAGIC "LTHM"
+#define HEATMAP_VERSION 1
+
+static const char* const layer_names[_HEATMAP_LAYER_SIZE] = { "kills", "deaths", "wards" };
+static const char* const role_names[_HEATMAP_ROLE_SIZE] = { "TOP", "JUNGLE", "MIDDLE", "BOTTOM", "UTILITY", "UNKNOWN" };
+
+const char* heatmap_layer_to_str(heatmap_layer_t layer) {
+    return layer < _HEATMAP_LAYER_SIZE ? layer_names[layer] : "unknown";
+}
+
+const char* heatmap_role_to_str(heatmap_role_t role) {
+    return role < _HEATMAP_ROLE_SIZE ? role_names[role] : "UNKNOWN";
+}
+
+heatmap_role_t heatmap_role_from_str(const std::string& team_position) {
+    for (int role = 0; role < HEATMAP_ROLE_UNKNOWN; ++role) {
+        if (team_position == role_names[role]) {
+            return static_cast<heatmap_role_t>(role);
+        }
+    }
+
+    return HEATMAP_ROLE_UNKNOWN;
+}
+
+void heatmap_grid_t::resize(int width, int height) {
+    this->width = width;
+    this->height = height;
+    cells.assign(static_cast<size_t>(width) * height, 0.0f);
+    n_of_points = 0;
+}
+
+void heatmap_blur(heatmap_grid_t* grid, float sigma) {
+    if (sigma <= 0.0f || grid->cells.empty()) {
+        return ;
+    }
+
+    const int radius = static_cast<int>(ceilf(sigma * 3.0f));
+    std::vector<float> kernel(2 * radius + 1);
+    float kernel_sum = 0.0f;
+    for (int offset = -radius; offset <= radius; ++offset) {
+        kernel[offset + radius] = expf(-static_cast<float>(offset * offset) / (2.0f * sigma * sigma));
+        kernel_sum += kernel[offset + radius];
+    }
+    for (float& weight : kernel) {
+        weight /= kernel_sum;
+    }
+
+    // rows into scratch, then columns back into the grid, cells past the border count as 0
+    const int width = grid->width;
+    const int height = grid->height;
+    std::vector<float> scratch(grid->cells.size(), 0.0f);
+    for (int y = 0; y < height; ++y) {
+        const float* row = grid->cells.data() + static_cast<size_t>(y) * width;
+        float* scratch_row = scratch.data() + static_cast<size_t>(y) * width;
+        for (int x = 0; x < width; ++x) {
+            const int from = std::max(-radius, -x);
+            const int to = std::min(radius, width - 1 - x);
+            float sum = 0.0f;
+            for (int offset = from; offset <= to; ++offset) {
+                sum += row[x + offset] * kernel[offset + radius];
+            }
+            scratch_row[x] = sum;
+        }
+    }
+    for (int y = 0; y < height; ++y) {
+        const int from = std::max(-radius, -y);
+        const int to = std::min(radius, height - 1 - y);
+        float* row = grid->cells.data() + static_cast<size_t>(y) * width;
+        std::fill(row, row + width, 0.0f);
+        for (int offset = from; offset <= to; ++offset) {
+            const float weight = kernel[offset + radius];
+            const float* scratch_row = scratch.data() + static_cast<size_t>(y + offset) * width;
+            for (int x = 0; x < width; ++x) {
+                row[x] += scratch_row[x] * weight;
+            }
+        }
+    }
+}
+
+void heatmap_normalize(heatmap_grid_t* grid) {
+    if (grid->cells.empty()) {
+        return ;
+    }
+
+    const float max = *std::max_element(grid->cells.begin(), grid->cells.end());
+    if (max <= 0.0f) {
+        return ;
+    }
+    const float scale = 1.0f / max;
+    for (float& cell : grid->cells) {
+        cell *= scale;
+    }
+}
+
+// blue -> green -> yellow -> red, fading in from transparent
+static Color heat_to_color(float heat) {
+    if (heat <= 0.0f) {
+        return Color{ 0, 0, 0, 0 };
+    }
+    heat = std::min(heat, 1.0f);
+
+    static const Color stops[] = { { 0, 0, 255, 255 }, { 0, 255, 0, 255 }, { 255, 255, 0, 255 }, { 255, 0, 0, 255 } };
+    const int n_of_stops = sizeof(stops) / sizeof(stops[0]);
+    const float position = heat * (n_of_stops - 1);
+    const int stop = std::min(static_cast<int>(position), n_of_stops - 2);
+    const float t = position - stop;
+    const Color& from = stops[stop];
+    const Color& to = stops[stop + 1];
+    return Color{
+        static_cast<unsigned char>(from.r + (to.r - from.r) * t),
+        static_cast<unsigned char>(from.g + (to.g - from.g) * t),
+        static_cast<unsigned char>(from.b + (to.b - from.b) * t),
+        static_cast<unsigned char>(255.0f * std::min(1.0f, heat * 4.0f))
+    };
+}
+
+void heatmap_upload_texture(const heatmap_grid_t& grid, Texture2D* texture) {
+    if (grid.cells.empty()) {
+        return ;
+    }
+
+    // image rows go top to bottom, grid rows bottom to top
+    std::vector<Color> pixels(grid.cells.size());
+    for (int y = 0; y < grid.height; ++y) {
+        const float* row = grid.cells.data() + static_cast<size_t>(y) * grid.width;
+        Color* pixel_row = pixels.data() + static_cast<size_t>(grid.height - 1 - y) * grid.width;
+        for (int x = 0; x < grid.width; ++x) {
+            pixel_row[x] = heat_to_color(row[x]);
+        }
+    }
+
+    if (texture->id != 0 && texture->width == grid.width && texture->height == grid.height) {
+        UpdateTexture(*texture, pixels.data());
+        return ;
+    }
+    if (texture->id != 0) {
+        UnloadTexture(*texture);
+    }
+    Image image = {
+        .data = pixels.data(),
+        .width = grid.width,
+        .height = grid.height,
+        .mipmaps = 1,
+        .format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8
+    };
+    *texture = LoadTextureFromImage(image);
+    SetTextureFilter(*texture, TEXTURE_FILTER_BILINEAR);
+}
+
+heatmap_engine_t::~heatmap_engine_t() {
+    close();
+}
+
+int heatmap_engine_t::open(const std::string& path, size_t n_of_workers) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_n_of_workers = n_of_workers ? n_of_workers : std::max(1u, std::thread::hardware_concurrency());
+    m_executor.init(m_n_of_workers);
+
+    m_points.clear();
+    m_puuids.clear();
+    m_puuid_to_code.clear();
+    m_match_ids.clear();
+    std::vector<unsigned char> buffer;
+    if (m_log.open(path, HEATMAP_MAGIC, HEATMAP_VERSION, "heatmap", &buffer)) {
+        return 1;
+    }
+
+    const unsigned char* cur = buffer.data() + APPEND_LOG_HEADER_SIZE;
+    const unsigned char* end = buffer.data() + buffer.size();
+    auto read_u32 = [&](uint32_t* value) {
+        if (end - cur < 4) {
+            return 1;
+        }
+        memcpy(value, cur, sizeof(*value));
+        cur += 4;
+        return 0;
+    };
+    auto read_string = [&](std::string* value) {
+        uint32_t size;
+        if (read_u32(&size) || end - cur < static_cast<ptrdiff_t>(size)) {
+            return 1;
+        }
+        value->assign(reinterpret_cast<const char*>(cur), size);
+        cur += size;
+        return 0;
+    };
+    const unsigned char* last_complete_record = cur;
+    std::vector<participant_t> participants;
+    std::vector<raw_point_t> raw_points;
+    while (cur < end) {
+        std::string match_id;
+        uint32_t n_of_participants;
+        if (read_string(&match_id) || read_u32(&n_of_participants)) {
+            break ;
+        }
+        participants.clear();
+        bool is_complete = true;
+        for (uint32_t participant_index = 0; participant_index < n_of_participants && is_complete; ++participant_index) {
+            std::string puuid;
+            participant_t& participant = participants.emplace_back();
+            if (read_string(&puuid) || end - cur < 3) {
+                is_complete = false;
+                break ;
+            }
+            participant.puuid_code = puuid_code(puuid);
+            memcpy(&participant.champion_id, cur, sizeof(participant.champion_id));
+            participant.role = static_cast<heatmap_role_t>(std::min<int>(cur[2], HEATMAP_ROLE_UNKNOWN));
+            cur += 3;
+        }
+        uint32_t n_of_points;
+        if (!is_complete || read_u32(&n_of_points) || (end - cur) / 6 < static_cast<ptrdiff_t>(n_of_points)) {
+            break ;
+        }
+        raw_points.resize(n_of_points);
+        for (raw_point_t& raw_point : raw_points) {
+            memcpy(&raw_point.x, cur, sizeof(raw_point.x));
+            memcpy(&raw_point.y, cur + 2, sizeof(raw_point.y));
+            raw_point.layer = static_cast<heatmap_layer_t>(cur[4]);
+            raw_point.participant_index = cur[5];
+            cur += 6;
+        }
+        apply(participants, raw_points);
+        m_match_ids.insert(match_id);
+        last_complete_record = cur;
+    }
+
+    if (m_log.truncate_torn_tail(last_complete_record - buffer.data())) {
+        return 1;
+    }
+    ++m_version;
+
+    return 0;
+}
+
+void heatmap_engine_t::close() {
+    m_executor.destroy();
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_log.close();
+}
+
+uint32_t heatmap_engine_t::puuid_code(const std::string& puuid) {
+    auto code_it = m_puuid_to_code.find(puuid);
+    if (code_it != m_puuid_to_code.end()) {
+        return code_it->second;
+    }
+
+    const uint32_t code = static_cast<uint32_t>(m_puuids.size());
+    m_puuids.push_back(puuid);
+    m_puuid_to_code.emplace(puuid, code);
+    return code;
+}
+
+void heatmap_engine_t::apply(const std::vector<participant_t>& participants, const std::vector<raw_point_t>& raw_points) {
+    for (const raw_point_t& raw_point : raw_points) {
+        if (participants.size() <= raw_point.participant_index || _HEATMAP_LAYER_SIZE <= raw_point.layer) {
+            continue ;
+        }
+        const participant_t& participant = participants[raw_point.participant_index];
+        m_points.push_back({
+            .x = raw_point.x,
+            .y = raw_point.y,
+            .layer = raw_point.layer,
+            .role = participant.role,
+            .champion_id = participant.champion_id,
+            .puuid_code = participant.puuid_code
+        });
+    }
+}
+
+int heatmap_engine_t::write_record(const std::string& match_id, const std::vector<participant_t>& participants, const std::vector<raw_point_t>& raw_points) {
+    if (!m_log.is_open()) {
+        return 1;
+    }
+
+    std::vector<unsigned char> buffer;
+    auto write_bytes = [&buffer](const void* data, size_t size) {
+        buffer.insert(buffer.end(), static_cast<const unsigned char*>(data), static_cast<const unsigned char*>(data) + size);
+    };
+    auto write_string = [&write_bytes](const std::string& value) {
+        const uint32_t size = static_cast<uint32_t>(value.size());
+        write_bytes(&size, sizeof(size));
+        write_bytes(value.data(), value.size());
+    };
+    write_string(match_id);
+    const uint32_t n_of_participants = static_cast<uint32_t>(participants.size());
+    write_bytes(&n_of_participants, sizeof(n_of_participants));
+    for (const participant_t& participant : participants) {
+        const uint8_t role = participant.role;
+        write_string(m_puuids[participant.puuid_code]);
+        write_bytes(&participant.champion_id, sizeof(participant.champion_id));
+        write_bytes(&role, sizeof(role));
+    }
+    const uint32_t n_of_points = static_cast<uint32_t>(raw_points.size());
+    write_bytes(&n_of_points, sizeof(n_of_points));
+    for (const raw_point_t& raw_point : raw_points) {
+        const uint8_t layer = raw_point.layer;
+        write_bytes(&raw_point.x, sizeof(raw_point.x));
+        write_bytes(&raw_point.y, sizeof(raw_point.y));
+        write_bytes(&layer, sizeof(layer));
+        write_bytes(&raw_point.participant_index, sizeof(raw_point.participant_index));
+    }
+
+    if (m_log.append(buffer.data(), buffer.size())) {
+        std::cerr << "CLIENT failed to write heatmap of '" << match_id << "'" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int heatmap_engine_t::add_match(const std::string& match_id, const nlohmann::json& match_info, const match_timeline_t& match_timeline) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    if (m_match_ids.count(match_id)) {
+        return 0;
+    }
+
+    std::vector<participant_t> participants;
+    // timeline participant id - 1 -> index into participants
+    uint8_t participant_id_to_index[16];
+    memset(participant_id_to_index, 0xff, sizeof(participant_id_to_index));
+    try {
+        const nlohmann::json& match_participants = match_info.at("info").at("participants");
+        for (size_t participant_index = 0; participant_index < match_participants.size() && participant_index < 16; ++participant_index) {
+            const nlohmann::json& match_participant = match_participants[participant_index];
+            const int participant_id = match_participant.value("participantId", static_cast<int>(participant_index) + 1);
+            if (participant_id < 1 || 16 < participant_id) {
+                continue ;
+            }
+            participant_id_to_index[participant_id - 1] = static_cast<uint8_t>(participants.size());
+            participants.push_back({
+                .puuid_code = puuid_code(match_participant.at("puuid").get<std::string>()),
+                .champion_id = static_cast<uint16_t>(match_participant.value("championId", 0)),
+                .role = heatmap_role_from_str(match_participant.value("teamPosition", std::string()))
+            });
+        }
+    } catch (std::exception& e) {
+        std::cerr << "CLIENT failed to read participants of '" << match_id << "' for the heatmap: " << e.what() << std::endl;
+        return -1;
+    }
+
+    std::vector<raw_point_t> raw_points;
+    auto add_point = [&](const timeline_event_t& event, int participant_id, heatmap_layer_t layer) {
+        // wards placed before the first participant frame have no position
+        if (participant_id < 1 || 16 < participant_id || participant_id_to_index[participant_id - 1] == 0xff || (event.position.x == 0 && event.position.y == 0)) {
+            return ;
+        }
+        raw_points.push_back({ .x = event.position.x, .y = event.position.y, .layer = layer, .participant_index = participant_id_to_index[participant_id - 1] });
+    };
+    for (const timeline_event_t& kill : match_timeline.kills) {
+        add_point(kill, kill.participant_id, HEATMAP_LAYER_KILLS);
+        add_point(kill, kill.victim_id, HEATMAP_LAYER_DEATHS);
+    }
+    for (const timeline_event_t& ward : match_timeline.wards) {
+        if (ward.kind == TIMELINE_EVENT_WARD_PLACED) {
+            add_point(ward, ward.participant_id, HEATMAP_LAYER_WARDS);
+        }
+    }
+
+    write_record(match_id, participants, raw_points);
+    apply(participants, raw_points);
+    m_match_ids.insert(match_id);
+    ++m_version;
+
+    return static_cast<int>(raw_points.size());
+}
+
+void heatmap_engine_t::accumulate(const heatmap_filter_t& filter, int resolution, heatmap_grid_t* result) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    result->resize(resolution, resolution);
+    uint32_t puuid_code = UINT32_MAX;
+    if (!filter.puuid.empty()) {
+        auto code_it = m_puuid_to_code.find(filter.puuid);
+        if (code_it == m_puuid_to_code.end()) {
+            return ;
+        }
+        puuid_code = code_it->second;
+    }
+
+    // one grid per task, no synchronization while binning
+    const size_t n_of_tasks = std::max<size_t>(1, std::min(m_n_of_workers, m_points.size() / 65536 + 1));
+    const size_t n_of_cells = static_cast<size_t>(resolution) * resolution;
+    std::vector<std::vector<uint32_t>> task_counts(n_of_tasks);
+    std::vector<uint64_t> task_n_of_points(n_of_tasks, 0);
+    auto bin = [&](size_t task) {
+        std::vector<uint32_t>& counts = task_counts[task];
+        counts.assign(n_of_cells, 0);
+        const size_t from = m_points.size() * task / n_of_tasks;
+        const size_t to = m_points.size() * (task + 1) / n_of_tasks;
+        uint64_t n_of_points = 0;
+        for (size_t point_index = from; point_index < to; ++point_index) {
+            const heatmap_point_t& point = m_points[point_index];
+            if (point.layer != filter.layer ||
+                (puuid_code != UINT32_MAX && point.puuid_code != puuid_code) ||
+                (filter.champion_id && point.champion_id != filter.champion_id) ||
+                (0 <= filter.role && point.role != filter.role)) {
+                continue ;
+            }
+            const int x = std::clamp(point.x * resolution / HEATMAP_MAP_SIZE, 0, resolution - 1);
+            const int y = std::clamp(point.y * resolution / HEATMAP_MAP_SIZE, 0, resolution - 1);
+            ++counts[static_cast<size_t>(y) * resolution + x];
+            ++n_of_points;
+        }
+        task_n_of_points[task] = n_of_points;
+    };
+
+    if (n_of_tasks == 1) {
+        bin(0);
+    } else {
+        task_group_t group;
+        for (size_t task = 0; task < n_of_tasks; ++task) {
+            m_executor.submit([&bin, task]() { bin(task); }, &group);
+        }
+        group.wait();
+    }
+
+    for (size_t task = 0; task < n_of_tasks; ++task) {
+        const std::vector<uint32_t>& counts = task_counts[task];
+        for (size_t cell = 0; cell < n_of_cells; ++cell) {
+            result->cells[cell] += static_cast<float>(counts[cell]);
+        }
+        result->n_of_points += task_n_of_points[task];
+    }
+}
+
+void heatmap_engine_t::champion_ids(const std::string& puuid, std::vector<int>* result) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    result->clear();
+    auto code_it = m_puuid_to_code.find(puuid);
+    if (code_it == m_puuid_to_code.end()) {
+        return ;
+    }
+    std::unordered_set<int> ids;
+    for (const heatmap_point_t& point : m_points) {
+        if (point.puuid_code == code_it->second) {
+            ids.insert(point.champion_id);
+        }
+    }
+    result->assign(ids.begin(), ids.end());
+    std::sort(result->begin(), result->end());
+}
+
+uint64_t heatmap_engine_t::version() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    return m_version;
+}
@@ -0,0 +1,157 @@
+#ifndef HEATMAP_H
+# define HEATMAP_H
+
+# include <string>
+# include <vector>
+# include <unordered_map>
+# include <unordered_set>
+# include <mutex>
+# include <cstdint>
+
+# include "json.hpp"
+# include "raylib.h"
+# include "timeline.h"
+# include "executor.h"
+# include "append_log.h"
+
+// cells per side of a heatmap grid
+# define HEATMAP_RESOLUTION 256
+// summoner's rift coordinates span [0, HEATMAP_MAP_SIZE) on both axes
+# define HEATMAP_MAP_SIZE 15000
+
+enum heatmap_layer_t : uint8_t {
+    HEATMAP_LAYER_KILLS,  // where the participant got champion kills
+    HEATMAP_LAYER_DEATHS, // where the participant died
+    HEATMAP_LAYER_WARDS,  // where the participant placed wards
+
+    _HEATMAP_LAYER_SIZE
+};
+const char* heatmap_layer_to_str(heatmap_layer_t layer);
+
+enum heatmap_role_t : uint8_t {
+    HEATMAP_ROLE_TOP,
+    HEATMAP_ROLE_JUNGLE,
+    HEATMAP_ROLE_MIDDLE,
+    HEATMAP_ROLE_BOTTOM,
+    HEATMAP_ROLE_UTILITY,
+    HEATMAP_ROLE_UNKNOWN,
+
+    _HEATMAP_ROLE_SIZE
+};
+const char* heatmap_role_to_str(heatmap_role_t role);
+// from match-v5 "teamPosition"
+heatmap_role_t heatmap_role_from_str(const std::string& team_position);
+
+/**
+ * 12 bytes, one per event position of a participant.
+*/
+struct heatmap_point_t {
+    int16_t         x;
+    int16_t         y;
+    heatmap_layer_t layer;
+    heatmap_role_t  role;
+    uint16_t        champion_id;
+    uint32_t        puuid_code; // index into heatmap_engine_t::m_puuids
+};
+
+struct heatmap_filter_t {
+    heatmap_layer_t layer = HEATMAP_LAYER_KILLS;
+    std::string     puuid;            // empty for every participant
+    int             champion_id = 0;  // 0 for every champion
+    int             role = -1;        // heatmap_role_t, -1 for every role
+
+    bool operator==(const heatmap_filter_t&) const = default;
+};
+
+/**
+ * Row major, cell (x, y) covers map coordinates [x, x + 1) * HEATMAP_MAP_SIZE / resolution, y grows towards the top of the map.
+*/
+struct heatmap_grid_t {
+    int                width = 0;
+    int                height = 0;
+    std::vector<float> cells;
+    // events binned, before blurring
+    uint64_t           n_of_points = 0;
+
+    void resize(int width, int height);
+};
+
+// separable gaussian, sigma in cells
+void heatmap_blur(heatmap_grid_t* grid, float sigma);
+// scales the cells into [0, 1], the largest cell becomes 1
+void heatmap_normalize(heatmap_grid_t* grid);
+// uploads a normalized grid as a colored, transparent where cold, texture, reusing *texture when the size matches
+void heatmap_upload_texture(const heatmap_grid_t& grid, Texture2D* texture);
+
+/**
+ * Event positions of every ingested match timeline, kept in memory as heatmap_point_t so any filter is a pass over one array.
+ * Accumulation splits the points over worker threads, each bins its share into a grid of its own, the grids are then summed.
+ *
+ * File layout: "LTHM" magic, u32 version, then one record per match:
+ *   u32 match id size, match id, u32 n of participants, n * (u32 puuid size, puuid, u16 champion id, u8 role),
+ *   u32 n of points, n * (i16 x, i16 y, u8 layer, u8 participant index)
+ * Records are replayed on open, a torn last record is truncated away.
+ *
+ * Example call:
+ * heatmap_engine_t heatmap;
+ * heatmap.open("heatmap.bin");
+ * heatmap.add_match(match_id, match_info, timeline);
+ * heatmap_filter_t filter;
+ * filter.layer = HEATMAP_LAYER_DEATHS;
+ * filter.puuid = puuid;
+ * heatmap_grid_t grid;
+ * heatmap.accumulate(filter, HEATMAP_RESOLUTION, &grid);
+ * heatmap_blur(&grid, 2.0f);
+ * heatmap_normalize(&grid);
+ * heatmap_upload_texture(grid, &texture);
+*/
+struct heatmap_engine_t {
+    heatmap_engine_t() = default;
+    heatmap_engine_t(const heatmap_engine_t&) = delete;
+    heatmap_engine_t& operator=(const heatmap_engine_t&) = delete;
+    ~heatmap_engine_t();
+
+    // n_of_workers: accumulation threads, 0 for one per core
+    int  open(const std::string& path, size_t n_of_workers = 0);
+    void close();
+
+    // thread safe, matches already added are ignored, returns the number of points added, -1 if the match could not be decoded
+    int  add_match(const std::string& match_id, const nlohmann::json& match_info, const match_timeline_t& match_timeline);
+
+    // must not be called from the executor's threads
+    void accumulate(const heatmap_filter_t& filter, int resolution, heatmap_grid_t* result);
+
+    // champion ids with points of the puuid, ascending
+    void champion_ids(const std::string& puuid, std::vector<int>* result);
+    // changes every time a match is added, to know when a grid is stale
+    uint64_t version();
+
+    struct participant_t {
+        uint32_t       puuid_code;
+        uint16_t       champion_id;
+        heatmap_role_t role;
+    };
+    struct raw_point_t {
+        int16_t         x;
+        int16_t         y;
+        heatmap_layer_t layer;
+        uint8_t         participant_index;
+    };
+
+    // m_mutex must be held
+    uint32_t puuid_code(const std::string& puuid);
+    void     apply(const std::vector<participant_t>& participants, const std::vector<raw_point_t>& raw_points);
+    int      write_record(const std::string& match_id, const std::vector<participant_t>& participants, const std::vector<raw_point_t>& raw_points);
+
+    std::mutex                                m_mutex;
+    append_log_t                              m_log;
+    executor_t                                m_executor;
+    size_t                                    m_n_of_workers = 0;
+    std::vector<heatmap_point_t>              m_points;
+    std::vector<std::string>                  m_puuids;
+    std::unordered_map<std::string, uint32_t> m_puuid_to_code;
+    std::unordered_set<std::string>           m_match_ids;
+    uint64_t                                  m_version = 0;
+};
+
+#endif // HEATMAP_H
@@ -0,0 +1,277 @@
+#include "history.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+#include <cassert>
+
+#define HISTORY_MAGIC "LTHS"
+#define HISTORY_VERSION 1
+
+enum history_record_t : uint8_t {
+    HISTORY_RECORD_ACCOUNT = 1,
+    HISTORY_RECORD_SNAPSHOT = 2
+};
+
+static void write_varint(std::vector<unsigned char>* buffer, uint64_t value) {
+    while (0x80 <= value) {
+        buffer->push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    buffer->push_back(static_cast<unsigned char>(value));
+}
+
+static void write_zigzag(std::vector<unsigned char>* buffer, int64_t value) {
+    write_varint(buffer, (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+}
+
+static int read_varint(const unsigned char** cur, const unsigned char* end, uint64_t* value) {
+    *value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (*cur == end) {
+            return 1;
+        }
+        unsigned char byte = *(*cur)++;
+        *value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+static int read_zigzag(const unsigned char** cur, const unsigned char* end, int64_t* value) {
+    uint64_t encoded;
+    if (read_varint(cur, end, &encoded)) {
+        return 1;
+    }
+    *value = static_cast<int64_t>(encoded >> 1) ^ -static_cast<int64_t>(encoded & 1);
+
+    return 0;
+}
+
+static int64_t to_milli_value(double value) {
+    return std::llround(value * 1000.0);
+}
+
+history_store_t::~history_store_t() {
+    close();
+}
+
+int history_store_t::open(const std::string& path) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_accounts.clear();
+    m_puuid_to_account.clear();
+
+    std::vector<unsigned char> buffer;
+    if (m_log.open(path, HISTORY_MAGIC, HISTORY_VERSION, "history", &buffer)) {
+        return 1;
+    }
+
+    const unsigned char* cur = buffer.data() + APPEND_LOG_HEADER_SIZE;
+    const unsigned char* end = buffer.data() + buffer.size();
+    const unsigned char* last_complete_record = cur;
+    while (cur < end) {
+        const uint8_t tag = *cur++;
+        uint64_t account_index;
+        if (read_varint(&cur, end, &account_index)) {
+            break ;
+        }
+
+        if (tag == HISTORY_RECORD_ACCOUNT) {
+            uint64_t puuid_size;
+            if (account_index != m_accounts.size() || read_varint(&cur, end, &puuid_size) || end - cur < static_cast<ptrdiff_t>(puuid_size)) {
+                break ;
+            }
+            account_history_t& account = m_accounts.emplace_back();
+            account.puuid.assign(reinterpret_cast<const char*>(cur), puuid_size);
+            account.first_timestamp = 0;
+            account.last_timestamp = 0;
+            m_puuid_to_account[account.puuid] = static_cast<int>(account_index);
+            cur += puuid_size;
+        } else if (tag == HISTORY_RECORD_SNAPSHOT) {
+            if (m_accounts.size() <= account_index) {
+                break ;
+            }
+            account_history_t& account = m_accounts[account_index];
+            int64_t timestamp_delta;
+            uint64_t n;
+            if (read_zigzag(&cur, end, &timestamp_delta) || read_varint(&cur, end, &n)) {
+                break ;
+            }
+            const int64_t timestamp = account.last_timestamp + timestamp_delta;
+
+            // decode into a scratch list first so a truncated snapshot leaves the index untouched
+            std::vector<std::pair<int, int64_t>> changes;
+            int64_t challenge_id = 0;
+            bool is_truncated = false;
+            for (uint64_t change_index = 0; change_index < n; ++change_index) {
+                int64_t challenge_id_delta;
+                int64_t milli_value_delta;
+                if (read_zigzag(&cur, end, &challenge_id_delta) || read_zigzag(&cur, end, &milli_value_delta)) {
+                    is_truncated = true;
+                    break ;
+                }
+                challenge_id += challenge_id_delta;
+                changes.push_back({ static_cast<int>(challenge_id), milli_value_delta });
+            }
+            if (is_truncated) {
+                break ;
+            }
+
+            if (account.last_timestamp == 0) {
+                account.first_timestamp = timestamp;
+            }
+            account.last_timestamp = timestamp;
+            for (const auto& change : changes) {
+                int64_t& milli_value = account.challenge_id_to_last_milli_value[change.first];
+                milli_value += change.second;
+                account.challenge_id_to_series[change.first].push_back({ .timestamp = timestamp, .value = milli_value / 1000.0 });
+            }
+        } else {
+            break ;
+        }
+
+        last_complete_record = cur;
+    }
+
+
+    return m_log.truncate_torn_tail(last_complete_record - buffer.data());
+}
+
+void history_store_t::close() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_log.close();
+}
+
+int history_store_t::append_snapshot(const std::string& puuid, int64_t timestamp, const challenge_catalog_t& catalog, const account_t& account) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    if (!m_log.is_open()) {
+        return -1;
+    }
+
+    // nothing in memory moves before the record is on disk
+    std::vector<unsigned char> buffer;
+    auto account_it = m_puuid_to_account.find(puuid);
+    const bool is_new_account = account_it == m_puuid_to_account.end();
+    const int account_index = is_new_account ? static_cast<int>(m_accounts.size()) : account_it->second;
+    const account_history_t new_account_history = {
+        .puuid = puuid,
+        .first_timestamp = 0,
+        .last_timestamp = 0,
+        .challenge_id_to_series = {},
+        .challenge_id_to_last_milli_value = {}
+    };
+    const account_history_t& account_history = is_new_account ? new_account_history : m_accounts[account_index];
+    if (is_new_account) {
+        buffer.push_back(HISTORY_RECORD_ACCOUNT);
+        write_varint(&buffer, account_index);
+        write_varint(&buffer, puuid.size());
+        buffer.insert(buffer.end(), puuid.begin(), puuid.end());
+    }
+
+    std::vector<std::pair<int, int64_t>> changes;
+    for (const challenge_t& challenge : catalog.m_challenges) {
+        const int64_t milli_value = to_milli_value(account.m_progress[challenge.slot].value);
+        auto last_milli_value_it = account_history.challenge_id_to_last_milli_value.find(challenge.id);
+        const int64_t last_milli_value = last_milli_value_it == account_history.challenge_id_to_last_milli_value.end() ? 0 : last_milli_value_it->second;
+        if (milli_value != last_milli_value) {
+            changes.push_back({ challenge.id, milli_value });
+        }
+    }
+    std::sort(changes.begin(), changes.end());
+
+    const bool is_first_snapshot = account_history.last_timestamp == 0;
+    const bool is_snapshot_written = !changes.empty() || is_first_snapshot;
+    if (is_snapshot_written) {
+        buffer.push_back(HISTORY_RECORD_SNAPSHOT);
+        write_varint(&buffer, account_index);
+        write_zigzag(&buffer, timestamp - account_history.last_timestamp);
+        write_varint(&buffer, changes.size());
+        int previous_challenge_id = 0;
+        for (const auto& change : changes) {
+            auto last_milli_value_it = account_history.challenge_id_to_last_milli_value.find(change.first);
+            const int64_t last_milli_value = last_milli_value_it == account_history.challenge_id_to_last_milli_value.end() ? 0 : last_milli_value_it->second;
+            write_zigzag(&buffer, change.first - previous_challenge_id);
+            write_zigzag(&buffer, change.second - last_milli_value);
+            previous_challenge_id = change.first;
+        }
+    }
+    if (!buffer.empty() && m_log.append(buffer.data(), buffer.size())) {
+        return -1;
+    }
+
+    if (is_new_account) {
+        m_accounts.push_back(new_account_history);
+        m_puuid_to_account.insert({ puuid, account_index });
+    }
+    if (!is_snapshot_written) {
+        return 0;
+    }
+    account_history_t& written_account_history = m_accounts[account_index];
+    for (const auto& change : changes) {
+        written_account_history.challenge_id_to_last_milli_value[change.first] = change.second;
+        written_account_history.challenge_id_to_series[change.first].push_back({ .timestamp = timestamp, .value = change.second / 1000.0 });
+    }
+    if (is_first_snapshot) {
+        written_account_history.first_timestamp = timestamp;
+    }
+    written_account_history.last_timestamp = timestamp;
+
+    return static_cast<int>(changes.size());
+}
+
+void history_store_t::range(const std::string& puuid, int challenge_id, int64_t from, int64_t to, std::vector<history_point_t>* result) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    result->clear();
+    auto account_it = m_puuid_to_account.find(puuid);
+    if (account_it == m_puuid_to_account.end()) {
+        return ;
+    }
+    const account_history_t& account_history = m_accounts[account_it->second];
+    auto series_it = account_history.challenge_id_to_series.find(challenge_id);
+    if (series_it == account_history.challenge_id_to_series.end()) {
+        return ;
+    }
+
+    const std::vector<history_point_t>& series = series_it->second;
+    const auto by_timestamp = [](const history_point_t& point, int64_t timestamp) {
+        return point.timestamp < timestamp;
+    };
+    auto first = std::lower_bound(series.begin(), series.end(), from, by_timestamp);
+    auto last = std::lower_bound(first, series.end(), to, by_timestamp);
+    result->assign(first, last);
+}
+
+int history_store_t::value_at(const std::string& puuid, int challenge_id, int64_t timestamp, double* value) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    auto account_it = m_puuid_to_account.find(puuid);
+    if (account_it == m_puuid_to_account.end()) {
+        return 1;
+    }
+    const account_history_t& account_history = m_accounts[account_it->second];
+    // challenges that never moved from 0 have no series
+    *value = 0.0;
+    auto series_it = account_history.challenge_id_to_series.find(challenge_id);
+    if (series_it == account_history.challenge_id_to_series.end()) {
+        return 0;
+    }
+
+    timestamp = std::max(timestamp, account_history.first_timestamp);
+    const std::vector<history_point_t>& series = series_it->second;
+    auto after = std::upper_bound(series.begin(), series.end(), timestamp, [](int64_t timestamp, const history_point_t& point) {
+        return timestamp < point.timestamp;
+    });
+    if (after != series.begin()) {
+        *value = std::prev(after)->value;
+    }
+
+    return 0;
+}
@@ -0,0 +1,61 @@
+#ifndef HISTORY_H
+# define HISTORY_H
+
+# include "challenges.h"
+# include "append_log.h"
+
+# include <string>
+# include <vector>
+# include <unordered_map>
+# include <mutex>
+# include <cstdint>
+
+struct history_point_t {
+    int64_t timestamp; // unix seconds
+    double  value;
+};
+
+/**
+ * Append-only snapshot history of the tracked accounts' challenge values.
+ *
+ * File layout: "LTHS" magic, u32 version, then a stream of records
+ *   account:  u8 HISTORY_RECORD_ACCOUNT, varint account, varint puuid size, puuid
+ *   snapshot: u8 HISTORY_RECORD_SNAPSHOT, varint account, zigzag varint timestamp delta, varint n,
+ *             n * (zigzag varint challenge id delta, zigzag varint value delta)
+ * Every delta is against the previous record of the same account/series, values are stored in thousandths.
+ * Only the challenges whose value changed are written, polls where nothing changed write nothing.
+ * The whole file is indexed in memory on open.
+*/
+struct history_store_t {
+    history_store_t() = default;
+    history_store_t(const history_store_t&) = delete;
+    history_store_t& operator=(const history_store_t&) = delete;
+    ~history_store_t();
+
+    int  open(const std::string& path);
+    void close();
+
+    // returns the number of changed challenges that were written, or -1 on failure
+    int  append_snapshot(const std::string& puuid, int64_t timestamp, const challenge_catalog_t& catalog, const account_t& account);
+
+    // points with from <= timestamp < to, ascending in time
+    void range(const std::string& puuid, int challenge_id, int64_t from, int64_t to, std::vector<history_point_t>* result);
+    // value in effect at 'timestamp', timestamps before the first snapshot of the account resolve to the first snapshot
+    // returns 1 if the account has no snapshot, value is left as is
+    int  value_at(const std::string& puuid, int challenge_id, int64_t timestamp, double* value);
+
+    struct account_history_t {
+        std::string                                       puuid;
+        int64_t                                           first_timestamp;
+        int64_t                                           last_timestamp;
+        std::unordered_map<int, std::vector<history_point_t>> challenge_id_to_series;
+        std::unordered_map<int, int64_t>                  challenge_id_to_last_milli_value;
+    };
+
+    std::mutex                           m_mutex;
+    append_log_t                         m_log;
+    std::vector<account_history_t>       m_accounts;
+    std::unordered_map<std::string, int> m_puuid_to_account;
+};
+
+#endif // HISTORY_H
@@ -0,0 +1,858 @@
+#include "http.h"
+
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+
+#include <netdb.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+
+#include <zlib.h>
+
+#define HTTP_MAX_HEAD_SIZE (64 * 1024)
+#define HTTP_READ_SIZE (16 * 1024)
+
+struct http_connection_t {
+    http_pool_t*                          pool;
+    std::string                           host_key;
+    int                                   fd;
+    SSL*                                  ssl;
+    size_t                                n_of_requests;
+    std::chrono::steady_clock::time_point last_used;
+    std::string                           read_buffer; // received bytes the parser has not consumed yet
+};
+
+enum http_body_framing_t {
+    HTTP_BODY_FRAMING_NONE,
+    HTTP_BODY_FRAMING_CONTENT_LENGTH,
+    HTTP_BODY_FRAMING_CHUNKED,
+    HTTP_BODY_FRAMING_UNTIL_CLOSE
+};
+
+/**
+ * Streaming gzip/deflate decoder, output goes to on_data in pieces of at most HTTP_READ_SIZE.
+ * 'deflate' is supposed to be zlib wrapped, servers sending raw deflate streams are handled too.
+*/
+struct http_decoder_t {
+    http_decoder_t() = default;
+    http_decoder_t(const http_decoder_t&) = delete;
+    http_decoder_t& operator=(const http_decoder_t&) = delete;
+    ~http_decoder_t();
+
+    int init(bool is_deflate);
+    int write(const char* data, size_t size, const std::function<int(const char* data, size_t size)>& on_data);
+    // fails if the compressed stream was cut short
+    int finish();
+
+    z_stream m_stream;
+    bool     m_is_initialized = false;
+    bool     m_is_raw_deflate_fallback_allowed = false;
+    bool     m_is_finished = false;
+};
+
+static int ssl_connection_index = -1;
+
+static std::string to_lower(std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return str;
+}
+
+static std::string trim(const std::string& str) {
+    const size_t first = str.find_first_not_of(" \t");
+    if (first == std::string::npos) {
+        return "";
+    }
+    const size_t last = str.find_last_not_of(" \t");
+    return str.substr(first, last - first + 1);
+}
+
+static std::string to_host_key(const std::string& scheme, const std::string& host_name, size_t port) {
+    return scheme + "://" + host_name + ":" + std::to_string(port);
+}
+
+static int on_new_ssl_session(SSL* ssl, SSL_SESSION* session) {
+    http_connection_t* connection = static_cast<http_connection_t*>(SSL_get_ex_data(ssl, ssl_connection_index));
+    if (!connection) {
+        return 0;
+    }
+
+    connection->pool->on_new_tls_session(connection->host_key, session);
+    // the pool owns the session from here on
+    return 1;
+}
+
+static int connect_socket(const std::string& host_name, size_t port, int connect_timeout_ms, int io_timeout_ms) {
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* addrs = 0;
+    if (getaddrinfo(host_name.c_str(), std::to_string(port).c_str(), &hints, &addrs)) {
+        return -1;
+    }
+
+    int fd = -1;
+    for (addrinfo* addr = addrs; addr; addr = addr->ai_next) {
+        fd = socket(addr->ai_family, addr->ai_socktype | SOCK_CLOEXEC, addr->ai_protocol);
+        if (fd < 0) {
+            continue ;
+        }
+
+        const int flags = fcntl(fd, F_GETFL, 0);
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+        int result = connect(fd, addr->ai_addr, addr->ai_addrlen);
+        if (result < 0 && errno == EINPROGRESS) {
+            pollfd poll_fd = { .fd = fd, .events = POLLOUT, .revents = 0 };
+            result = poll(&poll_fd, 1, connect_timeout_ms) == 1 ? 0 : -1;
+            int so_error = 0;
+            socklen_t so_error_size = sizeof(so_error);
+            if (result == 0 && (getsockopt(fd, SOL_SOCKET, SO_ERROR, &so_error, &so_error_size) || so_error)) {
+                result = -1;
+            }
+        }
+        if (result == 0) {
+            fcntl(fd, F_SETFL, flags);
+            break ;
+        }
+
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(addrs);
+
+    if (0 <= fd) {
+        const int no_delay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+        timeval io_timeout = { .tv_sec = io_timeout_ms / 1000, .tv_usec = (io_timeout_ms % 1000) * 1000 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &io_timeout, sizeof(io_timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &io_timeout, sizeof(io_timeout));
+    }
+
+    return fd;
+}
+
+static void close_connection(http_connection_t* connection) {
+    if (connection->ssl) {
+        SSL_set_ex_data(connection->ssl, ssl_connection_index, 0);
+        SSL_shutdown(connection->ssl);
+        SSL_free(connection->ssl);
+    }
+    if (0 <= connection->fd) {
+        close(connection->fd);
+    }
+    delete connection;
+}
+
+// returns the number of bytes appended to the read buffer, 0 on orderly close, -1 on error
+static ssize_t fill_read_buffer(http_connection_t* connection) {
+    char buffer[HTTP_READ_SIZE];
+    ssize_t result;
+
+    if (connection->ssl) {
+        const int n = SSL_read(connection->ssl, buffer, sizeof(buffer));
+        if (0 < n) {
+            result = n;
+        } else {
+            result = SSL_get_error(connection->ssl, n) == SSL_ERROR_ZERO_RETURN ? 0 : -1;
+        }
+    } else {
+        do {
+            result = recv(connection->fd, buffer, sizeof(buffer), 0);
+        } while (result < 0 && errno == EINTR);
+    }
+
+    if (0 < result) {
+        connection->read_buffer.append(buffer, result);
+    }
+
+    return result;
+}
+
+static int write_all(http_connection_t* connection, const std::string& data) {
+    size_t n_of_written = 0;
+    while (n_of_written < data.size()) {
+        ssize_t n;
+        if (connection->ssl) {
+            n = SSL_write(connection->ssl, data.data() + n_of_written, static_cast<int>(data.size() - n_of_written));
+        } else {
+            do {
+                n = send(connection->fd, data.data() + n_of_written, data.size() - n_of_written, MSG_NOSIGNAL);
+            } while (n < 0 && errno == EINTR);
+        }
+        if (n <= 0) {
+            return 1;
+        }
+        n_of_written += n;
+    }
+
+    return 0;
+}
+
+static int read_line(http_connection_t* connection, std::string* line) {
+    size_t line_end;
+    while ((line_end = connection->read_buffer.find("\r\n")) == std::string::npos) {
+        if (HTTP_MAX_HEAD_SIZE < connection->read_buffer.size() || fill_read_buffer(connection) <= 0) {
+            return 1;
+        }
+    }
+
+    line->assign(connection->read_buffer, 0, line_end);
+    connection->read_buffer.erase(0, line_end + 2);
+
+    return 0;
+}
+
+/**
+ * is_nothing_received: set if the connection closed before a single byte of the response arrived,
+ * which is how a reused keep-alive connection closed by the server shows up
+*/
+static int read_response_head(http_connection_t* connection, http_response_t* response, int* http_minor_version, bool* is_nothing_received) {
+    size_t head_end;
+    while ((head_end = connection->read_buffer.find("\r\n\r\n")) == std::string::npos) {
+        if (HTTP_MAX_HEAD_SIZE < connection->read_buffer.size()) {
+            *is_nothing_received = false;
+            return 1;
+        }
+        if (fill_read_buffer(connection) <= 0) {
+            *is_nothing_received = connection->read_buffer.empty();
+            return 1;
+        }
+    }
+    *is_nothing_received = false;
+
+    const std::string head = connection->read_buffer.substr(0, head_end + 2);
+    connection->read_buffer.erase(0, head_end + 4);
+
+    size_t line_end = head.find("\r\n");
+    const std::string status_line = head.substr(0, line_end);
+    int http_major_version = 0;
+    if (sscanf(status_line.c_str(), "HTTP/%d.%d %d", &http_major_version, http_minor_version, &response->status) != 3 || http_major_version != 1) {
+        return 1;
+    }
+
+    response->headers.clear();
+    size_t line_start = line_end + 2;
+    while (line_start < head.size()) {
+        line_end = head.find("\r\n", line_start);
+        const std::string line = head.substr(line_start, line_end - line_start);
+        line_start = line_end + 2;
+
+        const size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue ;
+        }
+        response->headers.push_back({ .name = to_lower(trim(line.substr(0, colon))), .value = trim(line.substr(colon + 1)) });
+    }
+
+    return 0;
+}
+
+// delivers exactly n bytes of body to on_data
+static int read_body_bytes(http_connection_t* connection, size_t n, const std::function<int(const char* data, size_t size)>& on_data) {
+    while (0 < n) {
+        if (connection->read_buffer.empty() && fill_read_buffer(connection) <= 0) {
+            return 1;
+        }
+        const size_t n_of_available = std::min(n, connection->read_buffer.size());
+        if (on_data(connection->read_buffer.data(), n_of_available)) {
+            return 1;
+        }
+        connection->read_buffer.erase(0, n_of_available);
+        n -= n_of_available;
+    }
+
+    return 0;
+}
+
+static int read_body(http_connection_t* connection, http_body_framing_t framing, size_t content_length, const std::function<int(const char* data, size_t size)>& on_data) {
+    switch (framing) {
+    case HTTP_BODY_FRAMING_NONE: {
+        return 0;
+    } break ;
+    case HTTP_BODY_FRAMING_CONTENT_LENGTH: {
+        return read_body_bytes(connection, content_length, on_data);
+    } break ;
+    case HTTP_BODY_FRAMING_CHUNKED: {
+        std::string line;
+        while (true) {
+            if (read_line(connection, &line)) {
+                return 1;
+            }
+            char* chunk_size_end = 0;
+            const unsigned long long chunk_size = strtoull(line.c_str(), &chunk_size_end, 16);
+            if (chunk_size_end == line.c_str()) {
+                return 1;
+            }
+            if (chunk_size == 0) {
+                break ;
+            }
+            if (read_body_bytes(connection, chunk_size, on_data) || read_line(connection, &line) || !line.empty()) {
+                return 1;
+            }
+        }
+        // trailers
+        do {
+            if (read_line(connection, &line)) {
+                return 1;
+            }
+        } while (!line.empty());
+        return 0;
+    } break ;
+    case HTTP_BODY_FRAMING_UNTIL_CLOSE: {
+        while (true) {
+            if (!connection->read_buffer.empty()) {
+                if (on_data(connection->read_buffer.data(), connection->read_buffer.size())) {
+                    return 1;
+                }
+                connection->read_buffer.clear();
+            }
+            const ssize_t n = fill_read_buffer(connection);
+            if (n == 0) {
+                return 0;
+            }
+            if (n < 0) {
+                return 1;
+            }
+        }
+    } break ;
+    }
+
+    return 1;
+}
+
+http_decoder_t::~http_decoder_t() {
+    if (m_is_initialized) {
+        inflateEnd(&m_stream);
+    }
+}
+
+int http_decoder_t::init(bool is_deflate) {
+    memset(&m_stream, 0, sizeof(m_stream));
+    // 32: detect gzip or zlib header
+    if (inflateInit2(&m_stream, 15 + 32) != Z_OK) {
+        return 1;
+    }
+    m_is_initialized = true;
+    m_is_raw_deflate_fallback_allowed = is_deflate;
+    m_is_finished = false;
+
+    return 0;
+}
+
+int http_decoder_t::write(const char* data, size_t size, const std::function<int(const char* data, size_t size)>& on_data) {
+    unsigned char decoded[HTTP_READ_SIZE];
+
+    m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    m_stream.avail_in = static_cast<uInt>(size);
+    while (0 < m_stream.avail_in && !m_is_finished) {
+        m_stream.next_out = decoded;
+        m_stream.avail_out = sizeof(decoded);
+        const int result = inflate(&m_stream, Z_NO_FLUSH);
+        if (result == Z_DATA_ERROR && m_is_raw_deflate_fallback_allowed && m_stream.total_out == 0) {
+            // no zlib header, restart on the same input as a raw deflate stream
+            m_is_raw_deflate_fallback_allowed = false;
+            inflateEnd(&m_stream);
+            memset(&m_stream, 0, sizeof(m_stream));
+            if (inflateInit2(&m_stream, -15) != Z_OK) {
+                m_is_initialized = false;
+                return 1;
+            }
+            m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+            m_stream.avail_in = static_cast<uInt>(size);
+            continue ;
+        }
+        if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+            return 1;
+        }
+        m_is_raw_deflate_fallback_allowed = false;
+
+        const size_t n_of_decoded = sizeof(decoded) - m_stream.avail_out;
+        if (0 < n_of_decoded && on_data(reinterpret_cast<const char*>(decoded), n_of_decoded)) {
+            return 1;
+        }
+        if (result == Z_STREAM_END) {
+            m_is_finished = true;
+        } else if (result == Z_BUF_ERROR) {
+            // needs more input
+            break ;
+        }
+    }
+
+    return 0;
+}
+
+int http_decoder_t::finish() {
+    return m_is_finished ? 0 : 1;
+}
+
+const std::string* http_response_t::find_header(const std::string& lowercase_name) const {
+    for (const http_header_t& header : headers) {
+        if (header.name == lowercase_name) {
+            return &header.value;
+        }
+    }
+
+    return 0;
+}
+
+http_pool_t::~http_pool_t() {
+    destroy();
+}
+
+int http_pool_t::init(const http_pool_config_t& config) {
+    static std::once_flag once_flag;
+    std::call_once(once_flag, []() {
+        ssl_connection_index = SSL_get_ex_new_index(0, 0, 0, 0, 0);
+        // writes to a connection the peer has closed must fail instead of killing the process
+        signal(SIGPIPE, SIG_IGN);
+    });
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_config = config;
+    m_executor.init(m_config.max_concurrent_requests);
+    m_ssl_ctx = SSL_CTX_new(TLS_client_method());
+    if (!m_ssl_ctx) {
+        std::cerr << "CLIENT failed to create tls context" << std::endl;
+        return 1;
+    }
+
+    SSL_CTX_set_min_proto_version(m_ssl_ctx, TLS1_2_VERSION);
+#if defined(SSL_OP_IGNORE_UNEXPECTED_EOF)
+    SSL_CTX_set_options(m_ssl_ctx, SSL_OP_IGNORE_UNEXPECTED_EOF);
+#endif
+    if (m_config.is_peer_verified) {
+        SSL_CTX_set_default_verify_paths(m_ssl_ctx);
+        SSL_CTX_set_verify(m_ssl_ctx, SSL_VERIFY_PEER, 0);
+    } else {
+        SSL_CTX_set_verify(m_ssl_ctx, SSL_VERIFY_NONE, 0);
+    }
+    SSL_CTX_set_session_cache_mode(m_ssl_ctx, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+    SSL_CTX_sess_set_new_cb(m_ssl_ctx, &on_new_ssl_session);
+
+    return 0;
+}
+
+void http_pool_t::destroy() {
+    // queued requests still run and need the pool
+    m_executor.destroy();
+
+    std::vector<http_connection_t*> idle_connections;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+
+        for (auto& [host_key, connections] : m_host_key_to_idle_connections) {
+            idle_connections.insert(idle_connections.end(), connections.begin(), connections.end());
+        }
+        m_host_key_to_idle_connections.clear();
+        for (auto& [host_key, session] : m_host_key_to_tls_session) {
+            SSL_SESSION_free(session);
+        }
+        m_host_key_to_tls_session.clear();
+        if (m_ssl_ctx) {
+            // connections still in flight keep their own reference to the context
+            SSL_CTX_free(m_ssl_ctx);
+            m_ssl_ctx = 0;
+        }
+    }
+
+    for (http_connection_t* connection : idle_connections) {
+        close_connection(connection);
+    }
+}
+
+void http_pool_t::on_new_tls_session(const std::string& host_key, ssl_session_st* session) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    ssl_session_st*& cached_session = m_host_key_to_tls_session[host_key];
+    if (cached_session) {
+        SSL_SESSION_free(cached_session);
+    }
+    cached_session = session;
+}
+
+static bool is_connection_healthy(http_connection_t* connection) {
+    if (!connection->read_buffer.empty() || (connection->ssl && SSL_pending(connection->ssl))) {
+        return false;
+    }
+
+    // an idle connection must have nothing to read, readable means the server sent a close or garbage
+    pollfd poll_fd = { .fd = connection->fd, .events = POLLIN, .revents = 0 };
+    return poll(&poll_fd, 1, 0) == 0;
+}
+
+http_connection_t* http_pool_t::acquire_connection(const http_request_t& request, bool* is_reused) {
+    const std::string host_key = to_host_key(request.scheme, request.host_name, request.port);
+    const auto now = std::chrono::steady_clock::now();
+    const auto idle_timeout = std::chrono::milliseconds(m_config.idle_timeout_ms);
+
+    std::vector<http_connection_t*> stale_connections;
+    http_connection_t* connection = 0;
+    SSL_CTX* ssl_ctx = 0;
+    SSL_SESSION* tls_session = 0;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+
+        if (!m_ssl_ctx) {
+            return 0;
+        }
+
+        auto idle_connections_it = m_host_key_to_idle_connections.find(host_key);
+        if (idle_connections_it != m_host_key_to_idle_connections.end()) {
+            std::vector<http_connection_t*>& idle_connections = idle_connections_it->second;
+            while (!idle_connections.empty()) {
+                http_connection_t* idle_connection = idle_connections.back();
+                idle_connections.pop_back();
+                if (idle_timeout < now - idle_connection->last_used || (m_config.is_health_checked_on_reuse && !is_connection_healthy(idle_connection))) {
+                    stale_connections.push_back(idle_connection);
+                    continue ;
+                }
+                connection = idle_connection;
+                break ;
+            }
+        }
+
+        if (!connection && request.scheme == "https") {
+            ssl_ctx = m_ssl_ctx;
+            SSL_CTX_up_ref(ssl_ctx);
+            auto tls_session_it = m_host_key_to_tls_session.find(host_key);
+            if (tls_session_it != m_host_key_to_tls_session.end()) {
+                tls_session = tls_session_it->second;
+                SSL_SESSION_up_ref(tls_session);
+            }
+        }
+    }
+
+    m_stats.n_of_stale_connections += stale_connections.size();
+    for (http_connection_t* stale_connection : stale_connections) {
+        close_connection(stale_connection);
+    }
+
+    if (connection) {
+        ++m_stats.n_of_reuses;
+        *is_reused = true;
+        return connection;
+    }
+    *is_reused = false;
+
+    const int fd = connect_socket(request.host_name, request.port, m_config.connect_timeout_ms, m_config.io_timeout_ms);
+    if (fd < 0) {
+        std::cerr << "CLIENT failed to connect to '" << host_key << "'" << std::endl;
+        if (ssl_ctx) {
+            SSL_CTX_free(ssl_ctx);
+        }
+        if (tls_session) {
+            SSL_SESSION_free(tls_session);
+        }
+        return 0;
+    }
+    ++m_stats.n_of_connects;
+
+    connection = new http_connection_t();
+    connection->pool = this;
+    connection->host_key = host_key;
+    connection->fd = fd;
+    connection->ssl = 0;
+    connection->n_of_requests = 0;
+    connection->last_used = now;
+
+    if (request.scheme == "https") {
+        if (!ssl_ctx) {
+            close_connection(connection);
+            return 0;
+        }
+        connection->ssl = SSL_new(ssl_ctx);
+        SSL_CTX_free(ssl_ctx);
+        if (!connection->ssl) {
+            if (tls_session) {
+                SSL_SESSION_free(tls_session);
+            }
+            close_connection(connection);
+            return 0;
+        }
+        SSL_set_fd(connection->ssl, fd);
+        SSL_set_tlsext_host_name(connection->ssl, request.host_name.c_str());
+        if (m_config.is_peer_verified) {
+            SSL_set1_host(connection->ssl, request.host_name.c_str());
+        }
+        SSL_set_ex_data(connection->ssl, ssl_connection_index, connection);
+        if (tls_session) {
+            SSL_set_session(connection->ssl, tls_session);
+            SSL_SESSION_free(tls_session);
+        }
+
+        if (SSL_connect(connection->ssl) != 1) {
+            std::cerr << "CLIENT tls handshake with '" << host_key << "' failed: " << ERR_reason_error_string(ERR_get_error()) << std::endl;
+            close_connection(connection);
+            return 0;
+        }
+        if (SSL_session_reused(connection->ssl)) {
+            ++m_stats.n_of_tls_resumptions;
+        } else {
+            ++m_stats.n_of_tls_handshakes;
+        }
+    }
+
+    return connection;
+}
+
+void http_pool_t::release_connection(http_connection_t* connection, bool is_reusable) {
+    http_connection_t* evicted_connection = 0;
+    if (is_reusable) {
+        std::lock_guard<std::mutex> guard(m_mutex);
+
+        if (m_ssl_ctx) {
+            connection->last_used = std::chrono::steady_clock::now();
+            std::vector<http_connection_t*>& idle_connections = m_host_key_to_idle_connections[connection->host_key];
+            idle_connections.push_back(connection);
+            connection = 0;
+            if (m_config.max_idle_connections_per_host < idle_connections.size()) {
+                evicted_connection = idle_connections.front();
+                idle_connections.erase(idle_connections.begin());
+            }
+        }
+    }
+
+    if (connection) {
+        close_connection(connection);
+    }
+    if (evicted_connection) {
+        close_connection(evicted_connection);
+    }
+}
+
+void http_pool_t::prune_idle_connections() {
+    const auto now = std::chrono::steady_clock::now();
+    const auto idle_timeout = std::chrono::milliseconds(m_config.idle_timeout_ms);
+
+    std::vector<http_connection_t*> stale_connections;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+
+        for (auto& [host_key, idle_connections] : m_host_key_to_idle_connections) {
+            auto stale_it = std::stable_partition(idle_connections.begin(), idle_connections.end(), [now, idle_timeout](http_connection_t* connection) {
+                return now - connection->last_used <= idle_timeout;
+            });
+            stale_connections.insert(stale_connections.end(), stale_it, idle_connections.end());
+            idle_connections.erase(stale_it, idle_connections.end());
+        }
+    }
+
+    m_stats.n_of_stale_connections += stale_connections.size();
+    for (http_connection_t* connection : stale_connections) {
+        close_connection(connection);
+    }
+}
+
+int http_pool_t::request(const http_request_t& request, http_response_t* response) {
+    response->body.clear();
+    return request_streamed(request, response, [response](const char* data, size_t size) {
+        if (response->body.empty()) {
+            const std::string* content_length = response->find_header("content-length");
+            // with a content encoding the length is the one of the compressed body
+            if (content_length && !response->find_header("content-encoding")) {
+                response->body.reserve(strtoull(content_length->c_str(), 0, 10));
+            }
+        }
+        response->body.append(data, size);
+        return 0;
+    });
+}
+
+int http_pool_t::request_streamed(const http_request_t& request, http_response_t* response, const std::function<int(const char* data, size_t size)>& on_data) {
+    ++m_stats.n_of_requests;
+
+    std::string serialized_request = "GET ";
+    if (request.path_name.empty() || request.path_name[0] != '/') {
+        serialized_request += "/";
+    }
+    serialized_request += request.path_name + " HTTP/1.1\r\n";
+    serialized_request += "Host: " + request.host_name + "\r\n";
+    serialized_request += "Connection: keep-alive\r\n";
+    bool has_accept = false;
+    bool has_accept_encoding = false;
+    for (const http_header_t& header : request.headers) {
+        serialized_request += header.name + ": " + header.value + "\r\n";
+        has_accept |= to_lower(header.name) == "accept";
+        has_accept_encoding |= to_lower(header.name) == "accept-encoding";
+    }
+    if (!has_accept) {
+        serialized_request += "Accept: */*\r\n";
+    }
+    if (!has_accept_encoding && m_config.is_compression_requested) {
+        serialized_request += "Accept-Encoding: gzip, deflate\r\n";
+    }
+    serialized_request += "\r\n";
+
+    // a reused connection may have been closed by the server while idle, that is retried once on a fresh one
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        bool is_reused = false;
+        http_connection_t* connection = acquire_connection(request, &is_reused);
+        if (!connection) {
+            return 1;
+        }
+        ++connection->n_of_requests;
+
+        if (write_all(connection, serialized_request)) {
+            release_connection(connection, false);
+            if (is_reused) {
+                continue ;
+            }
+            return 1;
+        }
+
+        int http_minor_version = 0;
+        bool is_nothing_received = false;
+        if (read_response_head(connection, response, &http_minor_version, &is_nothing_received)) {
+            release_connection(connection, false);
+            if (is_reused && is_nothing_received) {
+                continue ;
+            }
+            return 1;
+        }
+
+        http_body_framing_t framing = HTTP_BODY_FRAMING_UNTIL_CLOSE;
+        size_t content_length = 0;
+        const std::string* transfer_encoding = response->find_header("transfer-encoding");
+        const std::string* content_length_str = response->find_header("content-length");
+        if ((100 <= response->status && response->status < 200) || response->status == 204 || response->status == 304) {
+            framing = HTTP_BODY_FRAMING_NONE;
+        } else if (transfer_encoding && to_lower(*transfer_encoding).find("chunked") != std::string::npos) {
+            framing = HTTP_BODY_FRAMING_CHUNKED;
+        } else if (content_length_str) {
+            framing = HTTP_BODY_FRAMING_CONTENT_LENGTH;
+            content_length = strtoull(content_length_str->c_str(), 0, 10);
+        }
+
+        const std::string* content_encoding = response->find_header("content-encoding");
+        const std::string content_encoding_value = content_encoding ? to_lower(*content_encoding) : "identity";
+        http_decoder_t decoder;
+        if (content_encoding_value == "gzip" || content_encoding_value == "x-gzip" || content_encoding_value == "deflate") {
+            if (decoder.init(content_encoding_value == "deflate")) {
+                release_connection(connection, false);
+                return 1;
+            }
+        } else if (content_encoding_value != "identity") {
+            std::cerr << "CLIENT unsupported content encoding '" << content_encoding_value << "' from '" << request.host_name << "'" << std::endl;
+            release_connection(connection, false);
+            return 1;
+        }
+
+        const int body_result = read_body(connection, framing, content_length, [this, &decoder, &on_data](const char* data, size_t size) {
+            m_stats.n_of_body_bytes_received += size;
+            if (!decoder.m_is_initialized) {
+                m_stats.n_of_body_bytes_decoded += size;
+                return on_data(data, size);
+            }
+            return decoder.write(data, size, [this, &on_data](const char* decoded_data, size_t decoded_size) {
+                m_stats.n_of_body_bytes_decoded += decoded_size;
+                return on_data(decoded_data, decoded_size);
+            });
+        });
+        if (body_result || (decoder.m_is_initialized && framing != HTTP_BODY_FRAMING_NONE && decoder.finish())) {
+            release_connection(connection, false);
+            return 1;
+        }
+
+        const std::string* connection_header = response->find_header("connection");
+        const std::string connection_value = connection_header ? to_lower(*connection_header) : "";
+        const bool is_keep_alive = http_minor_version == 0 ? connection_value == "keep-alive" : connection_value != "close";
+        const bool is_reusable =
+            framing != HTTP_BODY_FRAMING_UNTIL_CLOSE &&
+            is_keep_alive &&
+            connection->n_of_requests < m_config.max_requests_per_connection;
+        release_connection(connection, is_reusable);
+
+        return 0;
+    }
+
+    return 1;
+}
+
+void http_pool_t::get_sync(
+    const std::string& scheme, const std::string& host_name, size_t port, const std::string& path_name,
+    const std::function<void(const unsigned char* serialized_data, size_t serialized_data_size)>& on_success,
+    const std::function<void()>& on_failure
+) {
+    http_request_t request = {
+        .scheme = scheme,
+        .host_name = host_name,
+        .port = port,
+        .path_name = path_name,
+        .headers = {}
+    };
+    http_response_t response;
+    if (this->request(request, &response) || response.status < 200 || 300 <= response.status) {
+        on_failure();
+        return ;
+    }
+
+    on_success(reinterpret_cast<const unsigned char*>(response.body.data()), response.body.size());
+}
+
+void http_pool_t::get_stream_sync(
+    const std::string& scheme, const std::string& host_name, size_t port, const std::string& path_name,
+    const std::function<int(const unsigned char* data, size_t size)>& on_chunk,
+    const std::function<void()>& on_success,
+    const std::function<void()>& on_failure
+) {
+    http_request_t request = {
+        .scheme = scheme,
+        .host_name = host_name,
+        .port = port,
+        .path_name = path_name,
+        .headers = {}
+    };
+    http_response_t response;
+    const bool is_failed = this->request_streamed(request, &response, [&response, &on_chunk](const char* data, size_t size) {
+        if (response.status < 200 || 300 <= response.status) {
+            // error bodies are drained so the connection stays reusable, but not handed out
+            return 0;
+        }
+        return on_chunk(reinterpret_cast<const unsigned char*>(data), size);
+    });
+    if (is_failed || response.status < 200 || 300 <= response.status) {
+        on_failure();
+        return ;
+    }
+
+    on_success();
+}
+
+void http_pool_t::get_stream_async(
+    const std::string& scheme, const std::string& host_name, size_t port, const std::string& path_name,
+    const std::function<int(const unsigned char* data, size_t size)>& on_chunk,
+    const std::function<void()>& on_success,
+    const std::function<void()>& on_failure,
+    task_group_t* group
+) {
+    m_executor.submit([this, scheme, host_name, port, path_name, on_chunk, on_success, on_failure]() {
+        get_stream_sync(scheme, host_name, port, path_name, on_chunk, on_success, on_failure);
+    }, group);
+}
+
+void http_pool_t::get_async(
+    const std::string& scheme, const std::string& host_name, size_t port, const std::string& path_name,
+    const std::function<void(const unsigned char* serialized_data, size_t serialized_data_size)>& on_success,
+    const std::function<void()>& on_failure,
+    task_group_t* group
+) {
+    m_executor.submit([this, scheme, host_name, port, path_name, on_success, on_failure]() {
+        get_sync(scheme, host_name, port, path_name, on_success, on_failure);
+    }, group);
+}
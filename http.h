@@ -0,0 +1,152 @@
+#ifndef HTTP_H
+# define HTTP_H
+
+# include <string>
+# include <vector>
+# include <functional>
+# include <unordered_map>
+# include <mutex>
+# include <atomic>
+
+# include "executor.h"
+
+struct ssl_ctx_st;
+struct ssl_session_st;
+struct http_connection_t;
+
+struct http_header_t {
+    std::string name; // lowercase in responses
+    std::string value;
+};
+
+struct http_request_t {
+    std::string                scheme; // "http" or "https"
+    std::string                host_name;
+    size_t                     port;
+    std::string                path_name;
+    std::vector<http_header_t> headers;
+};
+
+struct http_response_t {
+    int                        status;
+    std::vector<http_header_t> headers;
+    std::string                body;
+
+    // lowercase_name: lowercase header name, returns 0 if the header is missing
+    const std::string* find_header(const std::string& lowercase_name) const;
+};
+
+struct http_pool_config_t {
+    size_t max_idle_connections_per_host = 4;
+    size_t max_requests_per_connection   = 1000;
+    int    idle_timeout_ms               = 30000;
+    int    connect_timeout_ms            = 5000;
+    int    io_timeout_ms                 = 15000;
+    // poll idle sockets before reusing them, drops the ones the server has closed in the meantime
+    bool   is_health_checked_on_reuse    = true;
+    bool   is_peer_verified              = true;
+    // sends 'Accept-Encoding: gzip, deflate' unless the request sets its own, bodies are decoded before reaching callers
+    bool   is_compression_requested      = true;
+    // number of executor workers running get_async requests
+    size_t max_concurrent_requests       = 8;
+};
+
+struct http_pool_stats_t {
+    std::atomic<size_t> n_of_requests{ 0 };
+    std::atomic<size_t> n_of_connects{ 0 };
+    std::atomic<size_t> n_of_reuses{ 0 };
+    std::atomic<size_t> n_of_tls_handshakes{ 0 };
+    std::atomic<size_t> n_of_tls_resumptions{ 0 };
+    std::atomic<size_t> n_of_stale_connections{ 0 };
+    // body bytes as sent on the wire and after content decoding
+    std::atomic<size_t> n_of_body_bytes_received{ 0 };
+    std::atomic<size_t> n_of_body_bytes_decoded{ 0 };
+};
+
+/**
+ * HTTP/1.1 client keeping a pool of keep-alive connections per (scheme, host, port),
+ * TLS sessions are cached per host so new connections resume instead of doing a full handshake.
+ *
+ * Example call:
+ * http_pool_t pool;
+ * pool.init();
+ * task_group_t group;
+ * pool.get_async(
+ *   "https", "raw.communitydragon.org", 443, "latest/plugins/rcp-be-lol-game-data/global/default/v1/champions/",
+ *   [](const unsigned char* serialized_data, size_t serialized_data_size) {
+ *     // process fetched result ...
+ *   },
+ *   []() {
+ *     // log failure ...
+ *   },
+ *   &group
+ * );
+ * group.wait();
+*/
+struct http_pool_t {
+    http_pool_t() = default;
+    http_pool_t(const http_pool_t&) = delete;
+    http_pool_t& operator=(const http_pool_t&) = delete;
+    ~http_pool_t();
+
+    int  init(const http_pool_config_t& config = http_pool_config_t());
+    void destroy();
+
+    // blocking, returns 0 if a response was received, whatever its status
+    int  request(const http_request_t& request, http_response_t* response);
+    /**
+     * Same as request, but the body is handed to on_data as it arrives instead of being buffered, response->body stays empty.
+     * The head in response is filled in before the first on_data call, a nonzero return from on_data aborts the request.
+    */
+    int  request_streamed(const http_request_t& request, http_response_t* response, const std::function<int(const char* data, size_t size)>& on_data);
+
+    // same contract as gil_web's get_async/get_sync, on_success is called for 2xx responses only
+    // group: optional, counts the request until its callback has returned
+    void get_async(
+        const std::string& scheme, const std::string& host_name, size_t port, const std::string& path_name,
+        const std::function<void(const unsigned char* serialized_data, size_t serialized_data_size)>& on_success,
+        const std::function<void()>& on_failure,
+        task_group_t* group = 0
+    );
+    void get_sync(
+        const std::string& scheme, const std::string& host_name, size_t port, const std::string& path_name,
+        const std::function<void(const unsigned char* serialized_data, size_t serialized_data_size)>& on_success,
+        const std::function<void()>& on_failure
+    );
+
+    /**
+     * Streaming variant, on_chunk receives the body of a 2xx response piece by piece, at most one socket read at a time,
+     * return nonzero from it to abort. on_success follows the last chunk.
+     * on_failure may follow some chunks if the transfer breaks midway, whatever was consumed so far is incomplete.
+    */
+    void get_stream_async(
+        const std::string& scheme, const std::string& host_name, size_t port, const std::string& path_name,
+        const std::function<int(const unsigned char* data, size_t size)>& on_chunk,
+        const std::function<void()>& on_success,
+        const std::function<void()>& on_failure,
+        task_group_t* group = 0
+    );
+    void get_stream_sync(
+        const std::string& scheme, const std::string& host_name, size_t port, const std::string& path_name,
+        const std::function<int(const unsigned char* data, size_t size)>& on_chunk,
+        const std::function<void()>& on_success,
+        const std::function<void()>& on_failure
+    );
+
+    // closes idle connections that outlived the idle timeout
+    void prune_idle_connections();
+
+    http_connection_t* acquire_connection(const http_request_t& request, bool* is_reused);
+    void               release_connection(http_connection_t* connection, bool is_reusable);
+    void               on_new_tls_session(const std::string& host_key, ssl_session_st* session);
+
+    http_pool_config_t                                               m_config;
+    ssl_ctx_st*                                                      m_ssl_ctx = 0;
+    std::mutex                                                       m_mutex;
+    std::unordered_map<std::string, std::vector<http_connection_t*>> m_host_key_to_idle_connections;
+    std::unordered_map<std::string, ssl_session_st*>                 m_host_key_to_tls_session;
+    http_pool_stats_t                                                m_stats;
+    executor_t                                                       m_executor;
+};
+
+#endif // HTTP_H
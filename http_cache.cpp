@@ -0,0 +1,226 @@
+#include "http_cache.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdint>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+struct http_cache_entry_t {
+    std::string url;
+    std::string etag;
+    std::string last_modified;
+};
+
+// FNV-1a, file names have to stay stable across runs and builds
+static std::string url_to_file_stem(const std::string& url) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : url) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+
+    char result[17];
+    snprintf(result, sizeof(result), "%016llx", static_cast<unsigned long long>(hash));
+    return result;
+}
+
+static int read_entry(const std::string& path, http_cache_entry_t* entry) {
+    std::ifstream ifs(path);
+    if (!ifs) {
+        return 1;
+    }
+
+    std::string version;
+    if (!std::getline(ifs, version) || version != "1") {
+        return 1;
+    }
+    if (!std::getline(ifs, entry->url) || !std::getline(ifs, entry->etag) || !std::getline(ifs, entry->last_modified)) {
+        return 1;
+    }
+
+    return 0;
+}
+
+static int write_entry(const std::string& path, const http_cache_entry_t& entry) {
+    const std::string tmp_path = path + ".tmp";
+    {
+        std::ofstream ofs(tmp_path, std::ios::trunc);
+        ofs << "1\n" << entry.url << "\n" << entry.etag << "\n" << entry.last_modified << "\n";
+        if (!ofs.flush()) {
+            remove(tmp_path.c_str());
+            return 1;
+        }
+    }
+
+    if (rename(tmp_path.c_str(), path.c_str())) {
+        remove(tmp_path.c_str());
+        return 1;
+    }
+
+    return 0;
+}
+
+// the validators of response replace the stored ones, without any the entry is dropped as there is nothing to revalidate with
+static void update_entry(const std::string& entry_path, const std::string& url, const http_response_t& response) {
+    const std::string* etag = response.find_header("etag");
+    const std::string* last_modified = response.find_header("last-modified");
+    const http_cache_entry_t entry = {
+        .url = url,
+        .etag = etag ? *etag : "",
+        .last_modified = last_modified ? *last_modified : ""
+    };
+    if (entry.etag.empty() && entry.last_modified.empty()) {
+        remove(entry_path.c_str());
+    } else if (write_entry(entry_path, entry)) {
+        std::cerr << "CLIENT failed to write cache entry of '" << url << "'" << std::endl;
+    }
+}
+
+int http_cache_t::init(http_pool_t* pool, const std::string& directory) {
+    m_pool = pool;
+    m_directory = directory;
+
+    if (mkdir(m_directory.c_str(), 0755) && errno != EEXIST) {
+        std::cerr << "CLIENT failed to create cache directory '" << m_directory << "'" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+void http_cache_t::get_sync(
+    const std::string& scheme, const std::string& host_name, size_t port, const std::string& path_name,
+    const std::function<void(const unsigned char* serialized_data, size_t serialized_data_size)>& on_success,
+    const std::function<void()>& on_failure
+) {
+    const std::string url = scheme + "://" + host_name + ":" + std::to_string(port) + "/" + path_name;
+    const std::string file_stem = m_directory + "/" + url_to_file_stem(url);
+    const std::string body_path = file_stem + ".body";
+
+    http_request_t request = {
+        .scheme = scheme,
+        .host_name = host_name,
+        .port = port,
+        .path_name = path_name,
+        .headers = {}
+    };
+    const bool is_revalidated = add_validators(url, &request.headers) == 0;
+
+    // concurrent fetches of the same url must not share a temporary file
+    const std::string tmp_body_path = body_path + "." + std::to_string(m_n_of_tmp_files++) + ".tmp";
+    FILE* tmp_body = 0;
+    http_response_t response;
+    const int result = m_pool->request_streamed(request, &response, [&](const char* data, size_t size) {
+        if (response.status != 200) {
+            return 0;
+        }
+        if (!tmp_body) {
+            tmp_body = fopen(tmp_body_path.c_str(), "wb");
+            if (!tmp_body) {
+                return 1;
+            }
+        }
+        return fwrite(data, 1, size, tmp_body) == size ? 0 : 1;
+    });
+    const bool is_written = tmp_body == 0 || fclose(tmp_body) == 0;
+
+    if (result == 0 && response.status == 304 && is_revalidated) {
+        mapped_file_t body;
+        if (read_body(url, &body)) {
+            on_failure();
+            return ;
+        }
+        on_success(body.m_data, body.m_size);
+        return ;
+    }
+
+    if (result || response.status != 200 || !is_written) {
+        remove(tmp_body_path.c_str());
+        on_failure();
+        return ;
+    }
+    ++m_n_of_misses;
+
+    if (!tmp_body) {
+        // empty body, nothing was streamed
+        FILE* empty_body = fopen(tmp_body_path.c_str(), "wb");
+        if (empty_body) {
+            fclose(empty_body);
+        }
+    }
+
+    mapped_file_t body;
+    if (rename(tmp_body_path.c_str(), body_path.c_str()) || body.open(body_path)) {
+        remove(tmp_body_path.c_str());
+        on_failure();
+        return ;
+    }
+    update_entry(file_stem + ".meta", url, response);
+
+    on_success(body.m_data, body.m_size);
+}
+
+int http_cache_t::add_validators(const std::string& url, std::vector<http_header_t>* headers) {
+    http_cache_entry_t entry;
+    if (read_entry(m_directory + "/" + url_to_file_stem(url) + ".meta", &entry) || entry.url != url) {
+        return 1;
+    }
+
+    if (!entry.etag.empty()) {
+        headers->push_back({ .name = "If-None-Match", .value = entry.etag });
+    }
+    if (!entry.last_modified.empty()) {
+        headers->push_back({ .name = "If-Modified-Since", .value = entry.last_modified });
+    }
+
+    return 0;
+}
+
+int http_cache_t::read_body(const std::string& url, mapped_file_t* body) {
+    const std::string file_stem = m_directory + "/" + url_to_file_stem(url);
+    if (body->open(file_stem + ".body")) {
+        // the next fetch gets the whole body again
+        std::cerr << "CLIENT cached body of '" << url << "' is missing" << std::endl;
+        remove((file_stem + ".meta").c_str());
+        return 1;
+    }
+
+    ++m_n_of_hits;
+    return 0;
+}
+
+int http_cache_t::store(const std::string& url, const http_response_t& response, const std::string& body) {
+    const std::string file_stem = m_directory + "/" + url_to_file_stem(url);
+    const std::string body_path = file_stem + ".body";
+    const std::string tmp_body_path = body_path + "." + std::to_string(m_n_of_tmp_files++) + ".tmp";
+    ++m_n_of_misses;
+
+    FILE* tmp_body = fopen(tmp_body_path.c_str(), "wb");
+    if (!tmp_body) {
+        return 1;
+    }
+    const bool is_written = fwrite(body.data(), 1, body.size(), tmp_body) == body.size();
+    if (fclose(tmp_body) || !is_written || rename(tmp_body_path.c_str(), body_path.c_str())) {
+        remove(tmp_body_path.c_str());
+        return 1;
+    }
+    update_entry(file_stem + ".meta", url, response);
+
+    return 0;
+}
+
+void http_cache_t::get_async(
+    const std::string& scheme, const std::string& host_name, size_t port, const std::string& path_name,
+    const std::function<void(const unsigned char* serialized_data, size_t serialized_data_size)>& on_success,
+    const std::function<void()>& on_failure,
+    task_group_t* group
+) {
+    m_pool->m_executor.submit([this, scheme, host_name, port, path_name, on_success, on_failure]() {
+        get_sync(scheme, host_name, port, path_name, on_success, on_failure);
+    }, group);
+}
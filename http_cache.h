@@ -0,0 +1,63 @@
+#ifndef HTTP_CACHE_H
+# define HTTP_CACHE_H
+
+# include <string>
+# include <vector>
+# include <functional>
+# include <atomic>
+
+# include "http.h"
+# include "mapped_file.h"
+
+/**
+ * On disk cache of GET responses for data that rarely changes (challenge config, champion jsons).
+ * The body and its validators (ETag, Last-Modified) are stored per url, later fetches send
+ * If-None-Match/If-Modified-Since and a 304 is served from the stored body, mapped into memory.
+ * Cached bodies are stored decoded.
+ *
+ * Example call:
+ * http_cache_t cache;
+ * cache.init(&pool, "http_cache");
+ * cache.get_async(
+ *   "https", "raw.communitydragon.org", 443, "latest/plugins/rcp-be-lol-game-data/global/default/v1/champions/1.json",
+ *   [](const unsigned char* serialized_data, size_t serialized_data_size) {
+ *     // data is only valid during the call ...
+ *   },
+ *   []() {
+ *     // log failure ...
+ *   }
+ * );
+*/
+struct http_cache_t {
+    int  init(http_pool_t* pool, const std::string& directory);
+
+    // same contract as http_pool_t's get_async/get_sync
+    void get_async(
+        const std::string& scheme, const std::string& host_name, size_t port, const std::string& path_name,
+        const std::function<void(const unsigned char* serialized_data, size_t serialized_data_size)>& on_success,
+        const std::function<void()>& on_failure,
+        task_group_t* group = 0
+    );
+    void get_sync(
+        const std::string& scheme, const std::string& host_name, size_t port, const std::string& path_name,
+        const std::function<void(const unsigned char* serialized_data, size_t serialized_data_size)>& on_success,
+        const std::function<void()>& on_failure
+    );
+
+    /**
+     * For requests sent through another client, e.g. riot_client_t's rate limited queue:
+     * add_validators appends the stored If-None-Match/If-Modified-Since of url to headers, returns 1 if nothing is stored for it,
+     * on a 304 read_body maps the stored body, on a 200 store keeps the body along with the response's validators.
+    */
+    int  add_validators(const std::string& url, std::vector<http_header_t>* headers);
+    int  read_body(const std::string& url, mapped_file_t* body);
+    int  store(const std::string& url, const http_response_t& response, const std::string& body);
+
+    http_pool_t*        m_pool = 0;
+    std::string         m_directory;
+    std::atomic<size_t> m_n_of_tmp_files{ 0 };
+    std::atomic<size_t> m_n_of_hits{ 0 };
+    std::atomic<size_t> m_n_of_misses{ 0 };
+};
+
+#endif // HTTP_CACHE_H
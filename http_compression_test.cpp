@@ -0,0 +1,157 @@
+#include "http_server.h"
+#include "http.h"
+
+#include <iostream>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
+#include <zlib.h>
+
+/**
+ * Serves one body from http_server_t as identity, gzip, zlib deflate and raw deflate, each framed by Content-Length and chunked,
+ * and checks that http_pool_t decodes every variant back to the body, buffered and streamed,
+ * and that its counters account the bytes on the wire and the decoded bytes of each response.
+ *
+ * Example call:
+ * ./http_compression_test
+*/
+
+struct http_compression_variant_t {
+    const char* path_name;
+    const char* content_encoding; // 0 for identity
+    int         window_bits;      // zlib's: 31 gzip, 15 zlib, -15 raw deflate
+    bool        is_chunked;
+};
+
+static const http_compression_variant_t variants[] = {
+    { "identity", 0, 0, false },
+    { "identity_chunked", 0, 0, true },
+    { "gzip", "gzip", 31, false },
+    { "gzip_chunked", "gzip", 31, true },
+    { "deflate", "deflate", 15, false },
+    { "deflate_chunked", "deflate", 15, true },
+    { "raw_deflate", "deflate", -15, false },
+    { "raw_deflate_chunked", "deflate", -15, true }
+};
+
+static int compress_body(const std::string& body, int window_bits, std::string* result) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, window_bits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return 1;
+    }
+    result->resize(deflateBound(&stream, body.size()));
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(body.data()));
+    stream.avail_in = static_cast<uInt>(body.size());
+    stream.next_out = reinterpret_cast<Bytef*>(result->data());
+    stream.avail_out = static_cast<uInt>(result->size());
+    const int deflate_result = deflate(&stream, Z_FINISH);
+    result->resize(stream.total_out);
+    deflateEnd(&stream);
+
+    return deflate_result != Z_STREAM_END;
+}
+
+// json-like and repetitive enough to compress, large enough to span many reads and chunks
+static std::string generated_body() {
+    std::string result = "[";
+    uint32_t state = 12345;
+    for (int entry = 0; entry < 4000; ++entry) {
+        state = state * 1103515245 + 12345;
+        result += (entry ? "," : "") + std::string("{\"id\":") + std::to_string(entry) + ",\"value\":" + std::to_string(state >> 8) + ",\"name\":\"entry " + std::to_string(state % 97) + "\"}";
+    }
+    result += "]";
+
+    return result;
+}
+
+int main(int argc, char** argv) {
+    (void) argv;
+    if (1 < argc) {
+        std::cerr << "usage: <http_compression_test_bin>" << std::endl;
+        return 1;
+    }
+
+    const std::string body = generated_body();
+    std::unordered_map<std::string, std::string> path_name_to_wire_body;
+    for (const http_compression_variant_t& variant : variants) {
+        std::string& wire_body = path_name_to_wire_body[variant.path_name];
+        if (!variant.content_encoding) {
+            wire_body = body;
+        } else if (compress_body(body, variant.window_bits, &wire_body)) {
+            std::cerr << "failed to compress the body for '" << variant.path_name << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    http_server_t server;
+    if (server.init(http_server_config_t(), [&path_name_to_wire_body](const http_server_request_t& request, http_response_t* response) {
+        for (const http_compression_variant_t& variant : variants) {
+            if (request.path_name != variant.path_name) {
+                continue ;
+            }
+            response->status = 200;
+            if (variant.content_encoding) {
+                response->headers.push_back({ .name = "Content-Encoding", .value = variant.content_encoding });
+            }
+            if (variant.is_chunked) {
+                response->headers.push_back({ .name = "Transfer-Encoding", .value = "chunked" });
+            }
+            response->body = path_name_to_wire_body.at(variant.path_name);
+            return ;
+        }
+        response->status = 404;
+    })) {
+        return 1;
+    }
+    http_pool_t pool;
+    if (pool.init()) {
+        return 1;
+    }
+
+    size_t n_of_failures = 0;
+    for (const http_compression_variant_t& variant : variants) {
+        const http_request_t request = {
+            .scheme = "http",
+            .host_name = "127.0.0.1",
+            .port = server.m_port,
+            .path_name = variant.path_name,
+            .headers = {}
+        };
+        const size_t wire_size = path_name_to_wire_body.at(variant.path_name).size();
+        for (int is_streamed = 0; is_streamed < 2; ++is_streamed) {
+            const size_t received_before = pool.m_stats.n_of_body_bytes_received;
+            const size_t decoded_before = pool.m_stats.n_of_body_bytes_decoded;
+            http_response_t response;
+            std::string streamed_body;
+            const int result = is_streamed ?
+                pool.request_streamed(request, &response, [&streamed_body](const char* data, size_t size) {
+                    streamed_body.append(data, size);
+                    return 0;
+                }) :
+                pool.request(request, &response);
+            const std::string& decoded_body = is_streamed ? streamed_body : response.body;
+            const size_t n_of_received = pool.m_stats.n_of_body_bytes_received - received_before;
+            const size_t n_of_decoded = pool.m_stats.n_of_body_bytes_decoded - decoded_before;
+
+            std::string failure;
+            if (result || response.status != 200) {
+                failure = "request failed with status " + std::to_string(response.status);
+            } else if (decoded_body != body) {
+                failure = "decoded " + std::to_string(decoded_body.size()) + " bytes that differ from the " + std::to_string(body.size()) + " bytes served";
+            } else if (n_of_received != wire_size) {
+                failure = "counted " + std::to_string(n_of_received) + " bytes received instead of " + std::to_string(wire_size);
+            } else if (n_of_decoded != body.size()) {
+                failure = "counted " + std::to_string(n_of_decoded) + " bytes decoded instead of " + std::to_string(body.size());
+            }
+            std::cout << variant.path_name << (is_streamed ? " streamed" : "") << ": " << wire_size << " bytes on the wire, " << (failure.empty() ? "ok" : failure) << std::endl;
+            n_of_failures += !failure.empty();
+        }
+    }
+
+    pool.destroy();
+    server.destroy();
+
+    return n_of_failures != 0;
+}
@@ -0,0 +1,427 @@
+#include "http_server.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <csignal>
+
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include <openssl/ssl.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ec.h>
+#include <openssl/x509.h>
+
+#define HTTP_SERVER_MAX_HEAD_SIZE (64 * 1024)
+#define HTTP_SERVER_READ_SIZE (16 * 1024)
+#define HTTP_SERVER_CHUNK_SIZE (4 * 1024)
+
+static std::string to_lower(std::string str) {
+    std::transform(str.begin(), str.end(), str.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+    });
+    return str;
+}
+
+static std::string trim(const std::string& str) {
+    const size_t first = str.find_first_not_of(" \t");
+    if (first == std::string::npos) {
+        return "";
+    }
+    const size_t last = str.find_last_not_of(" \t");
+    return str.substr(first, last - first + 1);
+}
+
+static const char* status_reason(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 304: return "Not Modified";
+        case 400: return "Bad Request";
+        case 401: return "Unauthorized";
+        case 403: return "Forbidden";
+        case 404: return "Not Found";
+        case 429: return "Too Many Requests";
+        case 500: return "Internal Server Error";
+        case 502: return "Bad Gateway";
+        case 503: return "Service Unavailable";
+        case 504: return "Gateway Timeout";
+        default: return "Unknown";
+    }
+}
+
+// p-256 key and a certificate for host_name signed by itself, valid for a year
+static int make_self_signed_certificate(const std::string& host_name, EVP_PKEY** key, X509** certificate) {
+    *key = 0;
+    *certificate = 0;
+
+    EVP_PKEY_CTX* key_ctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, 0);
+    if (
+        !key_ctx ||
+        EVP_PKEY_keygen_init(key_ctx) <= 0 ||
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(key_ctx, NID_X9_62_prime256v1) <= 0 ||
+        EVP_PKEY_keygen(key_ctx, key) <= 0
+    ) {
+        EVP_PKEY_CTX_free(key_ctx);
+        return 1;
+    }
+    EVP_PKEY_CTX_free(key_ctx);
+
+    *certificate = X509_new();
+    if (!*certificate) {
+        EVP_PKEY_free(*key);
+        *key = 0;
+        return 1;
+    }
+    X509_set_version(*certificate, 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(*certificate), 1);
+    X509_gmtime_adj(X509_getm_notBefore(*certificate), -60);
+    X509_gmtime_adj(X509_getm_notAfter(*certificate), 365 * 24 * 3600);
+    X509_set_pubkey(*certificate, *key);
+    X509_NAME* name = X509_get_subject_name(*certificate);
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>(host_name.c_str()), -1, -1, 0);
+    X509_set_issuer_name(*certificate, name);
+    if (X509_sign(*certificate, *key, EVP_sha256()) <= 0) {
+        X509_free(*certificate);
+        EVP_PKEY_free(*key);
+        *certificate = 0;
+        *key = 0;
+        return 1;
+    }
+
+    return 0;
+}
+
+// returns the number of bytes appended to buffer, 0 on orderly close, -1 on error
+static ssize_t read_some(SSL* ssl, int fd, std::string* buffer) {
+    char data[HTTP_SERVER_READ_SIZE];
+    ssize_t result;
+
+    if (ssl) {
+        const int n = SSL_read(ssl, data, sizeof(data));
+        if (0 < n) {
+            result = n;
+        } else {
+            result = SSL_get_error(ssl, n) == SSL_ERROR_ZERO_RETURN ? 0 : -1;
+        }
+    } else {
+        do {
+            result = recv(fd, data, sizeof(data), 0);
+        } while (result < 0 && errno == EINTR);
+    }
+
+    if (0 < result) {
+        buffer->append(data, result);
+    }
+
+    return result;
+}
+
+static int write_all(SSL* ssl, int fd, const std::string& data) {
+    size_t n_of_written = 0;
+    while (n_of_written < data.size()) {
+        ssize_t n;
+        if (ssl) {
+            n = SSL_write(ssl, data.data() + n_of_written, static_cast<int>(data.size() - n_of_written));
+        } else {
+            do {
+                n = send(fd, data.data() + n_of_written, data.size() - n_of_written, MSG_NOSIGNAL);
+            } while (n < 0 && errno == EINTR);
+        }
+        if (n <= 0) {
+            return 1;
+        }
+        n_of_written += n;
+    }
+
+    return 0;
+}
+
+// parses the head at the start of buffer, head_size past its blank line
+static int parse_head(const std::string& buffer, size_t head_size, http_server_request_t* request, bool* is_http_1_0) {
+    const size_t request_line_end = buffer.find("\r\n");
+    const std::string request_line = buffer.substr(0, request_line_end);
+    const size_t method_end = request_line.find(' ');
+    const size_t target_end = request_line.rfind(' ');
+    if (method_end == std::string::npos || target_end == method_end) {
+        return 1;
+    }
+    request->method = request_line.substr(0, method_end);
+    std::string target = request_line.substr(method_end + 1, target_end - method_end - 1);
+    if (target.empty() || target[0] != '/') {
+        return 1;
+    }
+    request->path_name = target.substr(1);
+    *is_http_1_0 = request_line.compare(target_end + 1, std::string::npos, "HTTP/1.0") == 0;
+
+    request->headers.clear();
+    size_t line_begin = request_line_end + 2;
+    while (line_begin < head_size - 2) {
+        const size_t line_end = buffer.find("\r\n", line_begin);
+        const size_t colon = buffer.find(':', line_begin);
+        if (colon == std::string::npos || line_end < colon) {
+            return 1;
+        }
+        request->headers.push_back({
+            .name = to_lower(buffer.substr(line_begin, colon - line_begin)),
+            .value = trim(buffer.substr(colon + 1, line_end - colon - 1))
+        });
+        line_begin = line_end + 2;
+    }
+
+    return 0;
+}
+
+const std::string* http_server_request_t::find_header(const std::string& lowercase_name) const {
+    for (const http_header_t& header : headers) {
+        if (header.name == lowercase_name) {
+            return &header.value;
+        }
+    }
+
+    return 0;
+}
+
+http_server_t::~http_server_t() {
+    destroy();
+}
+
+int http_server_t::init(const http_server_config_t& config, const http_handler_t& handler) {
+    m_config = config;
+    m_handler = handler;
+    // tls writes to a connection the peer has closed must fail instead of killing the process
+    signal(SIGPIPE, SIG_IGN);
+
+    if (m_config.is_tls) {
+        EVP_PKEY* key;
+        X509* certificate;
+        if (make_self_signed_certificate(m_config.host_name, &key, &certificate)) {
+            std::cerr << "CLIENT failed to generate a certificate for '" << m_config.host_name << "'" << std::endl;
+            return 1;
+        }
+        m_ssl_ctx = SSL_CTX_new(TLS_server_method());
+        const bool is_ok = m_ssl_ctx && SSL_CTX_use_certificate(m_ssl_ctx, certificate) == 1 && SSL_CTX_use_PrivateKey(m_ssl_ctx, key) == 1;
+        X509_free(certificate);
+        EVP_PKEY_free(key);
+        if (!is_ok) {
+            std::cerr << "CLIENT failed to create tls context" << std::endl;
+            destroy();
+            return 1;
+        }
+        SSL_CTX_set_min_proto_version(m_ssl_ctx, TLS1_2_VERSION);
+    }
+
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(m_config.port));
+    if (inet_pton(AF_INET, m_config.host_name.c_str(), &address.sin_addr) != 1) {
+        std::cerr << "CLIENT '" << m_config.host_name << "' is not an ipv4 address" << std::endl;
+        destroy();
+        return 1;
+    }
+    m_listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    const int reuse_address = 1;
+    if (
+        m_listen_fd < 0 ||
+        setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse_address, sizeof(reuse_address)) != 0 ||
+        bind(m_listen_fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(m_listen_fd, 128) != 0
+    ) {
+        std::cerr << "CLIENT failed to listen on '" << m_config.host_name << ":" << m_config.port << "': " << strerror(errno) << std::endl;
+        destroy();
+        return 1;
+    }
+    socklen_t address_size = sizeof(address);
+    getsockname(m_listen_fd, reinterpret_cast<sockaddr*>(&address), &address_size);
+    m_port = ntohs(address.sin_port);
+
+    m_should_stop = false;
+    m_accept_thread = std::thread([this]() {
+        accept_loop();
+    });
+
+    return 0;
+}
+
+void http_server_t::destroy() {
+    m_should_stop = true;
+    if (m_accept_thread.joinable()) {
+        m_accept_thread.join();
+    }
+    if (0 <= m_listen_fd) {
+        close(m_listen_fd);
+        m_listen_fd = -1;
+    }
+
+    {
+        // wakes the connections blocked on a read, each closes its own fd
+        std::lock_guard<std::mutex> guard(m_mutex);
+        for (int fd : m_connection_fds) {
+            shutdown(fd, SHUT_RDWR);
+        }
+    }
+    for (connection_t& connection : m_connections) {
+        connection.thread.join();
+    }
+    m_connections.clear();
+
+    if (m_ssl_ctx) {
+        SSL_CTX_free(m_ssl_ctx);
+        m_ssl_ctx = 0;
+    }
+}
+
+void http_server_t::accept_loop() {
+    while (!m_should_stop) {
+        // polled so destroy does not depend on accept waking up on a closed socket
+        pollfd poll_fd = { .fd = m_listen_fd, .events = POLLIN, .revents = 0 };
+        if (poll(&poll_fd, 1, 100) != 1) {
+            continue ;
+        }
+        const int fd = accept4(m_listen_fd, 0, 0, SOCK_CLOEXEC);
+        if (fd < 0) {
+            continue ;
+        }
+        const int no_delay = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &no_delay, sizeof(no_delay));
+        timeval io_timeout = { .tv_sec = m_config.io_timeout_ms / 1000, .tv_usec = (m_config.io_timeout_ms % 1000) * 1000 };
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &io_timeout, sizeof(io_timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &io_timeout, sizeof(io_timeout));
+        ++m_stats.n_of_connections;
+
+        std::lock_guard<std::mutex> guard(m_mutex);
+        for (auto it = m_connections.begin(); it != m_connections.end();) {
+            if (it->is_done) {
+                it->thread.join();
+                it = m_connections.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        m_connection_fds.insert(fd);
+        connection_t& connection = m_connections.emplace_back();
+        connection.thread = std::thread([this, fd, &connection]() {
+            serve(fd);
+            connection.is_done = true;
+        });
+    }
+}
+
+void http_server_t::serve(int fd) {
+    SSL* ssl = 0;
+    if (m_ssl_ctx) {
+        ssl = SSL_new(m_ssl_ctx);
+        if (!ssl || SSL_set_fd(ssl, fd) != 1 || SSL_accept(ssl) != 1) {
+            SSL_free(ssl);
+            ssl = 0;
+            ERR_clear_error();
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_connection_fds.erase(fd);
+            close(fd);
+            return ;
+        }
+    }
+
+    std::string buffer;
+    http_server_request_t request;
+    http_response_t response;
+    std::string head;
+    for (size_t n_of_requests = 0; n_of_requests < m_config.max_requests_per_connection && !m_should_stop; ++n_of_requests) {
+        size_t head_end;
+        while ((head_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+            if (HTTP_SERVER_MAX_HEAD_SIZE < buffer.size() || read_some(ssl, fd, &buffer) <= 0) {
+                head_end = std::string::npos;
+                break ;
+            }
+        }
+        bool is_http_1_0;
+        if (head_end == std::string::npos || parse_head(buffer, head_end + 4, &request, &is_http_1_0)) {
+            break ;
+        }
+        buffer.erase(0, head_end + 4);
+
+        const std::string* transfer_encoding = request.find_header("transfer-encoding");
+        if (transfer_encoding && to_lower(*transfer_encoding) != "identity") {
+            break ;
+        }
+        if (const std::string* content_length = request.find_header("content-length")) {
+            const size_t body_size = strtoull(content_length->c_str(), 0, 10);
+            while (buffer.size() < body_size) {
+                if (read_some(ssl, fd, &buffer) <= 0) {
+                    break ;
+                }
+            }
+            if (buffer.size() < body_size) {
+                break ;
+            }
+            buffer.erase(0, body_size);
+        }
+        ++m_stats.n_of_requests;
+
+        response.status = 0;
+        response.headers.clear();
+        response.body.clear();
+        m_handler(request, &response);
+        if (response.status == 0) {
+            break ;
+        }
+
+        const std::string* connection_header = request.find_header("connection");
+        const bool is_last = is_http_1_0 || n_of_requests + 1 == m_config.max_requests_per_connection || (connection_header && to_lower(*connection_header) == "close");
+        head = "HTTP/1.1 " + std::to_string(response.status) + " " + status_reason(response.status) + "\r\n";
+        // handlers name their headers as they are sent, not lowercase
+        bool is_chunked = false;
+        for (const http_header_t& header : response.headers) {
+            head += header.name + ": " + header.value + "\r\n";
+            is_chunked = is_chunked || (to_lower(header.name) == "transfer-encoding" && to_lower(header.value) == "chunked");
+        }
+        if (!is_chunked) {
+            head += "Content-Length: " + std::to_string(response.body.size()) + "\r\n";
+        }
+        head += is_last ? "Connection: close\r\n\r\n" : "Connection: keep-alive\r\n\r\n";
+        if (is_chunked) {
+            char chunk_size[32];
+            for (size_t offset = 0; offset < response.body.size(); offset += HTTP_SERVER_CHUNK_SIZE) {
+                const size_t size = std::min<size_t>(HTTP_SERVER_CHUNK_SIZE, response.body.size() - offset);
+                snprintf(chunk_size, sizeof(chunk_size), "%zx\r\n", size);
+                head += chunk_size;
+                head.append(response.body, offset, size);
+                head += "\r\n";
+            }
+            head += "0\r\n\r\n";
+            if (write_all(ssl, fd, head)) {
+                break ;
+            }
+        } else if (response.body.size() <= HTTP_SERVER_READ_SIZE) {
+            // one write for small responses, no delayed ack between head and body
+            head += response.body;
+            if (write_all(ssl, fd, head)) {
+                break ;
+            }
+        } else if (write_all(ssl, fd, head) || write_all(ssl, fd, response.body)) {
+            break ;
+        }
+        m_stats.n_of_body_bytes_sent += response.body.size();
+        if (is_last) {
+            break ;
+        }
+    }
+
+    if (ssl) {
+        SSL_shutdown(ssl);
+        SSL_free(ssl);
+    }
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_connection_fds.erase(fd);
+    close(fd);
+}
@@ -0,0 +1,96 @@
+#ifndef HTTP_SERVER_H
+# define HTTP_SERVER_H
+
+# include <string>
+# include <vector>
+# include <list>
+# include <functional>
+# include <unordered_set>
+# include <mutex>
+# include <thread>
+# include <atomic>
+
+# include "http.h"
+
+struct ssl_ctx_st;
+
+struct http_server_request_t {
+    std::string                method;
+    std::string                path_name; // without the leading '/', query included
+    std::vector<http_header_t> headers;   // lowercase names
+
+    const std::string* find_header(const std::string& lowercase_name) const;
+};
+
+struct http_server_config_t {
+    std::string host_name = "127.0.0.1";
+    // 0 for any free port, see http_server_t::m_port
+    size_t      port = 0;
+    // serves https with a self signed certificate generated at init, clients must not verify the peer
+    bool        is_tls = false;
+    size_t      max_requests_per_connection = 1000;
+    int         io_timeout_ms = 15000;
+};
+
+struct http_server_stats_t {
+    std::atomic<size_t> n_of_connections{ 0 };
+    std::atomic<size_t> n_of_requests{ 0 };
+    std::atomic<size_t> n_of_body_bytes_sent{ 0 };
+};
+
+/**
+ * Fills in the response to a request, called concurrently from the connections' threads.
+ * A status of 0 closes the connection without answering, as a server that went away would.
+ * A 'Transfer-Encoding: chunked' header sends the body in chunks instead of with a Content-Length.
+*/
+using http_handler_t = std::function<void(const http_server_request_t& request, http_response_t* response)>;
+
+/**
+ * Minimal HTTP/1.1 server for local tools and benchmarks, one thread per connection, keep-alive, Content-Length or chunked framed responses.
+ * Request bodies are skipped, chunked requests are refused.
+ *
+ * Example call:
+ * http_server_t server;
+ * http_server_config_t config;
+ * config.port = 2999;
+ * server.init(config, [](const http_server_request_t& request, http_response_t* response) {
+ *   response->status = 200;
+ *   response->body = "{}";
+ * });
+ * // serve until done ...
+ * server.destroy();
+*/
+struct http_server_t {
+    http_server_t() = default;
+    http_server_t(const http_server_t&) = delete;
+    http_server_t& operator=(const http_server_t&) = delete;
+    ~http_server_t();
+
+    int  init(const http_server_config_t& config, const http_handler_t& handler);
+    // closes the listening socket and every open connection, waits for the handlers running to return
+    void destroy();
+
+    void accept_loop();
+    void serve(int fd);
+
+    struct connection_t {
+        std::thread       thread;
+        std::atomic<bool> is_done{ false };
+    };
+
+    http_server_config_t    m_config;
+    http_handler_t          m_handler;
+    http_server_stats_t     m_stats;
+    int                     m_listen_fd = -1;
+    // the bound port, the configured one or the one picked by the system
+    size_t                  m_port = 0;
+    ssl_ctx_st*             m_ssl_ctx = 0;
+    std::atomic<bool>       m_should_stop{ false };
+    std::thread             m_accept_thread;
+
+    std::mutex              m_mutex;
+    std::list<connection_t> m_connections;
+    std::unordered_set<int> m_connection_fds;
+};
+
+#endif // HTTP_SERVER_H
@@ -0,0 +1,125 @@
+#include "leaderboard.h"
+
+#include <algorithm>
+#include <cassert>
+
+void leaderboard_t::set_baseline(const std::string& puuid, const std::vector<float>& values) {
+    m_puuid_to_baseline[puuid] = values;
+}
+
+void leaderboard_t::build(const challenge_catalog_t& catalog, const std::vector<account_t>& accounts) {
+    m_n_of_accounts = accounts.size();
+    m_n_of_slots = catalog.m_challenges.size();
+    const size_t n = m_n_of_accounts * m_n_of_slots;
+
+    m_slot_to_category.resize(m_n_of_slots);
+    m_values.resize(n);
+    m_next_values.resize(n);
+    m_floor_values.resize(n);
+    m_baselines.resize(n);
+    m_closeness.resize(n);
+    m_gains.resize(n);
+    m_progress.resize(n);
+
+    std::vector<float> inv_max_thresholds(m_n_of_slots);
+    for (size_t slot = 0; slot < m_n_of_slots; ++slot) {
+        const challenge_t& challenge = catalog.m_challenges[slot];
+        m_slot_to_category[slot] = challenge.category;
+        inv_max_thresholds[slot] = challenge.thresholds.empty() || challenge.thresholds.back() <= 0.0 ? 0.0f : static_cast<float>(1.0 / challenge.thresholds.back());
+    }
+
+    // transpose the per-account rows into slot-major columns
+    for (size_t account_index = 0; account_index < m_n_of_accounts; ++account_index) {
+        const account_t& account = accounts[account_index];
+        assert(account.m_progress.size() == m_n_of_slots);
+
+        auto baseline_it = m_puuid_to_baseline.find(account.m_puuid);
+        if (baseline_it == m_puuid_to_baseline.end() || baseline_it->second.size() != m_n_of_slots) {
+            std::vector<float> baseline(m_n_of_slots);
+            for (size_t slot = 0; slot < m_n_of_slots; ++slot) {
+                baseline[slot] = static_cast<float>(account.m_progress[slot].value);
+            }
+            baseline_it = m_puuid_to_baseline.insert_or_assign(account.m_puuid, std::move(baseline)).first;
+        }
+        const std::vector<float>& baseline = baseline_it->second;
+
+        for (size_t slot = 0; slot < m_n_of_slots; ++slot) {
+            const double value = account.m_progress[slot].value;
+            const size_t column_index = slot * m_n_of_accounts + account_index;
+            m_values[column_index] = static_cast<float>(value);
+            const challenge_t& challenge = catalog.m_challenges[slot];
+            const double next_value = challenge_next_value(challenge, value);
+            // the threshold right below the next one, 0 before the first tier
+            auto next_it = std::lower_bound(challenge.thresholds.begin(), challenge.thresholds.end(), next_value);
+            m_next_values[column_index] = static_cast<float>(next_value);
+            m_floor_values[column_index] = next_it == challenge.thresholds.begin() ? 0.0f : static_cast<float>(*(next_it - 1));
+            m_baselines[column_index] = baseline[slot];
+        }
+    }
+
+    // branchless passes over contiguous columns, these vectorize
+    const float* values = m_values.data();
+    const float* next_values = m_next_values.data();
+    const float* floor_values = m_floor_values.data();
+    const float* baselines = m_baselines.data();
+    float* closeness = m_closeness.data();
+    float* gains = m_gains.data();
+    for (size_t i = 0; i < n; ++i) {
+        const float next_value = next_values[i];
+        const float floor_value = std::min(floor_values[i], values[i]);
+        closeness[i] = values[i] < next_value ? (values[i] - floor_value) / (next_value - floor_value) : -1.0f;
+        gains[i] = values[i] - baselines[i];
+    }
+    for (size_t slot = 0; slot < m_n_of_slots; ++slot) {
+        const float inv_max_threshold = inv_max_thresholds[slot];
+        const float* slot_values = values + slot * m_n_of_accounts;
+        float* slot_progress = m_progress.data() + slot * m_n_of_accounts;
+        for (size_t account_index = 0; account_index < m_n_of_accounts; ++account_index) {
+            slot_progress[account_index] = std::min(slot_values[account_index] * inv_max_threshold, 1.0f);
+        }
+    }
+}
+
+static void top_k(const float* column, size_t n, size_t k, std::vector<leaderboard_entry_t>* result) {
+    result->clear();
+    for (size_t account_index = 0; account_index < n; ++account_index) {
+        if (0.0f < column[account_index]) {
+            result->push_back({ .account = static_cast<uint32_t>(account_index), .score = column[account_index] });
+        }
+    }
+
+    k = std::min(k, result->size());
+    std::partial_sort(result->begin(), result->begin() + k, result->end(), [](const leaderboard_entry_t& a, const leaderboard_entry_t& b) {
+        return b.score < a.score;
+    });
+    result->resize(k);
+}
+
+void leaderboard_t::top_k_closest_to_next_tier(uint32_t slot, size_t k, std::vector<leaderboard_entry_t>* result) const {
+    assert(slot < m_n_of_slots);
+    top_k(m_closeness.data() + slot * m_n_of_accounts, m_n_of_accounts, k, result);
+}
+
+void leaderboard_t::top_k_gain(uint32_t slot, size_t k, std::vector<leaderboard_entry_t>* result) const {
+    assert(slot < m_n_of_slots);
+    top_k(m_gains.data() + slot * m_n_of_accounts, m_n_of_accounts, k, result);
+}
+
+void leaderboard_t::category_sums(const std::vector<float>& weights, std::vector<float>* result) const {
+    assert(weights.empty() || weights.size() == m_n_of_slots);
+
+    result->assign(_CATEGORY_SIZE * m_n_of_accounts, 0.0f);
+    for (size_t slot = 0; slot < m_n_of_slots; ++slot) {
+        const int category = m_slot_to_category[slot];
+        if (category < 0) {
+            continue ;
+        }
+
+        const float weight = weights.empty() ? 1.0f : weights[slot];
+        const float* slot_progress = m_progress.data() + slot * m_n_of_accounts;
+        float* sums = result->data() + category * m_n_of_accounts;
+        for (size_t account_index = 0; account_index < m_n_of_accounts; ++account_index) {
+            sums[account_index] += weight * slot_progress[account_index];
+        }
+    }
+}
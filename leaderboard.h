@@ -0,0 +1,52 @@
+#ifndef LEADERBOARD_H
+# define LEADERBOARD_H
+
+# include "challenges.h"
+
+# include <string>
+# include <vector>
+# include <unordered_map>
+# include <cstdint>
+
+struct leaderboard_entry_t {
+    uint32_t account; // index into the accounts the leaderboard was built from
+    float    score;
+};
+
+/**
+ * Columnar view over the tracked accounts, every column is slot-major:
+ * column[slot * m_n_of_accounts + account], so per-challenge queries and
+ * per-slot accumulations scan contiguous floats.
+*/
+struct leaderboard_t {
+    // rebuilds every column, meant to be called on each refresh
+    void build(const challenge_catalog_t& catalog, const std::vector<account_t>& accounts);
+
+    // values the gain is measured against, accounts without a baseline get their current values as baseline on the next build
+    void set_baseline(const std::string& puuid, const std::vector<float>& values);
+
+    // share of the way from the current tier's threshold to the next one, accounts that already reached the last threshold are left out
+    void top_k_closest_to_next_tier(uint32_t slot, size_t k, std::vector<leaderboard_entry_t>* result) const;
+    void top_k_gain(uint32_t slot, size_t k, std::vector<leaderboard_entry_t>* result) const;
+
+    /**
+     * weights: one per slot, empty weights weighs every challenge as 1
+     * result[category * m_n_of_accounts + account] = sum(weights[slot] * value[slot] / max_threshold[slot]) over the slots of the category
+    */
+    void category_sums(const std::vector<float>& weights, std::vector<float>* result) const;
+
+    size_t                m_n_of_accounts;
+    size_t                m_n_of_slots;
+    std::vector<int8_t>   m_slot_to_category;
+    std::vector<float>    m_values;
+    std::vector<float>    m_next_values;
+    std::vector<float>    m_floor_values; // threshold of the current tier, 0 below the first
+    std::vector<float>    m_baselines;
+    std::vector<float>    m_closeness;
+    std::vector<float>    m_gains;
+    std::vector<float>    m_progress; // value / max threshold, clamped to [0, 1]
+
+    std::unordered_map<std::string, std::vector<float>> m_puuid_to_baseline;
+};
+
+#endif // LEADERBOARD_H
@@ -0,0 +1,367 @@
+#include "live_client.h"
+
+#include <iostream>
+#include <chrono>
+#include <string_view>
+#include <charconv>
+
+const live_player_t* live_state_t::active_player() const {
+    for (const live_player_t& player : players) {
+        if (player.riot_id == active_riot_id) {
+            return &player;
+        }
+    }
+
+    return 0;
+}
+
+void live_state_apply(live_state_t* state, const live_change_t& change) {
+    live_player_t* player = 0;
+    if (LIVE_FIELD_PLAYER_RIOT_ID <= change.field && change.field <= LIVE_FIELD_PLAYER_IS_DEAD) {
+        if (change.index < 0) {
+            return ;
+        }
+        if (state->players.size() <= static_cast<size_t>(change.index)) {
+            state->players.resize(change.index + 1);
+        }
+        player = &state->players[change.index];
+    }
+
+    switch (change.field) {
+    case LIVE_FIELD_RESET: *state = live_state_t(); break ;
+    case LIVE_FIELD_GAME_TIME: state->game_time = change.value; break ;
+    case LIVE_FIELD_GAME_MODE: state->game_mode = change.text; break ;
+    case LIVE_FIELD_ACTIVE_RIOT_ID: state->active_riot_id = change.text; break ;
+    case LIVE_FIELD_ACTIVE_LEVEL: state->active_level = static_cast<int>(change.value); break ;
+    case LIVE_FIELD_ACTIVE_GOLD: state->active_gold = change.value; break ;
+    case LIVE_FIELD_PLAYER_RIOT_ID: player->riot_id = change.text; break ;
+    case LIVE_FIELD_PLAYER_CHAMPION_NAME: player->champion_name = change.text; break ;
+    case LIVE_FIELD_PLAYER_TEAM: player->team = change.text; break ;
+    case LIVE_FIELD_PLAYER_POSITION: player->position = change.text; break ;
+    case LIVE_FIELD_PLAYER_LEVEL: player->level = static_cast<int>(change.value); break ;
+    case LIVE_FIELD_PLAYER_KILLS: player->kills = static_cast<int>(change.value); break ;
+    case LIVE_FIELD_PLAYER_DEATHS: player->deaths = static_cast<int>(change.value); break ;
+    case LIVE_FIELD_PLAYER_ASSISTS: player->assists = static_cast<int>(change.value); break ;
+    case LIVE_FIELD_PLAYER_CREEP_SCORE: player->creep_score = static_cast<int>(change.value); break ;
+    case LIVE_FIELD_PLAYER_WARD_SCORE: player->ward_score = change.value; break ;
+    case LIVE_FIELD_PLAYER_IS_DEAD: player->is_dead = change.value != 0.0; break ;
+    case LIVE_FIELD_EVENT: {
+        if (change.index < 0) {
+            break ;
+        }
+        if (state->events.size() <= static_cast<size_t>(change.index)) {
+            state->events.resize(change.index + 1);
+        }
+        state->events[change.index] = { .id = change.index, .name = change.text, .time = change.value };
+    } break ;
+    default: break ;
+    }
+}
+
+template <typename value_t>
+static void set_field(live_field_t field, int index, value_t* target, value_t value, std::vector<live_change_t>* changes) {
+    if (*target == value) {
+        return ;
+    }
+    *target = value;
+    changes->push_back({ .field = field, .index = index, .value = static_cast<double>(value), .text = std::string() });
+}
+
+static void set_field(live_field_t field, int index, std::string* target, const std::string& value, std::vector<live_change_t>* changes) {
+    if (*target == value) {
+        return ;
+    }
+    *target = value;
+    changes->push_back({ .field = field, .index = index, .value = 0.0, .text = value });
+}
+
+static int parse_number(std::string_view value, double* result) {
+    const std::from_chars_result parsed = std::from_chars(value.data(), value.data() + value.size(), *result);
+    return parsed.ec != std::errc() || parsed.ptr != value.data() + value.size();
+}
+
+static int parse_int(std::string_view value, int* result) {
+    double number;
+    if (parse_number(value, &number)) {
+        return 1;
+    }
+    *result = static_cast<int>(number);
+    return 0;
+}
+
+static int parse_string(std::string_view value, std::string* result) {
+    if (value.size() < 2 || value.front() != '"' || value.back() != '"') {
+        return 1;
+    }
+    if (value.find('\\') == std::string_view::npos) {
+        result->assign(value.data() + 1, value.size() - 2);
+        return 0;
+    }
+    try {
+        *result = nlohmann::json::parse(value.begin(), value.end()).get<std::string>();
+    } catch (std::exception&) {
+        return 1;
+    }
+    return 0;
+}
+
+// "allPlayers/3/scores" -> "allPlayers", "3", "scores", returns the number of components
+static size_t split_path(std::string_view path, std::string_view* components, size_t max_components) {
+    size_t n = 0;
+    while (n < max_components) {
+        const size_t slash = path.find('/');
+        components[n++] = path.substr(0, slash);
+        if (slash == std::string_view::npos) {
+            break ;
+        }
+        path.remove_prefix(slash + 1);
+    }
+    return n;
+}
+
+// -1 if component is not an array index
+static int parse_index(std::string_view component) {
+    int result = -1;
+    const std::from_chars_result parsed = std::from_chars(component.data(), component.data() + component.size(), result);
+    return parsed.ec == std::errc() && parsed.ptr == component.data() + component.size() ? result : -1;
+}
+
+int live_client_t::extract_deltas() {
+    std::string text;
+    for (const live_delta_t& delta : m_deltas) {
+        std::string_view components[4];
+        const size_t n_of_components = split_path(delta.path, components, 4);
+        int result = 0;
+        bool is_extracted = true;
+
+        if (n_of_components == 2 && components[0] == "gameData") {
+            if (components[1] == "gameTime") {
+                double game_time = 0.0;
+                result = parse_number(delta.value, &game_time);
+                set_field(LIVE_FIELD_GAME_TIME, 0, &m_state.game_time, game_time, &m_scratch_changes);
+            } else if (components[1] == "gameMode") {
+                result = parse_string(delta.value, &text);
+                set_field(LIVE_FIELD_GAME_MODE, 0, &m_state.game_mode, text, &m_scratch_changes);
+            } else {
+                is_extracted = false;
+            }
+        } else if (n_of_components == 2 && components[0] == "activePlayer") {
+            if (components[1] == "riotId") {
+                result = parse_string(delta.value, &text);
+                set_field(LIVE_FIELD_ACTIVE_RIOT_ID, 0, &m_state.active_riot_id, text, &m_scratch_changes);
+            } else if (components[1] == "level") {
+                int level = 0;
+                result = parse_int(delta.value, &level);
+                set_field(LIVE_FIELD_ACTIVE_LEVEL, 0, &m_state.active_level, level, &m_scratch_changes);
+            } else if (components[1] == "currentGold") {
+                double gold = 0.0;
+                result = parse_number(delta.value, &gold);
+                set_field(LIVE_FIELD_ACTIVE_GOLD, 0, &m_state.active_gold, gold, &m_scratch_changes);
+            } else {
+                is_extracted = false;
+            }
+        } else if (n_of_components == 3 && components[0] == "allPlayers" && 0 <= parse_index(components[1])) {
+            const int index = parse_index(components[1]);
+            if (m_state.players.size() <= static_cast<size_t>(index)) {
+                m_state.players.resize(index + 1);
+            }
+            live_player_t& player = m_state.players[index];
+            if (components[2] == "riotId") {
+                result = parse_string(delta.value, &text);
+                set_field(LIVE_FIELD_PLAYER_RIOT_ID, index, &player.riot_id, text, &m_scratch_changes);
+            } else if (components[2] == "championName") {
+                result = parse_string(delta.value, &text);
+                set_field(LIVE_FIELD_PLAYER_CHAMPION_NAME, index, &player.champion_name, text, &m_scratch_changes);
+            } else if (components[2] == "team") {
+                result = parse_string(delta.value, &text);
+                set_field(LIVE_FIELD_PLAYER_TEAM, index, &player.team, text, &m_scratch_changes);
+            } else if (components[2] == "position") {
+                result = parse_string(delta.value, &text);
+                set_field(LIVE_FIELD_PLAYER_POSITION, index, &player.position, text, &m_scratch_changes);
+            } else if (components[2] == "level") {
+                int level = 0;
+                result = parse_int(delta.value, &level);
+                set_field(LIVE_FIELD_PLAYER_LEVEL, index, &player.level, level, &m_scratch_changes);
+            } else if (components[2] == "isDead") {
+                set_field(LIVE_FIELD_PLAYER_IS_DEAD, index, &player.is_dead, delta.value == "true", &m_scratch_changes);
+            } else if (components[2] == "scores") {
+                try {
+                    const nlohmann::json scores = nlohmann::json::parse(delta.value.begin(), delta.value.end());
+                    set_field(LIVE_FIELD_PLAYER_KILLS, index, &player.kills, scores.value("kills", 0), &m_scratch_changes);
+                    set_field(LIVE_FIELD_PLAYER_DEATHS, index, &player.deaths, scores.value("deaths", 0), &m_scratch_changes);
+                    set_field(LIVE_FIELD_PLAYER_ASSISTS, index, &player.assists, scores.value("assists", 0), &m_scratch_changes);
+                    set_field(LIVE_FIELD_PLAYER_CREEP_SCORE, index, &player.creep_score, scores.value("creepScore", 0), &m_scratch_changes);
+                    set_field(LIVE_FIELD_PLAYER_WARD_SCORE, index, &player.ward_score, scores.value("wardScore", 0.0), &m_scratch_changes);
+                } catch (std::exception&) {
+                    result = 1;
+                }
+            } else {
+                is_extracted = false;
+            }
+        } else if (n_of_components == 3 && components[0] == "events" && components[1] == "Events" && 0 <= parse_index(components[2])) {
+            const int index = parse_index(components[2]);
+            try {
+                const nlohmann::json event = nlohmann::json::parse(delta.value.begin(), delta.value.end());
+                if (m_state.events.size() <= static_cast<size_t>(index)) {
+                    m_state.events.resize(index + 1);
+                }
+                m_state.events[index] = { .id = event.value("EventID", index), .name = event.value("EventName", std::string()), .time = event.value("EventTime", 0.0) };
+                m_scratch_changes.push_back({ .field = LIVE_FIELD_EVENT, .index = index, .value = m_state.events[index].time, .text = m_state.events[index].name });
+            } catch (std::exception&) {
+                result = 1;
+            }
+        } else {
+            is_extracted = false;
+        }
+
+        if (result) {
+            std::cerr << "CLIENT failed to decode live client '" << delta.path << "'" << std::endl;
+            return 1;
+        }
+        if (is_extracted) {
+            ++m_stats.n_of_extracted_deltas;
+            m_stats.n_of_parsed_bytes += delta.value.size();
+        }
+    }
+
+    return 0;
+}
+
+live_client_t::~live_client_t() {
+    destroy();
+}
+
+int live_client_t::init(const live_client_config_t& config) {
+    m_config = config;
+
+    http_pool_config_t http_pool_config;
+    // one connection kept alive for the whole session, the game's certificate is self signed
+    http_pool_config.max_idle_connections_per_host = 1;
+    http_pool_config.max_concurrent_requests = 1;
+    http_pool_config.is_peer_verified = false;
+    http_pool_config.is_compression_requested = false;
+    http_pool_config.connect_timeout_ms = 500;
+    http_pool_config.io_timeout_ms = 2000;
+    if (m_http_pool.init(http_pool_config)) {
+        return 1;
+    }
+    if (!m_config.record_path.empty() && m_recorder.open(m_config.record_path)) {
+        std::cerr << "CLIENT live games are not recorded this session" << std::endl;
+    }
+
+    m_should_stop = false;
+    if (m_config.is_polled_by_caller) {
+        return 0;
+    }
+    m_thread = std::thread([this]() {
+        poll_loop();
+    });
+
+    return 0;
+}
+
+void live_client_t::destroy() {
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_should_stop = true;
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_http_pool.destroy();
+    m_recorder.close();
+}
+
+void live_client_t::take_changes(std::vector<live_change_t>* changes) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    changes->clear();
+    changes->swap(m_changes);
+}
+
+void live_client_t::poll_loop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (!m_should_stop) {
+        lock.unlock();
+        const auto poll_start = std::chrono::steady_clock::now();
+        const int interval_ms = poll() == 0 ? m_config.poll_interval_ms : m_config.idle_poll_interval_ms;
+        lock.lock();
+
+        // the interval counts from the start of the poll so the rate holds however long the request took
+        m_cv.wait_until(lock, poll_start + std::chrono::milliseconds(interval_ms), [this]() {
+            return m_should_stop;
+        });
+    }
+}
+
+int live_client_t::decode(const std::string& payload) {
+    m_stats.n_of_payload_bytes += payload.size();
+
+    // a payload that fails halfway leaves the hashes and the state half updated, both start over
+    auto fail = [this]() {
+        m_delta_encoder.reset();
+        m_state = live_state_t();
+        m_scratch_changes.clear();
+        return 1;
+    };
+    const double previous_game_time = m_state.game_time;
+    m_scratch_changes.clear();
+    if (m_delta_encoder.encode(payload, &m_deltas) || extract_deltas()) {
+        return fail();
+    }
+    // game time only moves forward within a game, a new one is decoded again from scratch
+    if (m_is_in_game && m_state.game_time < previous_game_time) {
+        m_delta_encoder.reset();
+        m_state = live_state_t();
+        m_scratch_changes.clear();
+        m_scratch_changes.push_back({ .field = LIVE_FIELD_RESET, .index = 0, .value = 0.0, .text = std::string() });
+        if (m_delta_encoder.encode(payload, &m_deltas) || extract_deltas()) {
+            return fail();
+        }
+    }
+    m_stats.n_of_deltas += m_deltas.size();
+    m_is_in_game = true;
+
+    return 0;
+}
+
+int live_client_t::poll() {
+    const auto start = std::chrono::steady_clock::now();
+    ++m_stats.n_of_polls;
+
+    const http_request_t request = {
+        .scheme = m_config.scheme,
+        .host_name = m_config.host_name,
+        .port = m_config.port,
+        .path_name = LIVE_CLIENT_ALLGAMEDATA_PATH,
+        .headers = {}
+    };
+    // the client answers 404 while the game is loading
+    const bool is_received = m_http_pool.request(request, &m_response) == 0;
+    if (!m_config.record_path.empty()) {
+        m_recorder.record(request.path_name, is_received ? m_response.status : 0, is_received ? m_response.body : std::string());
+    }
+    const bool is_ok = is_received && m_response.status == 200 && decode(m_response.body) == 0;
+    if (!is_ok) {
+        ++m_stats.n_of_failed_polls;
+        if (!m_is_in_game) {
+            return 1;
+        }
+        m_delta_encoder.reset();
+        m_state = live_state_t();
+        m_is_in_game = false;
+        m_scratch_changes.clear();
+        m_scratch_changes.push_back({ .field = LIVE_FIELD_RESET, .index = 0, .value = 0.0, .text = std::string() });
+    }
+
+    if (!m_scratch_changes.empty()) {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_changes.insert(m_changes.end(), std::make_move_iterator(m_scratch_changes.begin()), std::make_move_iterator(m_scratch_changes.end()));
+        m_stats.n_of_changes += m_scratch_changes.size();
+    }
+    m_scratch_changes.clear();
+    m_stats.last_poll_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    return is_ok ? 0 : 1;
+}
@@ -0,0 +1,171 @@
+#ifndef LIVE_CLIENT_H
+# define LIVE_CLIENT_H
+
+# include <string>
+# include <vector>
+# include <mutex>
+# include <condition_variable>
+# include <thread>
+# include <atomic>
+# include <cstdint>
+
+# include "json.hpp"
+# include "http.h"
+# include "live_delta.h"
+# include "live_recording.h"
+
+// what the game client serves while a match runs, its certificate is self signed
+# define LIVE_CLIENT_HOST_NAME "127.0.0.1"
+# define LIVE_CLIENT_PORT 2999
+# define LIVE_CLIENT_ALLGAMEDATA_PATH "liveclientdata/allgamedata"
+
+struct live_player_t {
+    std::string riot_id;
+    std::string champion_name;
+    std::string team;      // "ORDER" or "CHAOS"
+    std::string position;  // "TOP", "JUNGLE" ... empty outside of matchmade games
+    int         level = 0;
+    int         kills = 0;
+    int         deaths = 0;
+    int         assists = 0;
+    int         creep_score = 0;
+    double      ward_score = 0.0;
+    bool        is_dead = false;
+};
+
+struct live_event_t {
+    int         id;
+    std::string name;  // "ChampionKill", "DragonKill" ...
+    double      time;  // game seconds
+};
+
+/**
+ * Typed view of the fields of an allgamedata payload the tracker reads.
+*/
+struct live_state_t {
+    double                     game_time = 0.0;
+    std::string                game_mode;
+    std::string                active_riot_id;
+    int                        active_level = 0;
+    double                     active_gold = 0.0;
+    std::vector<live_player_t> players;
+    std::vector<live_event_t>  events;
+
+    // the active player's entry of players, 0 while unknown
+    const live_player_t* active_player() const;
+};
+
+enum live_field_t {
+    LIVE_FIELD_RESET,               // the game ended or a new one started, the state is back to empty
+    LIVE_FIELD_GAME_TIME,
+    LIVE_FIELD_GAME_MODE,
+    LIVE_FIELD_ACTIVE_RIOT_ID,
+    LIVE_FIELD_ACTIVE_LEVEL,
+    LIVE_FIELD_ACTIVE_GOLD,
+    LIVE_FIELD_PLAYER_RIOT_ID,
+    LIVE_FIELD_PLAYER_CHAMPION_NAME,
+    LIVE_FIELD_PLAYER_TEAM,
+    LIVE_FIELD_PLAYER_POSITION,
+    LIVE_FIELD_PLAYER_LEVEL,
+    LIVE_FIELD_PLAYER_KILLS,
+    LIVE_FIELD_PLAYER_DEATHS,
+    LIVE_FIELD_PLAYER_ASSISTS,
+    LIVE_FIELD_PLAYER_CREEP_SCORE,
+    LIVE_FIELD_PLAYER_WARD_SCORE,
+    LIVE_FIELD_PLAYER_IS_DEAD,
+    LIVE_FIELD_EVENT,               // index is the position in events, which is the game client's event id, value its time
+
+    _LIVE_FIELD_SIZE
+};
+
+struct live_change_t {
+    live_field_t field;
+    int          index; // player index for the player fields, position in events for events
+    double       value;
+    std::string  text;  // for the string fields and event names
+};
+
+void live_state_apply(live_state_t* state, const live_change_t& change);
+
+struct live_client_config_t {
+    std::string scheme = "https";
+    std::string host_name = LIVE_CLIENT_HOST_NAME;
+    size_t      port = LIVE_CLIENT_PORT;
+    // while a game runs, 250 to 500 for 4 to 2 Hz
+    int         poll_interval_ms = 333;
+    // while no game runs
+    int         idle_poll_interval_ms = 2000;
+    // every response, or its absence, is appended to this live recording, empty to not record
+    std::string record_path;
+    // no poll thread is started, the caller calls poll() itself, for benchmarks
+    bool        is_polled_by_caller = false;
+};
+
+struct live_client_stats_t {
+    std::atomic<size_t>   n_of_polls{ 0 };
+    std::atomic<size_t>   n_of_failed_polls{ 0 };
+    std::atomic<size_t>   n_of_changes{ 0 };
+    // changed subtrees, and those of them the live state reads and parsed
+    std::atomic<size_t>   n_of_deltas{ 0 };
+    std::atomic<size_t>   n_of_extracted_deltas{ 0 };
+    std::atomic<size_t>   n_of_payload_bytes{ 0 };
+    std::atomic<size_t>   n_of_parsed_bytes{ 0 };
+    // request through extraction of the last poll
+    std::atomic<uint64_t> last_poll_us{ 0 };
+};
+
+/**
+ * Polls the game client's allgamedata endpoint on a thread of its own over one keep-alive connection.
+ * The payload goes through a live_delta_encoder_t, only the subtrees whose bytes differ from the previous poll are parsed,
+ * e.g. "gameData/gameTime" and one player's "scores" while abilities, runes and items are skipped unread.
+ * Each parsed field that moved is queued as a change for the ui.
+ *
+ * Example call:
+ * live_client_t live_client;
+ * live_client.init(live_client_config_t());
+ * // every frame
+ * std::vector<live_change_t> changes;
+ * live_client.take_changes(&changes);
+ * for (const live_change_t& change : changes) {
+ *   live_state_apply(&ui_live_state, change);
+ * }
+*/
+struct live_client_t {
+    live_client_t() = default;
+    live_client_t(const live_client_t&) = delete;
+    live_client_t& operator=(const live_client_t&) = delete;
+    ~live_client_t();
+
+    int  init(const live_client_config_t& config);
+    void destroy();
+
+    // moves the changes queued since the last call into changes, in order
+    void take_changes(std::vector<live_change_t>* changes);
+
+    void poll_loop();
+    // returns 0 if a game is running and the payload was decoded
+    int  poll();
+    // parses the subtrees that changed into m_state and their changes into m_scratch_changes
+    // m_mutex need not be held, only the poll thread touches m_state
+    int  decode(const std::string& payload);
+    int  extract_deltas();
+
+    live_client_config_t       m_config;
+    live_client_stats_t        m_stats;
+    http_pool_t                m_http_pool;
+    live_recorder_t            m_recorder;
+    http_response_t            m_response;
+    live_state_t               m_state;
+    bool                       m_is_in_game = false;
+    live_delta_encoder_t       m_delta_encoder;
+    std::vector<live_delta_t>  m_deltas;
+    std::vector<live_change_t> m_scratch_changes;
+
+    std::mutex                 m_mutex;
+    std::condition_variable    m_cv;
+    bool                       m_should_stop = false;
+    std::vector<live_change_t> m_changes;
+    std::thread                m_thread;
+};
+
+#endif // LIVE_CLIENT_H
@@ -0,0 +1,153 @@
+#include "live_delta.h"
+
+#include <functional>
+#include <cstring>
+
+static const char* skip_whitespace(const char* cur, const char* end) {
+    while (cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\n' || *cur == '\r')) {
+        ++cur;
+    }
+    return cur;
+}
+
+// cur at the opening quote, returns past the closing one, 0 if unterminated
+static const char* skip_string(const char* cur, const char* end) {
+    ++cur;
+    while (cur < end) {
+        const char* quote = static_cast<const char*>(memchr(cur, '"', end - cur));
+        if (!quote) {
+            return 0;
+        }
+        // escaped if preceded by an odd number of backslashes
+        const char* backslash = quote;
+        while (cur < backslash && backslash[-1] == '\\') {
+            --backslash;
+        }
+        if ((quote - backslash) % 2 == 0) {
+            return quote + 1;
+        }
+        cur = quote + 1;
+    }
+    return 0;
+}
+
+// returns past the value starting at cur, 0 if it is cut off
+static const char* skip_value(const char* cur, const char* end) {
+    if (cur == end) {
+        return 0;
+    }
+    if (*cur == '"') {
+        return skip_string(cur, end);
+    }
+    if (*cur != '{' && *cur != '[') {
+        while (cur < end && *cur != ',' && *cur != '}' && *cur != ']' && *cur != ' ' && *cur != '\n' && *cur != '\r' && *cur != '\t') {
+            ++cur;
+        }
+        return cur;
+    }
+
+    int depth = 0;
+    while (cur < end) {
+        if (*cur == '"') {
+            cur = skip_string(cur, end);
+            if (!cur) {
+                return 0;
+            }
+            continue ;
+        }
+        if (*cur == '{' || *cur == '[') {
+            ++depth;
+        } else if ((*cur == '}' || *cur == ']') && --depth == 0) {
+            return cur + 1;
+        }
+        ++cur;
+    }
+    return 0;
+}
+
+void live_delta_encoder_t::reset() {
+    m_path_to_hash.clear();
+    m_path.clear();
+}
+
+int live_delta_encoder_t::encode(const std::string& payload, std::vector<live_delta_t>* deltas) {
+    deltas->clear();
+    m_path.clear();
+    ++m_stats.n_of_payloads;
+
+    const char* end = payload.data() + payload.size();
+    const char* begin = skip_whitespace(payload.data(), end);
+    const char* value_end = skip_value(begin, end);
+    if (!value_end || value_end == begin || skip_whitespace(value_end, end) != end) {
+        return 1;
+    }
+    const size_t n_of_deltas = deltas->size();
+    const int result = visit(std::string_view(begin, value_end - begin), 0, deltas);
+    m_stats.n_of_deltas += deltas->size() - n_of_deltas;
+
+    return result;
+}
+
+int live_delta_encoder_t::visit(std::string_view value, int depth, std::vector<live_delta_t>* deltas) {
+    ++m_stats.n_of_visited_subtrees;
+
+    const uint64_t hash = std::hash<std::string_view>()(value);
+    auto [hash_it, is_new] = m_path_to_hash.try_emplace(m_path, hash);
+    if (!is_new) {
+        if (hash_it->second == hash) {
+            ++m_stats.n_of_pruned_subtrees;
+            return 0;
+        }
+        hash_it->second = hash;
+    }
+
+    const bool is_object = value[0] == '{';
+    if (depth == m_max_depth || !(is_object || value[0] == '[')) {
+        deltas->push_back({ .path = m_path, .value = value });
+        return 0;
+    }
+
+    // between the brackets
+    const char* cur = skip_whitespace(value.data() + 1, value.data() + value.size() - 1);
+    const char* end = value.data() + value.size() - 1;
+    const size_t path_size = m_path.size();
+    size_t index = 0;
+    while (cur < end) {
+        if (depth != 0) {
+            m_path.push_back('/');
+        }
+        if (is_object) {
+            const char* key_end = *cur == '"' ? skip_string(cur, end) : 0;
+            if (!key_end) {
+                return 1;
+            }
+            m_path.append(cur + 1, key_end - 1);
+            cur = skip_whitespace(key_end, end);
+            if (cur == end || *cur != ':') {
+                return 1;
+            }
+            cur = skip_whitespace(cur + 1, end);
+        } else {
+            m_path += std::to_string(index++);
+        }
+
+        const char* value_end = skip_value(cur, end);
+        if (!value_end || value_end == cur) {
+            return 1;
+        }
+        if (visit(std::string_view(cur, value_end - cur), depth + 1, deltas)) {
+            return 1;
+        }
+        m_path.resize(path_size);
+
+        cur = skip_whitespace(value_end, end);
+        if (cur < end) {
+            if (*cur != ',') {
+                return 1;
+            }
+            cur = skip_whitespace(cur + 1, end);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,60 @@
+#ifndef LIVE_DELTA_H
+# define LIVE_DELTA_H
+
+# include <string>
+# include <string_view>
+# include <vector>
+# include <unordered_map>
+# include <cstdint>
+
+/**
+ * A subtree of the payload whose bytes differ from the previous payload's at the same path.
+*/
+struct live_delta_t {
+    std::string      path;  // object keys and array indices joined by '/', e.g. "allPlayers/3/scores"
+    std::string_view value; // json text of the subtree, points into the encoded payload
+};
+
+struct live_delta_stats_t {
+    size_t n_of_payloads = 0;
+    size_t n_of_visited_subtrees = 0;
+    // subtrees found unchanged by their hash, their children were not looked at
+    size_t n_of_pruned_subtrees = 0;
+    size_t n_of_deltas = 0;
+};
+
+/**
+ * Structural diff of successive json documents of the same shape, without parsing them.
+ * Every subtree down to max_depth is located by bracket matching and hashed, the hash is kept per path.
+ * A subtree whose hash did not change is pruned whole, a changed one is descended into, so the changes come out at the deepest level
+ * and the work past the hashing is proportional to what changed. Paths are only ever added or changed, a key that disappears is not reported.
+ *
+ * Example call:
+ * live_delta_encoder_t encoder;
+ * std::vector<live_delta_t> deltas;
+ * encoder.encode(payload, &deltas);
+ * for (const live_delta_t& delta : deltas) {
+ *   if (delta.path == "gameData/gameTime") {
+ *     // parse delta.value ...
+ *   }
+ * }
+*/
+struct live_delta_encoder_t {
+    // subtrees deeper than max_depth are reported as part of their ancestor at max_depth
+    explicit live_delta_encoder_t(int max_depth = 3) : m_max_depth(max_depth) {}
+
+    // returns 0 if payload is a complete json value, deltas point into payload
+    int  encode(const std::string& payload, std::vector<live_delta_t>* deltas);
+    // forgets every hash, the next payload comes out whole
+    void reset();
+
+    int  visit(std::string_view value, int depth, std::vector<live_delta_t>* deltas);
+
+    int                                       m_max_depth;
+    std::unordered_map<std::string, uint64_t> m_path_to_hash;
+    // path of the subtree being visited, grown and shrunk in place
+    std::string                               m_path;
+    live_delta_stats_t                        m_stats;
+};
+
+#endif // LIVE_DELTA_H
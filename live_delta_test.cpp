@@ -0,0 +1,255 @@
+#include "live_recording.h"
+#include "live_client.h"
+#include "http_server.h"
+
+#include <iostream>
+#include <cstdio>
+
+/**
+ * Replays a live recording through http_server_t and live_replay_t into a live_client_t, one record per poll,
+ * and checks after every payload that the state the client built from the deltas, and the ui state built from its changes,
+ * equal a parse of the whole payload from scratch.
+ * Without a recording one is generated: a game, the loading screen of the next one, and that game, with escaped names.
+ *
+ * Example call:
+ * ./live_delta_test
+ * ./live_delta_test session.ltlr
+*/
+
+#define LIVE_DELTA_TEST_RECORDING_PATH "live_delta_test.ltlr"
+
+static nlohmann::json generated_payload(int game_index, int step, nlohmann::json* events) {
+    nlohmann::json players = nlohmann::json::array();
+    for (int player_index = 0; player_index < 10; ++player_index) {
+        nlohmann::json items = nlohmann::json::array();
+        for (int slot = 0; slot < 6; ++slot) {
+            items.push_back({ { "itemID", 1000 + slot + step / 40 }, { "slot", slot }, { "displayName", "Item " + std::to_string(slot) } });
+        }
+        players.push_back({
+            { "championName", "Champ" + std::to_string(player_index + game_index * 10) },
+            { "isDead", (step + player_index) % 23 < 3 },
+            { "items", items },
+            { "level", 1 + (step + player_index) / 15 },
+            { "position", player_index % 5 == 0 ? "TOP" : "JUNGLE" },
+            { "riotId", "Player \"" + std::to_string(player_index) + "\"\\#EUW" },
+            { "scores", {
+                { "assists", (step + player_index) / 17 },
+                { "creepScore", (step * (player_index + 1)) / 7 },
+                { "deaths", (step + 3 * player_index) / 29 },
+                { "kills", (step + 5 * player_index) / 31 },
+                { "wardScore", step * 0.25 + player_index }
+            } },
+            { "team", player_index < 5 ? "ORDER" : "CHAOS" }
+        });
+    }
+    if (step % 10 == 0) {
+        events->push_back({ { "EventID", events->size() }, { "EventName", step == 0 ? "GameStart" : "ChampionKill" }, { "EventTime", step * 0.25 } });
+    }
+
+    return {
+        { "activePlayer", {
+            { "abilities", { { "Q", { { "abilityLevel", 1 + step / 50 } } } } },
+            { "currentGold", 500.0 + step * 2.5 },
+            { "level", 1 + (step + 2) / 15 },
+            { "riotId", "Player \"2\"\\#EUW" }
+        } },
+        { "allPlayers", players },
+        { "events", { { "Events", *events } } },
+        { "gameData", { { "gameMode", game_index ? "ARAM" : "CLASSIC" }, { "gameTime", step * 0.25 }, { "mapNumber", 11 } } }
+    };
+}
+
+static int generate_recording(const std::string& path) {
+    live_recorder_t recorder;
+    if (recorder.open(path)) {
+        return 1;
+    }
+    for (int game_index = 0; game_index < 2; ++game_index) {
+        nlohmann::json events = nlohmann::json::array();
+        for (int step = 0; step < 200; ++step) {
+            recorder.record(LIVE_CLIENT_ALLGAMEDATA_PATH, 200, generated_payload(game_index, step, &events).dump(4));
+        }
+        // the next game is loading, then the client was not answering at all
+        recorder.record(LIVE_CLIENT_ALLGAMEDATA_PATH, 404, std::string());
+        recorder.record(LIVE_CLIENT_ALLGAMEDATA_PATH, 0, std::string());
+    }
+    recorder.close();
+
+    return 0;
+}
+
+// the whole payload parsed into a state, without the delta encoder
+static int decode_from_scratch(const std::string& payload, live_state_t* state) {
+    try {
+        const nlohmann::json json = nlohmann::json::parse(payload);
+        const nlohmann::json& game_data = json.at("gameData");
+        state->game_time = game_data.value("gameTime", 0.0);
+        state->game_mode = game_data.value("gameMode", std::string());
+        const nlohmann::json& active_player = json.at("activePlayer");
+        state->active_riot_id = active_player.value("riotId", std::string());
+        state->active_level = active_player.value("level", 0);
+        state->active_gold = active_player.value("currentGold", 0.0);
+        for (const nlohmann::json& player_json : json.at("allPlayers")) {
+            live_player_t& player = state->players.emplace_back();
+            player.riot_id = player_json.value("riotId", std::string());
+            player.champion_name = player_json.value("championName", std::string());
+            player.team = player_json.value("team", std::string());
+            player.position = player_json.value("position", std::string());
+            player.level = player_json.value("level", 0);
+            player.is_dead = player_json.value("isDead", false);
+            const nlohmann::json scores = player_json.value("scores", nlohmann::json::object());
+            player.kills = scores.value("kills", 0);
+            player.deaths = scores.value("deaths", 0);
+            player.assists = scores.value("assists", 0);
+            player.creep_score = scores.value("creepScore", 0);
+            player.ward_score = scores.value("wardScore", 0.0);
+        }
+        const nlohmann::json& events = json.at("events").at("Events");
+        for (size_t event_index = 0; event_index < events.size(); ++event_index) {
+            state->events.push_back({
+                .id = events[event_index].value("EventID", static_cast<int>(event_index)),
+                .name = events[event_index].value("EventName", std::string()),
+                .time = events[event_index].value("EventTime", 0.0)
+            });
+        }
+    } catch (std::exception&) {
+        return 1;
+    }
+
+    return 0;
+}
+
+// empty if equal, otherwise the first field that differs
+static std::string state_difference(const live_state_t& state, const live_state_t& expected) {
+    if (state.game_time != expected.game_time) {
+        return "game time";
+    }
+    if (state.game_mode != expected.game_mode) {
+        return "game mode";
+    }
+    if (state.active_riot_id != expected.active_riot_id) {
+        return "active riot id";
+    }
+    if (state.active_level != expected.active_level) {
+        return "active level";
+    }
+    if (state.active_gold != expected.active_gold) {
+        return "active gold";
+    }
+    if (state.players.size() != expected.players.size()) {
+        return "number of players";
+    }
+    for (size_t player_index = 0; player_index < state.players.size(); ++player_index) {
+        const live_player_t& player = state.players[player_index];
+        const live_player_t& expected_player = expected.players[player_index];
+        if (
+            player.riot_id != expected_player.riot_id || player.champion_name != expected_player.champion_name ||
+            player.team != expected_player.team || player.position != expected_player.position ||
+            player.level != expected_player.level || player.kills != expected_player.kills ||
+            player.deaths != expected_player.deaths || player.assists != expected_player.assists ||
+            player.creep_score != expected_player.creep_score || player.ward_score != expected_player.ward_score ||
+            player.is_dead != expected_player.is_dead
+        ) {
+            return "player " + std::to_string(player_index);
+        }
+    }
+    if (state.events.size() != expected.events.size()) {
+        return "number of events";
+    }
+    for (size_t event_index = 0; event_index < state.events.size(); ++event_index) {
+        const live_event_t& event = state.events[event_index];
+        const live_event_t& expected_event = expected.events[event_index];
+        if (event.id != expected_event.id || event.name != expected_event.name || event.time != expected_event.time) {
+            return "event " + std::to_string(event_index);
+        }
+    }
+
+    return std::string();
+}
+
+int main(int argc, char** argv) {
+    if (2 < argc) {
+        std::cerr << "usage: <live_delta_test_bin> [recording]" << std::endl;
+        return 1;
+    }
+    const bool is_generated = argc < 2;
+    const std::string recording_path = is_generated ? LIVE_DELTA_TEST_RECORDING_PATH : argv[1];
+    if (is_generated && generate_recording(recording_path)) {
+        return 1;
+    }
+    std::vector<live_record_t> records;
+    const int read_result = live_recording_read(recording_path, &records);
+    if (is_generated) {
+        std::remove(recording_path.c_str());
+    }
+    if (read_result) {
+        return 1;
+    }
+    // the client only asks for allgamedata, the replay serves each path its own records in order
+    std::vector<live_record_t> payload_records;
+    for (const live_record_t& record : records) {
+        if (record.path_name == LIVE_CLIENT_ALLGAMEDATA_PATH) {
+            payload_records.push_back(record);
+        }
+    }
+
+    live_replay_t replay;
+    live_replay_config_t replay_config;
+    replay_config.speed = 0.0;
+    replay.init(std::move(records), replay_config);
+    http_server_t server;
+    if (server.init(http_server_config_t(), [&replay](const http_server_request_t& request, http_response_t* response) {
+        replay.handle(request, response);
+    })) {
+        return 1;
+    }
+    live_client_config_t client_config;
+    client_config.scheme = "http";
+    client_config.port = server.m_port;
+    client_config.is_polled_by_caller = true;
+    live_client_t live_client;
+    if (live_client.init(client_config)) {
+        return 1;
+    }
+
+    live_state_t ui_live_state;
+    std::vector<live_change_t> changes;
+    size_t n_of_polls = 0;
+    size_t n_of_failures = 0;
+    while (!replay.is_done()) {
+        live_client.poll();
+        live_client.take_changes(&changes);
+        for (const live_change_t& change : changes) {
+            live_state_apply(&ui_live_state, change);
+        }
+        ++n_of_polls;
+
+        // a record without a response closes the connection and the pool retries on a fresh one, so a poll can take two records
+        size_t record_index = 0;
+        {
+            std::lock_guard<std::mutex> guard(replay.m_mutex);
+            record_index = replay.m_path_to_records[LIVE_CLIENT_ALLGAMEDATA_PATH].next_step - 1;
+        }
+        const live_record_t& record = payload_records[record_index];
+        live_state_t expected;
+        if (record.status != 200 || decode_from_scratch(record.body, &expected)) {
+            expected = live_state_t();
+        }
+
+        const std::string client_difference = state_difference(live_client.m_state, expected);
+        const std::string ui_difference = state_difference(ui_live_state, expected);
+        if (!client_difference.empty() || !ui_difference.empty()) {
+            std::cerr << "record " << record_index << " (status " << record.status << "): " <<
+                (client_difference.empty() ? "" : "client state differs in " + client_difference + " ") <<
+                (ui_difference.empty() ? "" : "ui state differs in " + ui_difference) << std::endl;
+            ++n_of_failures;
+        }
+    }
+
+    const live_client_stats_t& stats = live_client.m_stats;
+    std::cout << payload_records.size() << " records, " << n_of_polls << " polls, " << stats.n_of_deltas << " deltas, " << stats.n_of_changes << " changes, " << n_of_failures << " differ from a from-scratch decode" << std::endl;
+    live_client.destroy();
+    server.destroy();
+
+    return n_of_failures != 0;
+}
@@ -0,0 +1,214 @@
+#include "live_recording.h"
+#include "mapped_file.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+
+#include <zlib.h>
+
+#define LIVE_RECORDING_MAGIC "LTLR"
+#define LIVE_RECORDING_VERSION 1
+
+live_recorder_t::~live_recorder_t() {
+    close();
+}
+
+int live_recorder_t::open(const std::string& path) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    // a new recording every time, the log would otherwise append to the previous one
+    std::remove(path.c_str());
+    std::vector<unsigned char> contents;
+    if (m_log.open(path, LIVE_RECORDING_MAGIC, LIVE_RECORDING_VERSION, "live recording", &contents)) {
+        return 1;
+    }
+    m_start = std::chrono::steady_clock::now();
+    m_n_of_records = 0;
+    m_n_of_body_bytes = 0;
+    m_n_of_file_bytes = m_log.m_size;
+
+    return 0;
+}
+
+void live_recorder_t::close() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_log.close();
+}
+
+int live_recorder_t::record(const std::string& path_name, int status, const std::string& body) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    if (!m_log.is_open()) {
+        return 1;
+    }
+
+    const uint64_t time_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_start).count();
+    const uint32_t path_name_size = static_cast<uint32_t>(path_name.size());
+    const uint16_t status_u16 = static_cast<uint16_t>(status);
+    const uint32_t body_size = static_cast<uint32_t>(body.size());
+    // the whole record is built first and written with one append, which rolls the file back if it fails
+    const size_t header_size = 22 + path_name.size();
+    uLongf deflated_size = compressBound(body.size());
+    m_record.resize(header_size + deflated_size);
+    if (compress2(m_record.data() + header_size, &deflated_size, reinterpret_cast<const Bytef*>(body.data()), body.size(), Z_DEFAULT_COMPRESSION) != Z_OK) {
+        return 1;
+    }
+    m_record.resize(header_size + deflated_size);
+    const uint32_t deflated_size_u32 = static_cast<uint32_t>(deflated_size);
+    unsigned char* cur = m_record.data();
+    auto write_bytes = [&cur](const void* data, size_t size) {
+        memcpy(cur, data, size);
+        cur += size;
+    };
+    write_bytes(&time_us, sizeof(time_us));
+    write_bytes(&path_name_size, sizeof(path_name_size));
+    write_bytes(path_name.data(), path_name.size());
+    write_bytes(&status_u16, sizeof(status_u16));
+    write_bytes(&body_size, sizeof(body_size));
+    write_bytes(&deflated_size_u32, sizeof(deflated_size_u32));
+    if (m_log.append(m_record.data(), m_record.size())) {
+        return 1;
+    }
+    ++m_n_of_records;
+    m_n_of_body_bytes += body.size();
+    m_n_of_file_bytes = m_log.m_size;
+
+    return 0;
+}
+
+int live_recording_read(const std::string& path, std::vector<live_record_t>* records) {
+    records->clear();
+
+    mapped_file_t file;
+    if (file.open(path)) {
+        std::cerr << "CLIENT failed to open live recording '" << path << "'" << std::endl;
+        return 1;
+    }
+    if (append_log_check_header(file.m_data, file.m_size, LIVE_RECORDING_MAGIC, LIVE_RECORDING_VERSION)) {
+        std::cerr << "CLIENT '" << path << "' is not a version " << LIVE_RECORDING_VERSION << " live recording" << std::endl;
+        return 1;
+    }
+
+    const unsigned char* cur = file.m_data + APPEND_LOG_HEADER_SIZE;
+    const unsigned char* end = file.m_data + file.m_size;
+    auto read_bytes = [&](void* value, size_t size) {
+        if (static_cast<size_t>(end - cur) < size) {
+            return 1;
+        }
+        memcpy(value, cur, size);
+        cur += size;
+        return 0;
+    };
+    while (cur < end) {
+        live_record_t record;
+        uint32_t path_name_size;
+        uint16_t status;
+        uint32_t body_size;
+        uint32_t deflated_size;
+        if (read_bytes(&record.time_us, sizeof(record.time_us)) || read_bytes(&path_name_size, sizeof(path_name_size))) {
+            break ;
+        }
+        record.path_name.resize(path_name_size);
+        if (
+            read_bytes(record.path_name.data(), path_name_size) ||
+            read_bytes(&status, sizeof(status)) ||
+            read_bytes(&body_size, sizeof(body_size)) ||
+            read_bytes(&deflated_size, sizeof(deflated_size)) ||
+            static_cast<size_t>(end - cur) < deflated_size
+        ) {
+            break ;
+        }
+        record.status = status;
+        record.body.resize(body_size);
+        uLongf inflated_size = body_size;
+        if (uncompress(reinterpret_cast<Bytef*>(record.body.data()), &inflated_size, cur, deflated_size) != Z_OK || inflated_size != body_size) {
+            std::cerr << "CLIENT live recording '" << path << "' has a corrupt record at offset " << (cur - file.m_data) << std::endl;
+            break ;
+        }
+        cur += deflated_size;
+        records->push_back(std::move(record));
+    }
+    if (cur != end) {
+        std::cerr << "CLIENT live recording '" << path << "' ends with a torn record, replaying " << records->size() << " records" << std::endl;
+    }
+
+    return 0;
+}
+
+void live_replay_t::init(std::vector<live_record_t>&& records, const live_replay_config_t& config) {
+    m_config = config;
+    m_records = std::move(records);
+    m_path_to_records.clear();
+    m_duration_us = 0;
+    for (size_t record_index = 0; record_index < m_records.size(); ++record_index) {
+        m_path_to_records[m_records[record_index].path_name].record_indices.push_back(record_index);
+        m_duration_us = std::max(m_duration_us, m_records[record_index].time_us);
+    }
+    m_start = std::chrono::steady_clock::now();
+}
+
+void live_replay_t::handle(const http_server_request_t& request, http_response_t* response) {
+    const live_record_t* record = 0;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+
+        // the query is not part of what the game client answers
+        auto path_records_it = m_path_to_records.find(request.path_name.substr(0, request.path_name.find('?')));
+        if (path_records_it == m_path_to_records.end()) {
+            response->status = 404;
+            return ;
+        }
+        path_records_t& path_records = path_records_it->second;
+
+        if (m_config.speed == 0.0) {
+            if (path_records.record_indices.size() <= path_records.next_step && m_config.is_looped) {
+                path_records.next_step = 0;
+            }
+            if (path_records.next_step < path_records.record_indices.size()) {
+                record = &m_records[path_records.record_indices[path_records.next_step++]];
+            }
+        } else {
+            uint64_t time_us = static_cast<uint64_t>(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_start).count() * m_config.speed);
+            if (m_config.is_looped && m_duration_us) {
+                time_us %= m_duration_us + 1;
+            }
+            auto next_record_index_it = std::upper_bound(
+                path_records.record_indices.begin(), path_records.record_indices.end(), time_us,
+                [this](uint64_t time_us, size_t record_index) {
+                    return time_us < m_records[record_index].time_us;
+                }
+            );
+            // before the first response of the path the game had not started
+            if (next_record_index_it != path_records.record_indices.begin() && time_us <= m_duration_us) {
+                record = &m_records[*(next_record_index_it - 1)];
+            }
+            path_records.next_step = next_record_index_it - path_records.record_indices.begin();
+        }
+    }
+
+    // past the end, or the game client was not answering at that time
+    if (!record || record->status == 0) {
+        response->status = 0;
+        return ;
+    }
+    response->status = record->status;
+    response->headers.push_back({ .name = "Content-Type", .value = "application/json" });
+    response->body = record->body;
+}
+
+bool live_replay_t::is_done() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    if (m_config.speed != 0.0) {
+        return !m_config.is_looped && m_duration_us < std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_start).count() * m_config.speed;
+    }
+    for (const auto& [path_name, path_records] : m_path_to_records) {
+        if (path_records.next_step < path_records.record_indices.size()) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,101 @@
+#ifndef LIVE_RECORDING_H
+# define LIVE_RECORDING_H
+
+# include <string>
+# include <vector>
+# include <unordered_map>
+# include <mutex>
+# include <chrono>
+# include <cstdint>
+
+# include "http_server.h"
+# include "append_log.h"
+
+/**
+ * One response of the game client's liveclientdata api as it was received.
+*/
+struct live_record_t {
+    uint64_t    time_us;   // since the recording started
+    std::string path_name; // e.g. "liveclientdata/allgamedata"
+    int         status;    // 0 if no response came, the game client was not running
+    std::string body;
+};
+
+/**
+ * Appends responses to a recording, each body deflated on its own so a recording can be cut or replayed from any record.
+ *
+ * File layout: "LTLR" magic, u32 version, then one record per response:
+ *   u64 time us, u32 path name size, path name, u16 status, u32 body size, u32 deflated size, zlib stream of the body
+ *
+ * Example call:
+ * live_recorder_t recorder;
+ * recorder.open("session.ltlr");
+ * recorder.record("liveclientdata/allgamedata", response.status, response.body);
+*/
+struct live_recorder_t {
+    live_recorder_t() = default;
+    live_recorder_t(const live_recorder_t&) = delete;
+    live_recorder_t& operator=(const live_recorder_t&) = delete;
+    ~live_recorder_t();
+
+    // truncates path, the recording's clock starts here
+    int  open(const std::string& path);
+    void close();
+
+    // thread safe
+    int  record(const std::string& path_name, int status, const std::string& body);
+
+    std::mutex                            m_mutex;
+    append_log_t                          m_log;
+    std::chrono::steady_clock::time_point m_start;
+    // the record being written, kept to reuse its capacity
+    std::vector<unsigned char>            m_record;
+    size_t                                m_n_of_records = 0;
+    size_t                                m_n_of_body_bytes = 0;
+    size_t                                m_n_of_file_bytes = 0;
+};
+
+// reads every record of a recording in order, a torn last record is dropped
+int live_recording_read(const std::string& path, std::vector<live_record_t>* records);
+
+struct live_replay_config_t {
+    // recording time per wall clock time, 1 for real time
+    // 0 steps instead: each request gets the next record of its path however fast requests come, for deterministic benchmarks
+    double speed = 1.0;
+    // starts over past the last record, otherwise the game is over and connections are closed
+    bool   is_looped = false;
+};
+
+/**
+ * Serves a recording back as the game client would have, meant as the handler of an http_server_t.
+ * A path gets its latest record at or before the replay time, 404 if it was never recorded.
+ *
+ * Example call:
+ * live_replay_t replay;
+ * replay.init(records, live_replay_config_t());
+ * http_server_t server;
+ * server.init(config, [&replay](const http_server_request_t& request, http_response_t* response) {
+ *   replay.handle(request, response);
+ * });
+*/
+struct live_replay_t {
+    void init(std::vector<live_record_t>&& records, const live_replay_config_t& config);
+    // thread safe
+    void handle(const http_server_request_t& request, http_response_t* response);
+    // every record of every path was served at least once, or the replay time went past the last record
+    bool is_done();
+
+    struct path_records_t {
+        std::vector<size_t> record_indices; // ascending time
+        size_t              next_step = 0;  // in step mode
+    };
+
+    live_replay_config_t                            m_config;
+    std::vector<live_record_t>                      m_records;
+    uint64_t                                        m_duration_us = 0;
+    std::chrono::steady_clock::time_point           m_start;
+    std::mutex                                      m_mutex;
+    std::unordered_map<std::string, path_records_t> m_path_to_records;
+};
+
+#endif // LIVE_RECORDING_H
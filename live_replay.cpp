@@ -0,0 +1,177 @@
+#include "live_recording.h"
+#include "live_client.h"
+#include "http_server.h"
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+/**
+ * Serves a live recording made by the tracker (--record-live) back as the game client would, over http or https,
+ * at the recorded pace, faster, or one record per request.
+ * With --bench the replay is stepped through a live_client_t in this process instead, so every poll sees the next recorded payload
+ * and the latency and cpu time of the request, delta extraction and ui apply are measured without a game running.
+ *
+ * Example call:
+ * ./live_replay session.ltlr --port 2999 --https --speed 4
+ * ./tracker <riot_api_key> --live-address https://127.0.0.1:2999
+ * ./live_replay session.ltlr --bench
+*/
+
+struct live_replay_args_t {
+    std::string recording_path;
+    size_t      port = LIVE_CLIENT_PORT;
+    bool        is_tls = false;
+    double      speed = 1.0;
+    bool        is_looped = false;
+    bool        is_bench = false;
+};
+
+static int parse_args(int argc, char** argv, live_replay_args_t* args) {
+    if (argc < 2) {
+        return 1;
+    }
+    args->recording_path = argv[1];
+    for (int arg_index = 2; arg_index < argc; ++arg_index) {
+        const bool has_value = arg_index + 1 < argc;
+        if (!strcmp(argv[arg_index], "--port") && has_value) {
+            args->port = std::stoul(argv[++arg_index]);
+        } else if (!strcmp(argv[arg_index], "--speed") && has_value) {
+            args->speed = std::stod(argv[++arg_index]);
+        } else if (!strcmp(argv[arg_index], "--https")) {
+            args->is_tls = true;
+        } else if (!strcmp(argv[arg_index], "--loop")) {
+            args->is_looped = true;
+        } else if (!strcmp(argv[arg_index], "--bench")) {
+            args->is_bench = true;
+        } else {
+            return 1;
+        }
+    }
+
+    return args->speed < 0.0;
+}
+
+static uint64_t thread_cpu_us() {
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return static_cast<uint64_t>(time.tv_sec) * 1000000 + time.tv_nsec / 1000;
+}
+
+static double percentile(std::vector<uint64_t> samples, double fraction) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    const size_t index = std::min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return static_cast<double>(samples[index]);
+}
+
+static int bench(live_replay_t* replay, size_t n_of_polls, bool is_tls) {
+    http_server_t server;
+    http_server_config_t server_config;
+    server_config.is_tls = is_tls;
+    if (server.init(server_config, [replay](const http_server_request_t& request, http_response_t* response) {
+        replay->handle(request, response);
+    })) {
+        return 1;
+    }
+
+    live_client_config_t client_config;
+    client_config.scheme = is_tls ? "https" : "http";
+    client_config.port = server.m_port;
+    client_config.is_polled_by_caller = true;
+    live_client_t live_client;
+    if (live_client.init(client_config)) {
+        return 1;
+    }
+
+    // what the ui thread does with the changes is part of the pipeline
+    live_state_t ui_live_state;
+    std::vector<live_change_t> changes;
+    std::vector<uint64_t> poll_us;
+    std::vector<uint64_t> cpu_us;
+    poll_us.reserve(n_of_polls);
+    cpu_us.reserve(n_of_polls);
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t poll_index = 0; poll_index < n_of_polls; ++poll_index) {
+        const uint64_t cpu_start = thread_cpu_us();
+        const auto poll_start = std::chrono::steady_clock::now();
+        live_client.poll();
+        live_client.take_changes(&changes);
+        for (const live_change_t& change : changes) {
+            live_state_apply(&ui_live_state, change);
+        }
+        poll_us.push_back(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - poll_start).count());
+        cpu_us.push_back(thread_cpu_us() - cpu_start);
+    }
+    const double total_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    uint64_t total_cpu_us = 0;
+    for (uint64_t sample : cpu_us) {
+        total_cpu_us += sample;
+    }
+
+    const live_client_stats_t& stats = live_client.m_stats;
+    std::cout << "polls     " << stats.n_of_polls << ", " << stats.n_of_failed_polls << " failed, " << server.m_stats.n_of_connections << " connections, " << total_ms << " ms" << std::endl;
+    std::cout << "latency   p50 " << percentile(poll_us, 0.5) << " us, p99 " << percentile(poll_us, 0.99) << " us, max " << percentile(poll_us, 1.0) << " us" << std::endl;
+    std::cout << "cpu       " << static_cast<double>(total_cpu_us) / std::max<size_t>(1, n_of_polls) << " us/poll, p99 " << percentile(cpu_us, 0.99) << " us" << std::endl;
+    std::cout << "payloads  " << stats.n_of_payload_bytes << " bytes, " << stats.n_of_parsed_bytes << " parsed" << std::endl;
+    std::cout << "deltas    " << stats.n_of_deltas << ", " << stats.n_of_extracted_deltas << " extracted, " << stats.n_of_changes << " changes" << std::endl;
+    std::cout << "end state game time " << ui_live_state.game_time << ", " << ui_live_state.players.size() << " players, " << ui_live_state.events.size() << " events" << std::endl;
+
+    live_client.destroy();
+    server.destroy();
+
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    live_replay_args_t args;
+    if (parse_args(argc, argv, &args)) {
+        std::cerr << "usage: <live_replay_bin> <recording> [--port <port>] [--https] [--speed <x, 0 for a record per request>] [--loop] [--bench]" << std::endl;
+        return 1;
+    }
+
+    std::vector<live_record_t> records;
+    if (live_recording_read(args.recording_path, &records)) {
+        return 1;
+    }
+    uint64_t n_of_body_bytes = 0;
+    size_t n_of_polls = 0;
+    for (const live_record_t& record : records) {
+        n_of_body_bytes += record.body.size();
+        n_of_polls += record.path_name == LIVE_CLIENT_ALLGAMEDATA_PATH;
+    }
+    std::cout << records.size() << " records, " << n_of_body_bytes << " body bytes, " << (records.empty() ? 0.0 : records.back().time_us / 1e6) << " s" << std::endl;
+
+    live_replay_t replay;
+    live_replay_config_t replay_config;
+    replay_config.speed = args.is_bench ? 0.0 : args.speed;
+    replay_config.is_looped = args.is_looped && !args.is_bench;
+    replay.init(std::move(records), replay_config);
+    if (args.is_bench) {
+        return bench(&replay, n_of_polls, args.is_tls);
+    }
+
+    http_server_t server;
+    http_server_config_t server_config;
+    server_config.port = args.port;
+    server_config.is_tls = args.is_tls;
+    if (server.init(server_config, [&replay](const http_server_request_t& request, http_response_t* response) {
+        replay.handle(request, response);
+    })) {
+        return 1;
+    }
+    std::cout << "serving on " << (args.is_tls ? "https" : "http") << "://" << server_config.host_name << ":" << server.m_port << std::endl;
+    while (!replay.is_done()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    // lets the last responses go out before the connections are closed
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    std::cout << server.m_stats.n_of_requests << " requests over " << server.m_stats.n_of_connections << " connections" << std::endl;
+
+    return 0;
+}
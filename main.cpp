@@ -6,10 +6,29 @@
 #include "json.hpp"
 #include "config.h"
 #include "asset_manager.h"
+#include "challenges.h"
+#include "leaderboard.h"
+#include "history.h"
+#include "forecast.h"
+#include "persistence.h"
+#include "http.h"
+#include "riot_client.h"
+#include "riot_cache.h"
+#include "http_cache.h"
+#include "match_ingester.h"
+#include "match_store.h"
+#include "attribution.h"
+#include "heatmap.h"
+#include "pending_matches.h"
+#include "live_client.h"
 
 #include <iostream>
 #include <fstream>
 #include <cstring>
+#include <mutex>
+#include <algorithm>
+#include <ctime>
+#include <memory>
 
 /*
     patch: zilean's faction is "shurima"
@@ -22,30 +41,6 @@ struct asset_data_json_t : public asset_data_base_t {
     nlohmann::json json;
 };
 
-struct challenge_t {
-    int                       id;
-    bool                      leaderboard;
-    std::string               short_description;
-    std::string               description;
-    std::string               name;
-    std::string               state;
-    std::string               tier;
-    std::string               next_tier;
-    std::string               title; // todo: add this
-    Texture2D                 icon;
-    double                    percentile;
-    double                    value;
-    double                    next_value;
-    time_t                    achieved_time;
-    std::vector<challenge_t*> children;
-    challenge_t*              parent;
-
-    /*
-        303510 -> champions where "faction": "shurima"
-        dependencies
-    */
-};
-
 struct {
     float window_w;
     float window_h;
@@ -56,18 +51,51 @@ struct {
     char game_name_text_box[256];
     bool is_tag_line_text_box_active;
     char tag_line_text_box[256];
-    nlohmann::json account_challenges;
+    bool is_adding_account;
 
-    nlohmann::json global_challenges;
     nlohmann::json challenges_local;
 
     nlohmann::json champions_info;
 
+    // guards the catalog and the accounts, both are written from the network callbacks
+    std::mutex             accounts_mutex;
+    challenge_catalog_t    catalog;
+    std::vector<account_t> accounts;
+    size_t                 current_account;
+    std::vector<Texture2D> challenge_icons; // [slot * _TIER_SIZE + tier], loaded on first draw
+    leaderboard_t          leaderboard;
+    history_store_t        history;
+    forecaster_t           forecaster;
+    bool                   is_leaderboard_active;
+    bool                   is_heatmap_active;
+
     challenge_t* current_challange;
-    challenge_t* challanges_root;
 
-    riot_api riot;
+    http_pool_t http_pool;
+    riot_cache_t riot_cache;
+    http_cache_t http_cache;
+    riot_client_t riot;
+    match_ingester_t match_ingester;
+    match_store_t match_store;
+    attribution_engine_t attribution;
+    heatmap_engine_t heatmap;
+    // stored matches the attribution and the heatmap have not seen yet, or whose timeline request failed
+    pending_matches_t pending_matches;
+    heatmap_filter_t heatmap_filter;
+    // what the texture currently shows, rebuilt when the filter or the engine's version moves
+    heatmap_filter_t heatmap_texture_filter;
+    uint64_t         heatmap_texture_version;
+    Texture2D        heatmap_texture;
+    uint64_t         heatmap_n_of_points;
+    std::vector<int> heatmap_champion_ids;
+    live_client_t live_client;
+    // mirror of the live client's state, kept current from its changes on the ui thread
+    live_state_t live_state;
+    std::vector<live_change_t> live_changes;
+    std::vector<attribution_live_stat_t> live_stats;
+    std::vector<attribution_live_contribution_t> live_contributions;
     asset_manager_t asset_manager;
+    persistence_writer_t persistence_writer;
 } _;
 
 static void display_champion(const std::string& champion_name) {
@@ -100,23 +128,26 @@ static int init(int argc, char** argv);
 static void update(double dt);
 static void draw();
 static void draw_challenges();
-static void draw_challenge(challenge_t* node, const Rectangle& rec, int is_detailed);
-static void draw_challenge_icon(challenge_t* node, const Rectangle& rec);
+static void draw_challenge(const account_t& account, challenge_t* node, const Rectangle& rec, int is_detailed);
+static void draw_challenge_icon(challenge_t* node, tier_t tier, const Rectangle& rec);
 static void draw_challenge_description(challenge_t* node, const Rectangle& rec, int is_detailed);
-static void draw_challenge_top(challenge_t* node, const Rectangle& rec, int is_detailed);
-static void draw_challenge_value_bar(challenge_t* node, const Rectangle& rec);
-static void draw_challenge_specifics(challenge_t* node, const Rectangle& rec);
+static void draw_challenge_top(const challenge_progress_t& progress, const Rectangle& rec, int is_detailed);
+static void draw_challenge_value_bar(challenge_t* node, const challenge_progress_t& progress, const Rectangle& rec);
+static void draw_challenge_forecast(const account_t& account, challenge_t* node, const challenge_progress_t& progress, const Rectangle& rec);
+static void draw_challenge_specifics(const account_t& account, challenge_t* node, const Rectangle& rec);
 static void draw_challenges_category_points();
+static void draw_accounts_bar(const Rectangle& rec);
 static void draw_current_challenge();
+static void draw_leaderboard(const Rectangle& rec);
+static void draw_heatmap(const Rectangle& rec);
 static int  draw_text_in_rec(const char* text, const Rectangle& rec);
 static void destroy();
 
-static std::string tier_to_next_tier(const std::string& tier);
-static Color tier_to_color(const std::string& tier);
+static Color tier_to_color(tier_t tier);
 
-static void build_challenges(const nlohmann::json& global_challenges, const nlohmann::json& account_challenges);
+static void track_account(const std::string& game_name, const std::string& tag_line);
+static void apply_match_timeline(const std::string& match_id, std::shared_ptr<const nlohmann::json> match_info);
 static challenge_t* find_id(challenge_t* cur, int id);
-static int find_parent_id(int id);
 
 static bool is_within(const Vector2& p, const Rectangle& rec) {
     return rec.x <= p.x && p.x <= rec.x + rec.width && rec.y <= p.y && p.y <= rec.y + rec.height;
@@ -136,161 +167,207 @@ static challenge_t* find_id(challenge_t* cur, int id) {
     return 0;
 }
 
-static int find_parent_id(int id) {
-    if (id <= 0) {
-        return -1;
+static Texture2D challenge_icon(challenge_t* node, tier_t tier) {
+    const size_t icon_index = node->slot * _TIER_SIZE + tier;
+    if (_.challenge_icons.size() <= icon_index) {
+        _.challenge_icons.resize(_.catalog.m_challenges.size() * _TIER_SIZE, Texture2D{});
     }
 
-    int divisor = 100;
-    while (id % divisor == 0) {
-        divisor *= 10;
+    Texture2D& icon = _.challenge_icons[icon_index];
+    if (icon.id == 0 && !node->icon_paths[tier].empty()) {
+        icon = LoadTexture(node->icon_paths[tier].c_str());
     }
 
-    int result = id / divisor * divisor;
+    return icon;
+}
 
-    if (result % 100000 == 0) {
-        return result / 100000;
+static void on_account_challenges(const std::string& puuid, const std::string& game_name, const std::string& tag_line, const nlohmann::json& account_challenges) {
+    // the catalog does not change once built and the history has its own lock,
+    // the snapshot goes to disk before taking the lock draw() holds for the whole frame
+    account_t account;
+    account.m_game_name = game_name;
+    account.m_tag_line = tag_line;
+    account.m_puuid = puuid;
+    if (account.load(_.catalog, account_challenges)) {
+        std::cerr << "CLIENT failed to load account_challenges for '" << game_name << "#" << tag_line << "'" << std::endl;
+        return ;
     }
-    return result;
-}
 
-static void build_challenges(const nlohmann::json& global_challenges, const nlohmann::json& account_challenges) {
-    challenge_t* root = 0;
-
-    std::unordered_map<int, challenge_t*> unconnected_nodes;
-
-    challenge_t* legacy = new challenge_t();
-    legacy->id = 6;
-    legacy->leaderboard = false;
-    legacy->short_description = "Legacy";
-    legacy->description = "Legacy";
-    legacy->name = "Legacy";
-    legacy->state = "DISABLED";
-    legacy->tier = "NONE";
-    legacy->next_tier = "NONE";
-    legacy->percentile = 0;
-    legacy->value = 0;
-    legacy->next_value = 0;
-    legacy->achieved_time = 0;
-    legacy->parent = 0;
-    const auto find_challenge_icon_path = [](challenge_t* incomplete_challenge) {
-        for (const auto& challenge : _.challenges_local) {
-            if (challenge["id"] == incomplete_challenge->id) {
-                const auto& icon_paths = challenge["levelToIconPath"];
-                const auto& found_tier = icon_paths.find(incomplete_challenge->tier);
-                if (found_tier != icon_paths.end()) {
-                    incomplete_challenge->icon = LoadTexture(("assets" + found_tier.value().get<std::string>()).c_str());
-                }
-            }
-        }
-    };
-    find_challenge_icon_path(legacy);
-
-    unconnected_nodes.insert({ legacy->id, legacy });
-
-    for (const nlohmann::json& global_challenge : global_challenges) {
-        nlohmann::json found_account_challenge;
-        int found = 0;
-        for (nlohmann::json account_challenge : account_challenges["challenges"]) {
-            if (account_challenge["challengeId"] == global_challenge["id"]) {
-                found_account_challenge = account_challenge;
-                found = 1;
-                break ;
-            }
+    const int64_t now = time(0);
+    if (_.history.append_snapshot(puuid, now, _.catalog, account) < 0) {
+        std::cerr << "CLIENT failed to record history for '" << game_name << "#" << tag_line << "'" << std::endl;
+    }
+    // without any snapshot of the account, e.g. with the history disabled, the leaderboard keeps the values it first saw this session,
+    // the lifetime totals are not gains of the week
+    std::vector<float> week_ago_values(_.catalog.m_challenges.size());
+    bool is_week_ago_known = true;
+    for (const challenge_t& challenge : _.catalog.m_challenges) {
+        double week_ago_value;
+        if (_.history.value_at(puuid, challenge.id, now - 7 * 24 * 60 * 60, &week_ago_value)) {
+            is_week_ago_known = false;
+            break ;
         }
+        week_ago_values[challenge.slot] = static_cast<float>(week_ago_value);
+    }
 
-        challenge_t* challenge = new challenge_t();
-        challenge->parent = 0;
-        challenge->id = global_challenge["id"];
-        challenge->leaderboard = global_challenge["leaderboard"];
-        challenge->short_description = global_challenge["localizedNames"]["en_US"]["shortDescription"];
-        challenge->description = global_challenge["localizedNames"]["en_US"]["description"];
-        challenge->name = global_challenge["localizedNames"]["en_US"]["name"];
-        challenge->state = global_challenge["state"];
-
-        const auto find_next_value = [&global_challenge, &challenge]() {
-            double result = 0;
-
-            std::vector<double> values;
-            for (const auto& j : global_challenge["thresholds"].items()) {
-                values.push_back(j.value());
-            }
-            assert(!values.empty());
-            std::sort(values.begin(), values.end());
-            result = challenge->value;
-            for (int i = 0; i < values.size(); ++i) {
-                if (challenge->value < values[i]) {
-                    if (i < values.size() - 1) {
-                        result = values[i + 1];
-                    }
-                }
-            }
-
-            return result;
-        };
-        if (found) {
-            challenge->tier = found_account_challenge["level"];
-            if (found_account_challenge["percentile"].is_number()) {
-                challenge->percentile = found_account_challenge["percentile"];
-            } else {
-                challenge->percentile = 0;
-            }
-            if (found_account_challenge["value"].is_number()) {
-                challenge->value = found_account_challenge["value"];
-            } else {
-                challenge->value = 0;
-            }
-            challenge->next_value = find_next_value();
-            if (found_account_challenge["achievedTime"].is_number()) {
-                challenge->achieved_time = found_account_challenge["achievedTime"];
-            } else {
-                challenge->achieved_time = 0;
-            }
+    std::lock_guard<std::mutex> accounts_guard(_.accounts_mutex);
+    if (is_week_ago_known) {
+        _.leaderboard.set_baseline(puuid, week_ago_values);
+    }
+    _.forecaster.update(&_.history, _.catalog, account, now);
+
+    auto account_it = std::find_if(_.accounts.begin(), _.accounts.end(), [&puuid](const account_t& account) {
+        return account.m_puuid == puuid;
+    });
+    if (account_it == _.accounts.end()) {
+        _.current_account = _.accounts.size();
+        _.accounts.push_back(std::move(account));
+    } else {
+        _.current_account = account_it - _.accounts.begin();
+        *account_it = std::move(account);
+    }
+    _.leaderboard.build(_.catalog, _.accounts);
 
-        } else {
-            challenge->tier = "UNRANKED";
-            challenge->percentile = 0;
-            challenge->value = 0;
-            challenge->next_value = find_next_value();
-            challenge->achieved_time = 0;
-        }
-        challenge->next_tier = tier_to_next_tier(challenge->tier);
-        find_challenge_icon_path(challenge);
+    // re-tracked on the next start, their puuids come from the riot cache
+    nlohmann::json tracked_accounts = nlohmann::json::array();
+    for (const account_t& tracked_account : _.accounts) {
+        tracked_accounts.push_back({ { "game_name", tracked_account.m_game_name }, { "tag_line", tracked_account.m_tag_line } });
+    }
+    _.persistence_writer.write_json_async("accounts.json", std::move(tracked_accounts));
 
-        unconnected_nodes.insert({ challenge->id, challenge });
-        if (challenge->id == 0) {
-            root = challenge;
-        }
+    if (!_.current_challange) {
+        _.current_challange = _.catalog.m_root;
     }
+}
 
-    assert(root);
+static void track_account(const std::string& game_name, const std::string& tag_line) {
+    _.riot.get_puuid_async(
+        game_name, tag_line,
+        [game_name, tag_line](const std::string& resulting_puuid) {
+            std::cout << "CLIENT successfully got puuid for '" << resulting_puuid << "'" << std::endl;
+            std::cout << "CLIENT successfully got puuid for '" << game_name << "#" << tag_line << "'" << std::endl;
+            _.attribution.track(resulting_puuid);
+            // matches stored before a crash, or before the account was tracked this session
+            std::vector<pending_match_t> pending_matches;
+            _.pending_matches.take(resulting_puuid, &pending_matches);
+            for (const pending_match_t& pending_match : pending_matches) {
+                apply_match_timeline(pending_match.match_id, pending_match.match_info);
+            }
+            _.match_ingester.ingest_async(riot_api::REGION_EUW, riot_api::GAME_TYPE_RANKED, resulting_puuid, 100);
+            _.riot.get_challenges_by_puuid_async(
+                riot_api::REGION_EUW, resulting_puuid,
+                [resulting_puuid, game_name, tag_line](const nlohmann::json& resulting_challenges_info_for_puuid) {
+                    std::cout << "CLIENT successfully got account_challenges for '" << game_name << "#" << tag_line << "'" << std::endl;
+                    _.persistence_writer.write_json_async("account_challenges.json", resulting_challenges_info_for_puuid);
+
+                    bool has_catalog = false;
+                    {
+                        std::lock_guard<std::mutex> accounts_guard(_.accounts_mutex);
+                        has_catalog = _.catalog.m_root != 0;
+                    }
+                    if (has_catalog) {
+                        on_account_challenges(resulting_puuid, game_name, tag_line, resulting_challenges_info_for_puuid);
+                        return ;
+                    }
 
-    for (auto it : unconnected_nodes) {
-        challenge_t* node = it.second;
-        if (node == root) {
-            continue ;
+                    // the catalog is shared by all accounts, only the first tracked account fetches it
+                    _.riot.get_challenges_info_async(
+                        riot_api::REGION_EUW,
+                        [resulting_puuid, game_name, tag_line, resulting_challenges_info_for_puuid](const nlohmann::json& resulting_challenges_info) {
+                            _.persistence_writer.write_json_async("global_challenges.json", resulting_challenges_info);
+
+                            std::vector<int> ids;
+                            for (const nlohmann::json& j : resulting_challenges_info) {
+                                ids.push_back(j["id"]);
+                            }
+                            _.persistence_writer.write_async("ids.json", [ids = std::move(ids)]() mutable {
+                                std::sort(ids.begin(), ids.end());
+                                std::string result;
+                                for (int id : ids) {
+                                    result += std::to_string(id) + " -> " + std::to_string(find_parent_id(id)) + "\n";
+                                }
+                                return result;
+                            });
+
+                            {
+                                std::lock_guard<std::mutex> accounts_guard(_.accounts_mutex);
+                                if (!_.catalog.m_root && _.catalog.build(resulting_challenges_info, _.challenges_local)) {
+                                    std::cerr << "CLIENT failed to build challenge catalog" << std::endl;
+                                    return ;
+                                }
+                            }
+                            on_account_challenges(resulting_puuid, game_name, tag_line, resulting_challenges_info_for_puuid);
+                        },
+                        [](const riot_error_t& error) {
+                            std::cerr << "CLIENT failed to get challenges info: " << error << std::endl;
+                        }
+                    );
+                },
+                [game_name, tag_line](const riot_error_t& error) {
+                    std::cerr << "CLIENT failed to get account_challenges for '" << game_name << "#" << tag_line << "': " << error << std::endl;
+                }
+            );
+        },
+        [game_name, tag_line](const riot_error_t& error) {
+            std::cerr << "CLIENT failed to get puuid for '" << game_name << "#" << tag_line << "': " << error << std::endl;
         }
-        int id = find_parent_id(node->id);
-        auto parent_it = unconnected_nodes.find(id);
-        challenge_t* parent = 0;
-        if (parent_it == unconnected_nodes.end()) {
-            parent = legacy;
-        } else {
-            parent = parent_it->second;
+    );
+}
+
+// the timeline rules and the heatmaps need the timeline, the other rules still apply without it
+static void apply_match_timeline(const std::string& match_id, std::shared_ptr<const nlohmann::json> match_info) {
+    _.riot.get_match_timeline_decoded_async(
+        riot_api::REGION_EUW, match_id,
+        [match_id, match_info](const match_timeline_t& resulting_match_timeline) {
+            _.attribution.add_match(match_id, *match_info, &resulting_match_timeline);
+            _.heatmap.add_match(match_id, *match_info, resulting_match_timeline);
+            _.pending_matches.remove(match_id);
+        },
+        [match_id, match_info](const riot_error_t& error) {
+            std::cerr << "CLIENT failed to get timeline of '" << match_id << "': " << error << std::endl;
+            if (_.pending_matches.fail(match_id) < PENDING_MATCH_MAX_FAILURES) {
+                // asked again when one of its accounts is tracked, on the next start
+                return ;
+            }
+            std::cerr << "CLIENT '" << match_id << "' is attributed without its timeline and left out of the heatmaps" << std::endl;
+            _.attribution.add_match(match_id, *match_info, 0);
+            _.pending_matches.remove(match_id);
         }
-        node->parent = parent;
-        parent->children.push_back(node);
-    }
+    );
+}
 
-    _.challanges_root = root;
-    _.current_challange = root;
+// <scheme>://<host name>:<port>
+static int parse_address(const std::string& address, std::string* scheme, std::string* host_name, size_t* port) {
+    const size_t scheme_end = address.find("://");
+    const size_t port_begin = address.rfind(':');
+    if (scheme_end == std::string::npos || port_begin <= scheme_end + 3 || port_begin + 1 == address.size()) {
+        return 1;
+    }
+    *scheme = address.substr(0, scheme_end);
+    *host_name = address.substr(scheme_end + 3, port_begin - scheme_end - 3);
+    *port = strtoul(address.c_str() + port_begin + 1, 0, 10);
+    return 0;
 }
 
 static int init(int argc, char** argv) {
     std::cout << "League Tracker v" << LEAGUE_TRACKER_VERSION_MAJOR << "." << LEAGUE_TRACKER_VERSION_MINOR << std::endl;
 
-    if (argc != 2) {
-        std::cerr << "usage: <tracker_bin> <riot_api_key>" << std::endl;
+    // the game client's address can be pointed at a live_replay server, the riot api's at a riot_mock_server
+    live_client_config_t live_client_config;
+    bool are_args_valid = 2 <= argc;
+    for (int arg_index = 2; arg_index < argc && are_args_valid; ++arg_index) {
+        if (!strcmp(argv[arg_index], "--record-live") && arg_index + 1 < argc) {
+            live_client_config.record_path = argv[++arg_index];
+        } else if (!strcmp(argv[arg_index], "--live-address") && arg_index + 1 < argc) {
+            are_args_valid = parse_address(argv[++arg_index], &live_client_config.scheme, &live_client_config.host_name, &live_client_config.port) == 0;
+        } else if (!strcmp(argv[arg_index], "--riot-address") && arg_index + 1 < argc) {
+            are_args_valid = parse_address(argv[++arg_index], &_.riot.m_scheme, &_.riot.m_host_name_override, &_.riot.m_port) == 0;
+        } else {
+            are_args_valid = false;
+        }
+    }
+    if (!are_args_valid) {
+        std::cerr << "usage: <tracker_bin> <riot_api_key> [--record-live <recording path>] [--live-address <scheme>://<host name>:<port>] [--riot-address <scheme>://<host name>:<port>]" << std::endl;
         return 1;
     }
 
@@ -301,6 +378,13 @@ static int init(int argc, char** argv) {
     memset(&_.tag_line_text_box, 0, sizeof(_.tag_line_text_box));
     _.is_game_name_text_box_active = false;
     _.is_tag_line_text_box_active = false;
+    _.is_adding_account = false;
+    _.is_leaderboard_active = false;
+    _.is_heatmap_active = false;
+    _.heatmap_texture_version = 0;
+    _.heatmap_texture = Texture2D{};
+    _.heatmap_n_of_points = 0;
+    _.current_account = 0;
 
     std::ifstream champions_json("assets/champions.json");
     _.champions_info = nlohmann::json::parse(champions_json);
@@ -310,7 +394,73 @@ static int init(int argc, char** argv) {
     // display_champion("Zilean");
     // exit(1);
 
-    _.riot.init(argv[1]);
+    _.persistence_writer.init();
+    if (_.history.open("history.bin")) {
+        std::cerr << "CLIENT history is disabled for this session" << std::endl;
+    }
+
+    if (_.http_pool.init()) {
+        return 1;
+    }
+    if (_.riot_cache.open("riot_cache.bin", 64 * 1024 * 1024)) {
+        std::cerr << "CLIENT riot responses are only cached in memory for this session" << std::endl;
+    }
+    _.riot.m_cache = &_.riot_cache;
+    if (_.http_cache.init(&_.http_pool, "http_cache")) {
+        std::cerr << "CLIENT the challenge config is downloaded in full on every refresh this session" << std::endl;
+    } else {
+        _.riot.m_http_cache = &_.http_cache;
+    }
+    _.riot.init(&_.http_pool, argv[1]);
+
+    if (_.attribution.open("attribution.bin", _.champions_info)) {
+        std::cerr << "CLIENT challenge attribution is disabled for this session" << std::endl;
+    }
+    if (_.heatmap.open("heatmap.bin")) {
+        std::cerr << "CLIENT heatmaps only cover matches of this session" << std::endl;
+    }
+    if (_.pending_matches.open("pending_matches.bin")) {
+        std::cerr << "CLIENT matches stored right before the client stops are not attributed this session" << std::endl;
+    }
+    if (_.live_client.init(live_client_config)) {
+        std::cerr << "CLIENT live games are not followed this session" << std::endl;
+    }
+    if (_.match_store.open("match_store")) {
+        return 1;
+    }
+    _.match_ingester.init(
+        &_.riot, match_ingester_config_t(),
+        [](const std::string& match_id) {
+            return _.match_store.contains(match_id);
+        },
+        [](const std::string& match_id, const nlohmann::json& match_info) {
+            // pending before it is stored, a stored match is never ingested again
+            std::shared_ptr<const nlohmann::json> shared_match_info = std::make_shared<const nlohmann::json>(match_info);
+            if (_.pending_matches.add(match_id, shared_match_info)) {
+                std::cerr << "CLIENT match '" << match_id << "' is not attributed if the client stops before its timeline arrives" << std::endl;
+            }
+            if (_.match_store.append(match_id, match_info)) {
+                _.pending_matches.remove(match_id);
+                return 1;
+            }
+            apply_match_timeline(match_id, shared_match_info);
+            return 0;
+        },
+        []() {
+            _.match_store.sync();
+        }
+    );
+
+    std::ifstream accounts_json("accounts.json");
+    if (accounts_json) {
+        try {
+            for (const nlohmann::json& tracked_account : nlohmann::json::parse(accounts_json)) {
+                track_account(tracked_account.at("game_name"), tracked_account.at("tag_line"));
+            }
+        } catch (std::exception& e) {
+            std::cerr << "CLIENT failed to parse accounts.json: " << e.what() << std::endl;
+        }
+    }
     _.asset_manager.init("http", "127.0.0.1", 8081);
     _.asset_manager.add_asset_loader<asset_data_json_t>(
         [](asset_data_json_t* json, const unsigned char* serialized_data, size_t serialized_data_size) {
@@ -343,6 +493,11 @@ static int init(int argc, char** argv) {
 
 static void update(double dt) {
     (void) dt;
+
+    _.live_client.take_changes(&_.live_changes);
+    for (const live_change_t& change : _.live_changes) {
+        live_state_apply(&_.live_state, change);
+    }
 }
 
 Vector2 recs_find_mid_p(const std::vector<Rectangle>& recs) {
@@ -374,7 +529,9 @@ static void draw() {
     BeginDrawing();
     ClearBackground(BLACK);
     
-    if (!_.challanges_root) {
+    std::lock_guard<std::mutex> accounts_guard(_.accounts_mutex);
+
+    if (_.accounts.empty() || _.is_adding_account) {
         const char* label_text_game_name = "Game name:";
         const char* label_text_tag_line  = "Tag line:";
         const int   font_size = 32;
@@ -430,60 +587,22 @@ static void draw() {
         }
 
         if (GuiButton(gui_recs[4], "Ok")) {
-            std::string game_name = _.game_name_text_box;
-            std::string tag_line  = _.tag_line_text_box;
-            _.riot.get_puuid_async(
-                game_name, tag_line,
-                [game_name, tag_line](const std::string& resulting_puuid) {
-                    std::cout << "CLIENT successfully got puuid for '" << resulting_puuid << "'" << std::endl;
-                    std::cout << "CLIENT successfully got puuid for '" << game_name << "#" << tag_line << "'" << std::endl;
-                    _.riot.get_challenges_by_puuid_async(
-                        riot_api::REGION_EUW, resulting_puuid,
-                        [game_name, tag_line](const nlohmann::json& resulting_challenges_info_for_puuid) {
-                            std::cout << "CLIENT successfully got account_challenges for '" << game_name << "#" << tag_line << "'" << std::endl;
-                            _.account_challenges = resulting_challenges_info_for_puuid;
-                            std::ofstream f("account_challenges.json");
-                            f << resulting_challenges_info_for_puuid.dump(4) << std::endl;
-
-                            _.riot.get_challenges_info_async(
-                                riot_api::REGION_EUW,
-                                [](const nlohmann::json& resulting_challenges_info) {
-                                    std::ofstream f("global_challenges.json");
-                                    f << resulting_challenges_info.dump(4) << std::endl;
-
-                                    std::vector<int> ids;
-                                    for (const nlohmann::json& j : resulting_challenges_info) {
-                                        ids.push_back(j["id"]);
-                                    }
-                                    std::sort(ids.begin(), ids.end());
-                                    std::ofstream g("ids.json");
-                                    for (int id : ids) {
-                                        g << id << " -> " << find_parent_id(id) << std::endl;
-                                    }
-
-                                    _.global_challenges = resulting_challenges_info;
-                                    build_challenges(_.global_challenges, _.account_challenges);
-                                },
-                                []() {
-                                }
-                            );
-                        },
-                        [game_name, tag_line]() {
-                            std::cerr << "CLIENT failed to get account_challenges for '" << game_name << "#" << tag_line << "'" << std::endl;
-                        }
-                    );
-                },
-                []() {
-                    std::cerr << "CLIENT failed to get puuid" << std::endl;
-                }
-            );
+            track_account(_.game_name_text_box, _.tag_line_text_box);
+            _.is_adding_account = false;
         }
 
         GuiSetStyle(DEFAULT, TEXT_SIZE, old_font_size);
     }
 
-    if (_.current_challange) {
-        draw_current_challenge();
+    else if (_.current_challange) {
+        draw_accounts_bar({ .x = _.window_w * 0.01f, .y = 0.0f, .width = _.window_w * 0.98f, .height = _.window_h * 0.04f });
+        if (_.is_heatmap_active) {
+            draw_heatmap({ .x = _.window_w * 0.01f, .y = _.window_h * 0.05f, .width = _.window_w * 0.98f, .height = _.window_h * 0.94f });
+        } else if (_.is_leaderboard_active) {
+            draw_leaderboard({ .x = _.window_w * 0.01f, .y = _.window_h * 0.05f, .width = _.window_w * 0.98f, .height = _.window_h * 0.94f });
+        } else {
+            draw_current_challenge();
+        }
     }
     // draw_challenges();
 
@@ -491,73 +610,30 @@ static void draw() {
 }
 
 static void draw_challenges() {
-    if (_.account_challenges.empty()) {
+    if (_.accounts.empty()) {
         return ;
     }
 
     draw_challenges_category_points();
 }
 
-static std::string tier_to_next_tier(const std::string& tier) {
-    if (tier == "NONE") {
-        return "UNRANKED";
-    } else if (tier == "UNRANKED") {
-        return "IRON";
-    } else if (tier == "IRON") {
-        return "BRONZE";
-    } else if (tier == "BRONZE") {
-        return "SILVER";
-    } else if (tier == "SILVER") {
-        return "GOLD";
-    } else if (tier == "GOLD") {
-        return "PLATINUM";
-    } else if (tier == "PLATINUM") {
-        return "EMERALD";
-    } else if (tier == "EMERALD") {
-        return "DIAMOND";
-    } else if (tier == "DIAMOND") {
-        return "MASTER";
-    } else if (tier == "MASTER") {
-        return "GRANDMASTER";
-    } else if (tier == "GRANDMASTER") {
-        return "CHALLENGER";
-    } else if (tier == "CHALLENGER") {
-        return "CHALLENGER";
-    } else {
-        assert(0);
-        return "";
-    }
-}
-
-static Color tier_to_color(const std::string& tier) {
+static Color tier_to_color(tier_t tier) {
     Color result = BLACK;
 
-    if (tier == "NONE") {
-        result = Color{ 255, 20, 20, 20 };
-    } else if (tier == "UNRANKED") {
-        result = Color{ 255, 66, 51, 48 };
-    } else if (tier == "IRON") {
-        result = Color{ 255, 66, 51, 48 };
-    } else if (tier == "BRONZE") {
-        result = Color{ 255, 90, 62, 58 };
-    } else if (tier == "SILVER") {
-        result = Color{ 255, 111, 128, 138 };
-    } else if (tier == "GOLD") {
-        result = Color{ 255, 169, 135, 76 };
-    } else if (tier == "PLATINUM") {
-        result = Color{ 255, 86, 156, 186 };
-    } else if (tier == "EMERALD") {
-        result = Color{ 255, 53, 127, 103 };
-    } else if (tier == "DIAMOND") {
-        result = Color{ 255, 78, 146, 188 };
-    } else if (tier == "MASTER") {
-        result = Color{ 255, 187, 95, 236 };
-    } else if (tier == "GRANDMASTER") {
-        result = Color{ 255, 159, 43, 40 };
-    } else if (tier == "CHALLENGER") {
-        result = Color{ 255, 213, 176, 96 };
-    } else {
-        assert(0);
+    switch (tier) {
+    case TIER_NONE:        result = Color{ 255, 20, 20, 20 }; break ;
+    case TIER_UNRANKED:    result = Color{ 255, 66, 51, 48 }; break ;
+    case TIER_IRON:        result = Color{ 255, 66, 51, 48 }; break ;
+    case TIER_BRONZE:      result = Color{ 255, 90, 62, 58 }; break ;
+    case TIER_SILVER:      result = Color{ 255, 111, 128, 138 }; break ;
+    case TIER_GOLD:        result = Color{ 255, 169, 135, 76 }; break ;
+    case TIER_PLATINUM:    result = Color{ 255, 86, 156, 186 }; break ;
+    case TIER_EMERALD:     result = Color{ 255, 53, 127, 103 }; break ;
+    case TIER_DIAMOND:     result = Color{ 255, 78, 146, 188 }; break ;
+    case TIER_MASTER:      result = Color{ 255, 187, 95, 236 }; break ;
+    case TIER_GRANDMASTER: result = Color{ 255, 159, 43, 40 }; break ;
+    case TIER_CHALLENGER:  result = Color{ 255, 213, 176, 96 }; break ;
+    default: assert(0);
     }
 
     return result;
@@ -614,8 +690,9 @@ static void draw_challenge_description(challenge_t* node, const Rectangle& rec,
     draw_text_in_rec(node_description, rec);
 }
 
-static void draw_challenge_icon(challenge_t* node, const Rectangle& rec) {
-    if (node->icon.id <= 0) {
+static void draw_challenge_icon(challenge_t* node, tier_t tier, const Rectangle& rec) {
+    Texture2D icon = challenge_icon(node, tier);
+    if (icon.id <= 0) {
         return ;
     }
 
@@ -626,8 +703,8 @@ static void draw_challenge_icon(challenge_t* node, const Rectangle& rec) {
         .height = rec.height
     };
     DrawTexturePro(
-        node->icon,
-        { .x = 0.0f, .y = 0.0f, .width = static_cast<float>(node->icon.width), .height = static_cast<float>(node->icon.height) },
+        icon,
+        { .x = 0.0f, .y = 0.0f, .width = static_cast<float>(icon.width), .height = static_cast<float>(icon.height) },
         square,
         { 0.0f, 0.0f },
         0.0f,
@@ -635,13 +712,14 @@ static void draw_challenge_icon(challenge_t* node, const Rectangle& rec) {
     );
 }
 
-static void draw_challenge_top(challenge_t* node, const Rectangle& rec, int is_detailed) {
+static void draw_challenge_top(const challenge_progress_t& progress, const Rectangle& rec, int is_detailed) {
     char buffer[64];
-    snprintf(buffer, ARRAY_SIZE(buffer), "top %.2f%%", node->percentile * 100.0f);
+    snprintf(buffer, ARRAY_SIZE(buffer), "top %.2f%%", progress.percentile * 100.0f);
     draw_text_in_rec(buffer, rec);
 }
 
-static void draw_challenge_value_bar(challenge_t* node, const Rectangle& rec) {
+static void draw_challenge_value_bar(challenge_t* node, const challenge_progress_t& progress, const Rectangle& rec) {
+    const double next_value = challenge_next_value(*node, progress.value);
     const float y_margin = rec.height * 0.01f;
     float y_fill = 1.0f;
     const float value_rec_y_fill = y_fill * 0.2f;
@@ -652,10 +730,10 @@ static void draw_challenge_value_bar(challenge_t* node, const Rectangle& rec) {
         .height = rec.height * value_rec_y_fill - y_margin
     };
     char buffer[64];
-    snprintf(buffer, ARRAY_SIZE(buffer), "value: %.2f, next value: %.2f", node->value, node->next_value);
+    snprintf(buffer, ARRAY_SIZE(buffer), "value: %.2f, next value: %.2f", progress.value, next_value);
     draw_text_in_rec(buffer, value_rec);
 
-    const float percentile = node->next_value < node->value ? 0 : node->value / node->next_value;
+    const float percentile = next_value < progress.value ? 0 : progress.value / next_value;
     Color fill_color = YELLOW;
     Color empty_color = GRAY;
 
@@ -677,19 +755,52 @@ static void draw_challenge_value_bar(challenge_t* node, const Rectangle& rec) {
     DrawRectangleRec(empty_rec, empty_color);
 }
 
-static void draw_challenge_specifics(challenge_t* node, const Rectangle& rec) {
-    if (node->id == 303510) {
-        // todo(david): left here
-        // display shurima champion icons
-    } else {
+static void draw_challenge_forecast(const account_t& account, challenge_t* node, const challenge_progress_t& progress, const Rectangle& rec) {
+    const double next_value = challenge_next_value(*node, progress.value);
+    if (next_value <= progress.value) {
+        return ;
+    }
+
+    const forecast_t* forecast = _.forecaster.find(account.m_puuid, node->slot);
+    const int64_t eta = forecast ? forecast_eta(*forecast, next_value) : 0;
+    const int64_t max_eta_from_now = 10ll * 365 * 24 * 60 * 60;
+    const int64_t now = time(0);
+    if (eta == 0 || now + max_eta_from_now < eta) {
+        draw_text_in_rec("next value: no recent progress", rec);
+        return ;
+    }
+
+    char date[32];
+    const time_t eta_time = static_cast<time_t>(eta);
+    strftime(date, ARRAY_SIZE(date), "%Y-%m-%d", localtime(&eta_time));
+    char buffer[128];
+    snprintf(buffer, ARRAY_SIZE(buffer), "next value around %s (%.2f / day)", date, forecast_rate(*forecast) * 24.0 * 60.0 * 60.0);
+    draw_text_in_rec(buffer, rec);
+}
+
+static void draw_challenge_specifics(const account_t& account, challenge_t* node, const Rectangle& rec) {
+    std::vector<std::pair<std::string, double>> champion_values;
+    _.attribution.champion_breakdown(account.m_puuid, node->id, &champion_values);
+    if (champion_values.empty()) {
         return ;
     }
+
+    std::string text = "from tracked matches:";
+    const size_t max_champions = 5;
+    for (size_t champion_index = 0; champion_index < champion_values.size() && champion_index < max_champions; ++champion_index) {
+        text += TextFormat(" %s %g", champion_values[champion_index].first.c_str(), champion_values[champion_index].second);
+    }
+    if (max_champions < champion_values.size()) {
+        text += TextFormat(" and %zu more", champion_values.size() - max_champions);
+    }
+    draw_text_in_rec(text.c_str(), rec);
 }
 
-static void draw_challenge(challenge_t* node, const Rectangle& rec, int is_detailed) {
+static void draw_challenge(const account_t& account, challenge_t* node, const Rectangle& rec, int is_detailed) {
+    const challenge_progress_t& progress = account.m_progress[node->slot];
     DrawRectangleRec(
         rec,
-        tier_to_color(node->tier)
+        tier_to_color(progress.tier)
     );
 
     if (is_detailed) {
@@ -706,7 +817,7 @@ static void draw_challenge(challenge_t* node, const Rectangle& rec, int is_detai
             .height = rec.height * challenge_icon_rec_y_fill - y_margin
         };
         y += challenge_icon_rec.height + y_margin;
-        draw_challenge_icon(node, challenge_icon_rec);
+        draw_challenge_icon(node, progress.tier, challenge_icon_rec);
 
         const float description_rec_y_fill = y_fill * 0.25f;
         y_fill -= description_rec_y_fill;
@@ -728,7 +839,18 @@ static void draw_challenge(challenge_t* node, const Rectangle& rec, int is_detai
             .height = rec.height * top_rec_y_fill - y_margin
         };
         y += top_rec.height + y_margin;
-        draw_challenge_top(node, top_rec, is_detailed);
+        draw_challenge_top(progress, top_rec, is_detailed);
+
+        const float forecast_rec_y_fill = y_fill * 0.1f;
+        y_fill -= forecast_rec_y_fill;
+        Rectangle forecast_rec = {
+            .x = rec.x,
+            .y = y,
+            .width = rec.width,
+            .height = rec.height * forecast_rec_y_fill - y_margin
+        };
+        y += forecast_rec.height + y_margin;
+        draw_challenge_forecast(account, node, progress, forecast_rec);
 
         const float value_bar_y_fill = y_fill * 0.2f;
         y_fill -= value_bar_y_fill;
@@ -739,8 +861,7 @@ static void draw_challenge(challenge_t* node, const Rectangle& rec, int is_detai
             .height = rec.height * value_bar_y_fill - y_margin
         };
         y += value_bar_rec.height + y_margin;
-        draw_challenge_value_bar(node, value_bar_rec);
-
+        draw_challenge_value_bar(node, progress, value_bar_rec);
 
         const float challenge_specifics_rec_y_fill = y_fill;
         y_fill -= challenge_specifics_rec_y_fill;
@@ -751,17 +872,95 @@ static void draw_challenge(challenge_t* node, const Rectangle& rec, int is_detai
             .height = rec.height * challenge_specifics_rec_y_fill - y_margin
         };
         y += challenge_specifics_rec.height + y_margin;
-        draw_challenge_specifics(node, challenge_specifics_rec);
+        draw_challenge_specifics(account, node, challenge_specifics_rec);
     } else {
         draw_challenge_description(node, rec, is_detailed);
     }
 }
 
+static void draw_accounts_bar(const Rectangle& rec) {
+    const float margin = 5.0f;
+    const size_t n_of_buttons = _.accounts.size() + 3;
+    const float button_width = std::min(300.0f, (rec.width - margin * (n_of_buttons - 1)) / n_of_buttons);
+    Rectangle button_rec = {
+        .x = rec.x,
+        .y = rec.y + margin,
+        .width = button_width,
+        .height = rec.height - margin
+    };
+
+    for (size_t account_index = 0; account_index < _.accounts.size(); ++account_index) {
+        const account_t& account = _.accounts[account_index];
+        const char* label = TextFormat("%s%s#%s", account_index == _.current_account ? "> " : "", account.m_game_name.c_str(), account.m_tag_line.c_str());
+        if (GuiButton(button_rec, label)) {
+            _.current_account = account_index;
+        }
+        button_rec.x += button_rec.width + margin;
+    }
+
+    if (GuiButton(button_rec, "+")) {
+        _.is_adding_account = true;
+    }
+    button_rec.x += button_rec.width + margin;
+
+    if (GuiButton(button_rec, _.is_leaderboard_active ? "Challenges" : "Leaderboard")) {
+        _.is_leaderboard_active = !_.is_leaderboard_active;
+        _.is_heatmap_active = false;
+    }
+    button_rec.x += button_rec.width + margin;
+
+    if (GuiButton(button_rec, _.is_heatmap_active ? "Challenges" : "Heatmap")) {
+        _.is_heatmap_active = !_.is_heatmap_active;
+        _.is_leaderboard_active = false;
+    }
+    button_rec.x += button_rec.width + margin;
+
+    // the game running on this machine, in the space left of the bar
+    const live_player_t* live_player = _.live_state.active_player();
+    if (live_player && button_rec.x < rec.x + rec.width) {
+        const int game_seconds = static_cast<int>(_.live_state.game_time);
+        std::string text = TextFormat(
+            "live %d:%02d %s %d/%d/%d %d cs %.0f ward score",
+            game_seconds / 60, game_seconds % 60, live_player->champion_name.c_str(),
+            live_player->kills, live_player->deaths, live_player->assists, live_player->creep_score, live_player->ward_score
+        );
+        if (!_.live_state.events.empty()) {
+            text += TextFormat(", last %s", _.live_state.events.back().name.c_str());
+        }
+        // the challenges the game advances, for the tracked account playing it
+        for (const account_t& account : _.accounts) {
+            if (account.m_game_name + "#" + account.m_tag_line != _.live_state.active_riot_id) {
+                continue ;
+            }
+            _.live_stats = {
+                { .field = "kills", .value = static_cast<double>(live_player->kills) },
+                { .field = "deaths", .value = static_cast<double>(live_player->deaths) },
+                { .field = "assists", .value = static_cast<double>(live_player->assists) },
+                { .field = "visionScore", .value = live_player->ward_score }
+            };
+            _.attribution.live_contributions(account.m_puuid, _.live_state.game_mode, live_player->champion_name, _.live_stats, &_.live_contributions);
+            for (const attribution_live_contribution_t& contribution : _.live_contributions) {
+                const uint32_t slot = _.catalog.id_to_slot(contribution.challenge_id);
+                if (slot == UINT32_MAX) {
+                    continue ;
+                }
+                text += TextFormat(
+                    ", %s %.0f +%.0f%s",
+                    _.catalog.m_challenges[slot].name.c_str(), account.m_progress[slot].value, contribution.value, contribution.is_win_required ? " if won" : ""
+                );
+            }
+            break ;
+        }
+        draw_text_in_rec(text.c_str(), { .x = button_rec.x, .y = button_rec.y, .width = rec.x + rec.width - button_rec.x, .height = button_rec.height });
+    }
+}
+
 static void draw_current_challenge() {
     challenge_t* node      = _.current_challange;
     challenge_t* next_node = _.current_challange;
+    const account_t& account = _.accounts[_.current_account];
 
-    Rectangle outer_rec = { .x = _.window_w * 0.01f, .y = _.window_h * 0.01f, .width = _.window_w * 0.98f, .height = _.window_h * 0.98f };
+    Rectangle outer_rec = { .x = _.window_w * 0.01f, .y = _.window_h * 0.05f, .width = _.window_w * 0.98f, .height = _.window_h * 0.94f };
     DrawRectangleLinesEx(
         outer_rec,
         1.0f,
@@ -820,7 +1019,7 @@ static void draw_current_challenge() {
                     .height = state.rec.height * 0.6f
                 };
 
-                draw_challenge(child_node, child_node_rec, 0);
+                draw_challenge(account, child_node, child_node_rec, 0);
 
                 if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && is_within(mouse_p, child_node_rec)) {
                     next_node = child_node;
@@ -828,7 +1027,7 @@ static void draw_current_challenge() {
             }
         }
     } else {
-        draw_challenge(node, outer_rec, 1);
+        draw_challenge(account, node, outer_rec, 1);
     }
 
     if (node != next_node) {
@@ -840,16 +1039,172 @@ static void draw_current_challenge() {
     _.current_challange = node;
 }
 
+static void draw_leaderboard(const Rectangle& rec) {
+    challenge_t* node = _.current_challange;
+    const size_t top_k = 10;
+    const float margin = 5.0f;
+
+    DrawRectangleLinesEx(rec, 1.0f, WHITE);
+
+    const Rectangle title_rec = {
+        .x = rec.x,
+        .y = rec.y + margin,
+        .width = rec.width,
+        .height = rec.height * 0.08f
+    };
+    draw_text_in_rec(node->name.c_str(), title_rec);
+
+    const float column_width = rec.width / 2.0f;
+    const float row_height = rec.height * 0.5f / (top_k + 1);
+    const float columns_y = title_rec.y + title_rec.height + margin;
+    const auto draw_column = [&](float x, const char* header, const std::vector<leaderboard_entry_t>& entries, bool is_gain) {
+        draw_text_in_rec(header, { .x = x, .y = columns_y, .width = column_width, .height = row_height });
+        for (size_t entry_index = 0; entry_index < entries.size(); ++entry_index) {
+            const leaderboard_entry_t& entry = entries[entry_index];
+            const account_t& account = _.accounts[entry.account];
+            const float value = _.leaderboard.m_values[node->slot * _.leaderboard.m_n_of_accounts + entry.account];
+            const char* text = is_gain ?
+                TextFormat("%zu. %s#%s +%.0f", entry_index + 1, account.m_game_name.c_str(), account.m_tag_line.c_str(), entry.score) :
+                TextFormat("%zu. %s#%s %.1f%% (%.0f)", entry_index + 1, account.m_game_name.c_str(), account.m_tag_line.c_str(), entry.score * 100.0f, value);
+            draw_text_in_rec(text, { .x = x, .y = columns_y + (entry_index + 1) * row_height, .width = column_width, .height = row_height });
+        }
+    };
+
+    std::vector<leaderboard_entry_t> entries;
+    _.leaderboard.top_k_closest_to_next_tier(node->slot, top_k, &entries);
+    draw_column(rec.x, "Closest to next tier", entries, false);
+    _.leaderboard.top_k_gain(node->slot, top_k, &entries);
+    draw_column(rec.x + column_width, "Gained this week", entries, true);
+
+    // category sums, one row per account
+    std::vector<float> category_sums;
+    _.leaderboard.category_sums({}, &category_sums);
+    const float table_y = columns_y + (top_k + 1) * row_height + margin;
+    const float table_row_height = std::min(row_height, (rec.y + rec.height - table_y) / (_.accounts.size() + 1));
+    const float table_column_width = rec.width / (_CATEGORY_SIZE + 1);
+    for (int category = 0; category < _CATEGORY_SIZE; ++category) {
+        draw_text_in_rec(category_to_str(static_cast<category_t>(category)), { .x = rec.x + (category + 1) * table_column_width, .y = table_y, .width = table_column_width, .height = table_row_height });
+    }
+    for (size_t account_index = 0; account_index < _.accounts.size(); ++account_index) {
+        const account_t& account = _.accounts[account_index];
+        const float y = table_y + (account_index + 1) * table_row_height;
+        draw_text_in_rec(TextFormat("%s#%s", account.m_game_name.c_str(), account.m_tag_line.c_str()), { .x = rec.x, .y = y, .width = table_column_width, .height = table_row_height });
+        for (int category = 0; category < _CATEGORY_SIZE; ++category) {
+            const float category_sum = category_sums[category * _.leaderboard.m_n_of_accounts + account_index];
+            draw_text_in_rec(TextFormat("%.1f", category_sum), { .x = rec.x + (category + 1) * table_column_width, .y = y, .width = table_column_width, .height = table_row_height });
+        }
+    }
+
+    if (IsMouseButtonPressed(MOUSE_RIGHT_BUTTON) && node->parent) {
+        _.current_challange = node->parent;
+    }
+}
+
+static const char* champion_name(int champion_id) {
+    for (const nlohmann::json& champion : _.champions_info) {
+        if (champion.value("id", 0) == champion_id) {
+            auto name_it = champion.find("name");
+            if (name_it != champion.end() && name_it->is_string()) {
+                return name_it->get_ref<const std::string&>().c_str();
+            }
+        }
+    }
+
+    return "unknown champion";
+}
+
+static void draw_heatmap(const Rectangle& rec) {
+    const account_t& account = _.accounts[_.current_account];
+    const float margin = 5.0f;
+
+    DrawRectangleLinesEx(rec, 1.0f, WHITE);
+
+    heatmap_filter_t& filter = _.heatmap_filter;
+    if (filter.puuid != account.m_puuid) {
+        filter.puuid = account.m_puuid;
+        filter.champion_id = 0;
+    }
+    const uint64_t version = _.heatmap.version();
+    if (_.heatmap_texture.id == 0 || version != _.heatmap_texture_version || !(filter == _.heatmap_texture_filter)) {
+        if (version != _.heatmap_texture_version || filter.puuid != _.heatmap_texture_filter.puuid) {
+            _.heatmap.champion_ids(filter.puuid, &_.heatmap_champion_ids);
+        }
+        heatmap_grid_t grid;
+        _.heatmap.accumulate(filter, HEATMAP_RESOLUTION, &grid);
+        _.heatmap_n_of_points = grid.n_of_points;
+        heatmap_blur(&grid, 2.0f);
+        heatmap_normalize(&grid);
+        heatmap_upload_texture(grid, &_.heatmap_texture);
+        _.heatmap_texture_filter = filter;
+        _.heatmap_texture_version = version;
+    }
+
+    // filters in a column left of the map, each button cycles through its values
+    Rectangle button_rec = {
+        .x = rec.x + margin,
+        .y = rec.y + margin,
+        .width = std::min(300.0f, rec.width * 0.2f),
+        .height = rec.height * 0.05f
+    };
+    if (GuiButton(button_rec, heatmap_layer_to_str(filter.layer))) {
+        filter.layer = static_cast<heatmap_layer_t>((filter.layer + 1) % _HEATMAP_LAYER_SIZE);
+    }
+    button_rec.y += button_rec.height + margin;
+
+    if (GuiButton(button_rec, filter.role < 0 ? "all roles" : heatmap_role_to_str(static_cast<heatmap_role_t>(filter.role)))) {
+        filter.role = filter.role + 1 < HEATMAP_ROLE_UNKNOWN ? filter.role + 1 : -1;
+    }
+    button_rec.y += button_rec.height + margin;
+
+    if (GuiButton(button_rec, filter.champion_id ? champion_name(filter.champion_id) : "all champions")) {
+        auto champion_id_it = std::upper_bound(_.heatmap_champion_ids.begin(), _.heatmap_champion_ids.end(), filter.champion_id);
+        filter.champion_id = champion_id_it == _.heatmap_champion_ids.end() ? 0 : *champion_id_it;
+    }
+    button_rec.y += button_rec.height + margin;
+
+    draw_text_in_rec(TextFormat("%llu events", static_cast<unsigned long long>(_.heatmap_n_of_points)), button_rec);
+
+    const float map_size = std::min(rec.height - 2.0f * margin, rec.width - button_rec.width - 3.0f * margin);
+    const Rectangle map_rec = {
+        .x = button_rec.x + button_rec.width + margin,
+        .y = rec.y + margin,
+        .width = map_size,
+        .height = map_size
+    };
+    // no minimap art ships with the tracker, the lanes, the river and the bases are drawn underneath instead
+    auto map_point = [&map_rec](float x, float y) {
+        return Vector2{ .x = map_rec.x + x * map_rec.width, .y = map_rec.y + (1.0f - y) * map_rec.height };
+    };
+    const float lane_thickness = map_size * 0.03f;
+    const Color lane_color = Color{ 70, 70, 55, 255 };
+    DrawRectangleRec(map_rec, Color{ 20, 40, 20, 255 });
+    DrawLineEx(map_point(0.15f, 0.85f), map_point(0.85f, 0.15f), lane_thickness * 2.0f, Color{ 25, 45, 70, 255 });
+    DrawLineEx(map_point(0.07f, 0.07f), map_point(0.07f, 0.93f), lane_thickness, lane_color);
+    DrawLineEx(map_point(0.07f, 0.93f), map_point(0.93f, 0.93f), lane_thickness, lane_color);
+    DrawLineEx(map_point(0.07f, 0.07f), map_point(0.93f, 0.93f), lane_thickness, lane_color);
+    DrawLineEx(map_point(0.07f, 0.07f), map_point(0.93f, 0.07f), lane_thickness, lane_color);
+    DrawLineEx(map_point(0.93f, 0.07f), map_point(0.93f, 0.93f), lane_thickness, lane_color);
+    DrawCircleV(map_point(0.07f, 0.07f), lane_thickness * 2.0f, Color{ 40, 70, 130, 255 });
+    DrawCircleV(map_point(0.93f, 0.93f), lane_thickness * 2.0f, Color{ 130, 40, 40, 255 });
+    DrawRectangleLinesEx(map_rec, 1.0f, GRAY);
+    if (_.heatmap_texture.id != 0) {
+        DrawTexturePro(
+            _.heatmap_texture,
+            { .x = 0.0f, .y = 0.0f, .width = static_cast<float>(_.heatmap_texture.width), .height = static_cast<float>(_.heatmap_texture.height) },
+            map_rec,
+            { 0.0f, 0.0f },
+            0.0f,
+            WHITE
+        );
+    }
+}
+
 static void draw_challenges_category_points() {
-    if (_.account_challenges.empty()) {
+    if (_.accounts.empty()) {
         return ;
     }
 
-    const nlohmann::json& collection  = _.account_challenges["categoryPoints"]["COLLECTION"];
-    const nlohmann::json& expertise   = _.account_challenges["categoryPoints"]["EXPERTISE"];
-    const nlohmann::json& imagination = _.account_challenges["categoryPoints"]["IMAGINATION"];
-    const nlohmann::json& teamwork    = _.account_challenges["categoryPoints"]["TEAMWORK"];
-    const nlohmann::json& veterancy   = _.account_challenges["categoryPoints"]["VETERANCY"];
+    const account_t& account = _.accounts[_.current_account];
 
     Vector2 margin = {
         .x = 20,
@@ -885,30 +1240,14 @@ static void draw_challenges_category_points() {
     DrawTextEx(_.liberation_mono, "Max",        { columns[3], rows[0] }, font_size, font_spacing, WHITE);
     DrawTextEx(_.liberation_mono, "Percentile", { columns[4], rows[0] }, font_size, font_spacing, WHITE);
 
-    DrawTextEx(_.liberation_mono, TextFormat("%d", static_cast<int>(collection["current"])),                  { columns[1], rows[1] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, static_cast<std::string>(collection["level"]).c_str(),                      { columns[2], rows[1] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, TextFormat("%d", static_cast<int>(collection["max"])),                      { columns[3], rows[1] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, TextFormat("%.2lf", 100.0 * static_cast<double>(collection["percentile"])), { columns[4], rows[1] }, font_size, font_spacing, WHITE);
-
-    DrawTextEx(_.liberation_mono, TextFormat("%d", static_cast<int>(expertise["current"])),                  { columns[1], rows[2] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, static_cast<std::string>(expertise["level"]).c_str(),                      { columns[2], rows[2] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, TextFormat("%d", static_cast<int>(expertise["max"])),                      { columns[3], rows[2] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, TextFormat("%.2lf", 100.0 * static_cast<double>(expertise["percentile"])), { columns[4], rows[2] }, font_size, font_spacing, WHITE);
-
-    DrawTextEx(_.liberation_mono, TextFormat("%d", static_cast<int>(imagination["current"])),                  { columns[1], rows[3] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, static_cast<std::string>(imagination["level"]).c_str(),                      { columns[2], rows[3] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, TextFormat("%d", static_cast<int>(imagination["max"])),                      { columns[3], rows[3] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, TextFormat("%.2lf", 100.0 * static_cast<double>(imagination["percentile"])), { columns[4], rows[3] }, font_size, font_spacing, WHITE);
-
-    DrawTextEx(_.liberation_mono, TextFormat("%d", static_cast<int>(teamwork["current"])),                  { columns[1], rows[4] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, static_cast<std::string>(teamwork["level"]).c_str(),                      { columns[2], rows[4] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, TextFormat("%d", static_cast<int>(teamwork["max"])),                      { columns[3], rows[4] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, TextFormat("%.2lf", 100.0 * static_cast<double>(teamwork["percentile"])), { columns[4], rows[4] }, font_size, font_spacing, WHITE);
-
-    DrawTextEx(_.liberation_mono, TextFormat("%d", static_cast<int>(veterancy["current"])),                  { columns[1], rows[5] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, static_cast<std::string>(veterancy["level"]).c_str(),                      { columns[2], rows[5] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, TextFormat("%d", static_cast<int>(veterancy["max"])),                      { columns[3], rows[5] }, font_size, font_spacing, WHITE);
-    DrawTextEx(_.liberation_mono, TextFormat("%.2lf", 100.0 * static_cast<double>(veterancy["percentile"])), { columns[4], rows[5] }, font_size, font_spacing, WHITE);
+    for (int category = 0; category < _CATEGORY_SIZE; ++category) {
+        const category_points_t& category_points = account.m_category_points[category];
+        const float row = rows[category + 1];
+        DrawTextEx(_.liberation_mono, TextFormat("%d", category_points.current),               { columns[1], row }, font_size, font_spacing, WHITE);
+        DrawTextEx(_.liberation_mono, tier_to_str(category_points.level),                      { columns[2], row }, font_size, font_spacing, WHITE);
+        DrawTextEx(_.liberation_mono, TextFormat("%d", category_points.max),                   { columns[3], row }, font_size, font_spacing, WHITE);
+        DrawTextEx(_.liberation_mono, TextFormat("%.2lf", 100.0 * category_points.percentile), { columns[4], row }, font_size, font_spacing, WHITE);
+    }
 }
 
 #if defined(PLATFORM_WEB)
@@ -919,6 +1258,21 @@ static void update_and_draw() {
 #endif
 
 static void destroy() {
+    // queued riot requests fail right away, the ingester only waits for the ones in flight
+    _.riot.destroy();
+    _.live_client.destroy();
+    _.match_ingester.destroy();
+    // runs what is still queued on the pool's executor, timeline callbacks among it add to the stores closed below
+    _.http_pool.destroy();
+    _.match_store.close();
+    _.attribution.close();
+    _.heatmap.close();
+    _.pending_matches.close();
+    if (_.heatmap_texture.id != 0) {
+        UnloadTexture(_.heatmap_texture);
+    }
+    _.riot_cache.close();
+    _.persistence_writer.destroy();
     CloseWindow();
 }
 
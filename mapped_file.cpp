@@ -0,0 +1,50 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+mapped_file_t::~mapped_file_t() {
+    close();
+}
+
+int mapped_file_t::open(const std::string& path) {
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return 1;
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat)) {
+        ::close(fd);
+        return 1;
+    }
+
+    m_size = static_cast<size_t>(file_stat.st_size);
+    if (m_size == 0) {
+        // mmap rejects empty mappings
+        ::close(fd);
+        return 0;
+    }
+
+    void* data = mmap(0, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        m_size = 0;
+        return 1;
+    }
+    m_data = static_cast<const unsigned char*>(data);
+
+    return 0;
+}
+
+void mapped_file_t::close() {
+    if (m_data) {
+        munmap(const_cast<unsigned char*>(m_data), m_size);
+    }
+    m_data = 0;
+    m_size = 0;
+}
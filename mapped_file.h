@@ -0,0 +1,20 @@
+#ifndef MAPPED_FILE_H
+# define MAPPED_FILE_H
+
+# include <string>
+
+// read only view of a whole file, mapped instead of read
+struct mapped_file_t {
+    mapped_file_t() = default;
+    mapped_file_t(const mapped_file_t&) = delete;
+    mapped_file_t& operator=(const mapped_file_t&) = delete;
+    ~mapped_file_t();
+
+    int  open(const std::string& path);
+    void close();
+
+    const unsigned char* m_data = 0;
+    size_t               m_size = 0;
+};
+
+#endif // MAPPED_FILE_H
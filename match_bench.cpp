@@ -0,0 +1,171 @@
+#include "match_store.h"
+#include "match_stats.h"
+#include "match_kernels.h"
+
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <filesystem>
+#include <unordered_map>
+
+/**
+ * Per champion win rate, kda and damage per minute of ranked solo games in a time window,
+ * once by walking the match jsons as the tracker used to keep them and once through the match store with every kernel isa.
+ *
+ * Example call:
+ * ./match_bench 20000
+*/
+
+static const char* const champion_names[] = {
+    "Ahri", "Zed", "Lux", "Jinx", "Thresh", "LeeSin", "Yasuo", "Ezreal", "Leona", "Darius",
+    "Garen", "Annie", "Ashe", "Vayne", "Orianna", "Sett", "Kaisa", "Viego", "Nami", "Ornn"
+};
+static const char* const roles[] = { "TOP", "JUNGLE", "MIDDLE", "BOTTOM", "UTILITY" };
+static const char* const stat_names[] = {
+    "kills", "deaths", "assists", "totalDamageDealtToChampions", "totalDamageTaken", "goldEarned", "totalMinionsKilled",
+    "visionScore", "wardsPlaced", "wardsKilled", "champLevel", "damageDealtToBuildings", "damageSelfMitigated",
+    "totalHeal", "timeCCingOthers", "doubleKills", "tripleKills", "largestKillingSpree", "neutralMinionsKilled", "turretKills"
+};
+static const char* const challenge_names[] = {
+    "kda", "killParticipation", "damagePerMinute", "goldPerMinute", "visionScorePerMinute", "soloKills", "skillshotsDodged", "teamDamagePercentage"
+};
+
+struct champion_totals_t {
+    uint64_t n_of_games   = 0;
+    uint64_t n_of_wins    = 0;
+    double   n_of_seconds = 0.0;
+    double   kills        = 0.0;
+    double   deaths       = 0.0;
+    double   assists      = 0.0;
+    double   damage       = 0.0;
+};
+
+static std::vector<nlohmann::json> generate_matches(size_t n_of_matches) {
+    std::mt19937 random_engine(42);
+    std::vector<nlohmann::json> result;
+    result.reserve(n_of_matches);
+    for (size_t match = 0; match < n_of_matches; ++match) {
+        nlohmann::json match_info;
+        match_info["metadata"]["matchId"] = "EUW1_" + std::to_string(6000000000ull + match);
+        nlohmann::json& info = match_info["info"];
+        info["gameCreation"] = 1700000000000ll + static_cast<int64_t>(match) * 600000;
+        info["gameDuration"] = 1200 + random_engine() % 1200;
+        info["gameEndTimestamp"] = info["gameCreation"].get<int64_t>() + info["gameDuration"].get<int64_t>() * 1000;
+        info["queueId"] = random_engine() % 4 ? 420 : 440;
+        for (int participant = 0; participant < 10; ++participant) {
+            nlohmann::json participant_info;
+            participant_info["puuid"] = "puuid-" + std::to_string(random_engine() % 5000);
+            participant_info["championName"] = champion_names[random_engine() % (sizeof(champion_names) / sizeof(champion_names[0]))];
+            participant_info["championId"] = random_engine() % 900;
+            participant_info["teamPosition"] = roles[participant % 5];
+            participant_info["teamId"] = participant < 5 ? 100 : 200;
+            participant_info["win"] = (participant < 5) == (match % 2 == 0);
+            for (size_t stat = 0; stat < sizeof(stat_names) / sizeof(stat_names[0]); ++stat) {
+                // kills, deaths and assists first
+                participant_info[stat_names[stat]] = stat < 3 ? random_engine() % 20 : random_engine() % 40000;
+            }
+            for (const char* challenge_name : challenge_names) {
+                participant_info["challenges"][challenge_name] = static_cast<double>(random_engine() % 10000) / 100.0;
+            }
+            info["participants"].push_back(std::move(participant_info));
+        }
+        result.push_back(std::move(match_info));
+    }
+
+    return result;
+}
+
+static void summarize_json(const std::vector<nlohmann::json>& matches, int64_t from, int64_t to, std::unordered_map<std::string, champion_totals_t>* result) {
+    result->clear();
+    for (const nlohmann::json& match_info : matches) {
+        const nlohmann::json& info = match_info["info"];
+        const int64_t game_creation = info["gameCreation"].get<int64_t>() / 1000;
+        if (info["queueId"].get<int>() != 420 || game_creation < from || to <= game_creation) {
+            continue ;
+        }
+        const double game_duration = info["gameDuration"].get<double>();
+        for (const nlohmann::json& participant : info["participants"]) {
+            champion_totals_t& totals = (*result)[participant["championName"].get<std::string>()];
+            ++totals.n_of_games;
+            totals.n_of_wins += participant["win"].get<bool>();
+            totals.n_of_seconds += game_duration;
+            totals.kills += participant["kills"].get<double>();
+            totals.deaths += participant["deaths"].get<double>();
+            totals.assists += participant["assists"].get<double>();
+            totals.damage += participant["totalDamageDealtToChampions"].get<double>();
+        }
+    }
+}
+
+template <typename function_t>
+static double best_of_ms(int n_of_runs, const function_t& function) {
+    double result = 1e300;
+    for (int run = 0; run < n_of_runs; ++run) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        result = std::min(result, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    return result;
+}
+
+int main(int argc, char** argv) {
+    const size_t n_of_matches = argc < 2 ? 20000 : std::stoul(argv[1]);
+    const std::string directory = argc < 3 ? "match_bench_store" : argv[2];
+    const int n_of_runs = 5;
+
+    std::cout << "generating " << n_of_matches << " matches" << std::endl;
+    const std::vector<nlohmann::json> matches = generate_matches(n_of_matches);
+    const int64_t from = 1700000000 + static_cast<int64_t>(n_of_matches) * 600 / 4;
+    const int64_t to = 1700000000 + static_cast<int64_t>(n_of_matches) * 600;
+
+    std::filesystem::remove_all(directory);
+    match_store_t store;
+    if (store.open(directory)) {
+        return 1;
+    }
+    const auto append_start = std::chrono::steady_clock::now();
+    for (const nlohmann::json& match_info : matches) {
+        if (store.append(match_info["metadata"]["matchId"].get<std::string>(), match_info)) {
+            return 1;
+        }
+    }
+    store.flush();
+    std::cout << "appended in " << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - append_start).count() << " ms, "
+              << store.m_segments.size() << " segments, " << store.m_columns.size() << " columns" << std::endl;
+
+    std::unordered_map<std::string, champion_totals_t> json_totals;
+    const double json_ms = best_of_ms(n_of_runs, [&]() { summarize_json(matches, from, to, &json_totals); });
+    std::cout << "json      " << json_ms << " ms" << std::endl;
+
+    match_stats_filter_t filter;
+    filter.queue = "420";
+    filter.from = from;
+    filter.to = to;
+    const std::vector<std::string> column_names = { "kills", "deaths", "assists", "totalDamageDealtToChampions" };
+    std::vector<match_stats_t> champion_stats;
+    const match_kernel_isa_t best_isa = match_kernel_isa();
+    for (int isa = MATCH_KERNEL_ISA_SCALAR; isa <= best_isa; ++isa) {
+        match_kernel_set_isa(static_cast<match_kernel_isa_t>(isa));
+        const double store_ms = best_of_ms(n_of_runs, [&]() {
+            match_stats_summarize(&store, filter, MATCH_COLUMN_CHAMPION, column_names, &champion_stats);
+        });
+        std::cout << "store " << match_kernel_isa_name(static_cast<match_kernel_isa_t>(isa)) << " " << store_ms << " ms, " << json_ms / store_ms << "x" << std::endl;
+
+        for (const auto& [champion_name, totals] : json_totals) {
+            const match_stats_t& stats = champion_stats[store.dictionary_code(MATCH_DICTIONARY_CHAMPION, champion_name)];
+            const double json_damage_per_minute = totals.damage / (totals.n_of_seconds / 60.0);
+            if (stats.n_of_games != totals.n_of_games || stats.n_of_wins != totals.n_of_wins || std::abs(stats.per_minute(3) - json_damage_per_minute) > 1e-6 * json_damage_per_minute) {
+                std::cerr << "summaries of " << champion_name << " differ" << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    const match_stats_t& ahri_stats = champion_stats[store.dictionary_code(MATCH_DICTIONARY_CHAMPION, "Ahri")];
+    std::cout << "Ahri: " << ahri_stats.n_of_games << " games, win rate " << ahri_stats.win_rate()
+              << ", kda " << ahri_stats.kda(0, 1, 2) << ", damage per minute " << ahri_stats.per_minute(3) << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,211 @@
+#include "match_ingester.h"
+
+#include <iostream>
+#include <memory>
+#include <algorithm>
+
+match_ingester_t::~match_ingester_t() {
+    destroy();
+}
+
+void match_ingester_t::init(
+    riot_client_t* riot, const match_ingester_config_t& config,
+    std::function<bool(const std::string& match_id)> is_stored,
+    std::function<int(const std::string& match_id, const nlohmann::json& match_info)> on_match,
+    std::function<void()> on_batch
+) {
+    m_riot = riot;
+    m_config = config;
+    m_is_stored = std::move(is_stored);
+    m_on_match = std::move(on_match);
+    m_on_batch = std::move(on_batch);
+    m_decode_executor.init(m_config.n_of_decode_workers);
+}
+
+void match_ingester_t::destroy() {
+    if (m_riot) {
+        wait();
+    }
+    m_decode_executor.destroy();
+}
+
+bool match_ingester_t::is_idle() const {
+    return m_n_of_pending_pages == 0 && m_fetch_queue.empty() && m_n_of_in_flight_fetches == 0 && m_n_of_queued_decodes == 0;
+}
+
+void match_ingester_t::wait() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() {
+        return is_idle();
+    });
+}
+
+void match_ingester_t::ingest_async(riot_api::region_t region, riot_api::game_type_t game_type, const std::string& puuid, size_t n_of_matches) {
+    if (n_of_matches == 0) {
+        return ;
+    }
+
+    std::vector<pending_page_t> pending_pages;
+    std::vector<pending_fetch_t> pending_fetches;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        ++m_n_of_pending_pages;
+        m_page_queue.push_back({ .region = region, .game_type = game_type, .puuid = puuid, .start = 0, .n_of_matches_left = n_of_matches });
+        pending_fetches = take_fetches(&pending_pages);
+    }
+    start(std::move(pending_fetches), std::move(pending_pages));
+}
+
+void match_ingester_t::start(std::vector<pending_fetch_t> pending_fetches, std::vector<pending_page_t> pending_pages) {
+    fetch_matches(std::move(pending_fetches));
+    for (const pending_page_t& pending_page : pending_pages) {
+        fetch_page(pending_page);
+    }
+}
+
+void match_ingester_t::fetch_page(const pending_page_t& pending_page) {
+    const size_t count = std::min(pending_page.n_of_matches_left, std::min<size_t>(m_config.page_size, 100));
+    m_riot->get_match_ids_async(
+        pending_page.region, pending_page.game_type, pending_page.puuid, pending_page.start, count,
+        [this, pending_page, count](const nlohmann::json& resulting_match_ids) {
+            ++m_stats.n_of_pages;
+
+            std::vector<std::string> match_ids;
+            for (const nlohmann::json& match_id : resulting_match_ids) {
+                if (match_id.is_string()) {
+                    match_ids.push_back(match_id.get<std::string>());
+                }
+            }
+            std::vector<bool> is_stored(match_ids.size());
+            for (size_t match_index = 0; match_index < match_ids.size(); ++match_index) {
+                is_stored[match_index] = m_is_stored(match_ids[match_index]);
+            }
+
+            // a full page may have more behind it
+            const bool has_next_page = match_ids.size() == count && count < pending_page.n_of_matches_left;
+            std::vector<pending_page_t> pending_pages;
+            std::vector<pending_fetch_t> pending_fetches;
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                --m_n_of_in_flight_pages;
+                for (size_t match_index = 0; match_index < match_ids.size(); ++match_index) {
+                    if (is_stored[match_index] || !m_seen_match_ids.insert(match_ids[match_index]).second) {
+                        ++m_stats.n_of_skipped;
+                        continue ;
+                    }
+                    m_fetch_queue.push_back({ .region = pending_page.region, .match_id = match_ids[match_index] });
+                }
+                if (has_next_page) {
+                    m_page_queue.push_back({
+                        .region = pending_page.region,
+                        .game_type = pending_page.game_type,
+                        .puuid = pending_page.puuid,
+                        .start = pending_page.start + count,
+                        .n_of_matches_left = pending_page.n_of_matches_left - count
+                    });
+                } else {
+                    --m_n_of_pending_pages;
+                }
+                pending_fetches = take_fetches(&pending_pages);
+            }
+            m_cv.notify_all();
+            start(std::move(pending_fetches), std::move(pending_pages));
+        },
+        [this, pending_page](const riot_error_t& error) {
+            std::cerr << "CLIENT failed to get match ids of '" << pending_page.puuid << "': " << error << std::endl;
+            std::vector<pending_page_t> pending_pages;
+            std::vector<pending_fetch_t> pending_fetches;
+            {
+                std::lock_guard<std::mutex> guard(m_mutex);
+                --m_n_of_in_flight_pages;
+                --m_n_of_pending_pages;
+                pending_fetches = take_fetches(&pending_pages);
+            }
+            m_cv.notify_all();
+            start(std::move(pending_fetches), std::move(pending_pages));
+        }
+    );
+}
+
+std::vector<match_ingester_t::pending_fetch_t> match_ingester_t::take_fetches(std::vector<pending_page_t>* pending_pages) {
+    std::vector<pending_fetch_t> result;
+    while (
+        !m_fetch_queue.empty() &&
+        m_n_of_in_flight_fetches < m_config.max_in_flight_fetches &&
+        m_n_of_in_flight_fetches + m_n_of_queued_decodes < m_config.max_in_flight_fetches + m_config.max_queued_decodes
+    ) {
+        result.push_back(std::move(m_fetch_queue.front()));
+        m_fetch_queue.pop_front();
+        ++m_n_of_in_flight_fetches;
+    }
+
+    // every page in flight may still add a full page of ids, one page at a time gets through even if a page is above the bound
+    const size_t max_page_size = std::min<size_t>(m_config.page_size, 100);
+    while (
+        !m_page_queue.empty() &&
+        (
+            (m_n_of_in_flight_pages == 0 && m_fetch_queue.empty()) ||
+            m_fetch_queue.size() + (m_n_of_in_flight_pages + 1) * max_page_size <= m_config.max_queued_fetches
+        )
+    ) {
+        pending_pages->push_back(std::move(m_page_queue.front()));
+        m_page_queue.pop_front();
+        ++m_n_of_in_flight_pages;
+    }
+
+    return result;
+}
+
+void match_ingester_t::fetch_matches(std::vector<pending_fetch_t> pending_fetches) {
+    for (pending_fetch_t& pending_fetch : pending_fetches) {
+        const std::string match_id = std::move(pending_fetch.match_id);
+        m_riot->get_match_info_async(
+            pending_fetch.region, match_id,
+            [this, match_id](const nlohmann::json& resulting_match_info) {
+                ++m_stats.n_of_fetched;
+                std::shared_ptr<const nlohmann::json> match_info = std::make_shared<const nlohmann::json>(resulting_match_info);
+                {
+                    std::lock_guard<std::mutex> guard(m_mutex);
+                    --m_n_of_in_flight_fetches;
+                    ++m_n_of_queued_decodes;
+                }
+                m_decode_executor.submit([this, match_id, match_info]() {
+                    if (m_on_match(match_id, *match_info)) {
+                        ++m_stats.n_of_failed;
+                    } else {
+                        ++m_stats.n_of_stored;
+                    }
+                    std::vector<pending_page_t> next_pages;
+                    std::vector<pending_fetch_t> next_fetches;
+                    bool is_batch_done = false;
+                    {
+                        std::lock_guard<std::mutex> guard(m_mutex);
+                        is_batch_done = --m_n_of_queued_decodes == 0;
+                        next_fetches = take_fetches(&next_pages);
+                    }
+                    // outside m_mutex, making the batch durable may take a while
+                    if (is_batch_done && m_on_batch) {
+                        m_on_batch();
+                    }
+                    m_cv.notify_all();
+                    start(std::move(next_fetches), std::move(next_pages));
+                });
+            },
+            [this, match_id](const riot_error_t& error) {
+                std::cerr << "CLIENT failed to get match '" << match_id << "': " << error << std::endl;
+                ++m_stats.n_of_failed;
+                std::vector<pending_page_t> next_pages;
+                std::vector<pending_fetch_t> next_fetches;
+                {
+                    std::lock_guard<std::mutex> guard(m_mutex);
+                    --m_n_of_in_flight_fetches;
+                    // not stored, a later ingestion may try it again
+                    m_seen_match_ids.erase(match_id);
+                    next_fetches = take_fetches(&next_pages);
+                }
+                m_cv.notify_all();
+                start(std::move(next_fetches), std::move(next_pages));
+            }
+        );
+    }
+}
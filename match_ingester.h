@@ -0,0 +1,122 @@
+#ifndef MATCH_INGESTER_H
+# define MATCH_INGESTER_H
+
+# include <string>
+# include <functional>
+# include <deque>
+# include <vector>
+# include <unordered_set>
+# include <mutex>
+# include <condition_variable>
+# include <atomic>
+
+# include "json.hpp"
+# include "riot_client.h"
+# include "executor.h"
+
+struct match_ingester_config_t {
+    // match info requests handed to the riot client at once, enough to keep its scheduler at the rate limit
+    size_t max_in_flight_fetches = 32;
+    // fetched matches waiting for a decode worker, fetching pauses while this many are queued
+    size_t max_queued_decodes = 64;
+    // match ids waiting for a fetch, further history pages are only requested while their ids fit
+    size_t max_queued_fetches = 256;
+    size_t n_of_decode_workers = 2;
+    size_t page_size = 100;
+};
+
+struct match_ingester_stats_t {
+    std::atomic<size_t> n_of_pages{ 0 };
+    std::atomic<size_t> n_of_skipped{ 0 };
+    std::atomic<size_t> n_of_fetched{ 0 };
+    std::atomic<size_t> n_of_stored{ 0 };
+    std::atomic<size_t> n_of_failed{ 0 };
+};
+
+/**
+ * Pipeline pulling the recent matches of accounts into a store:
+ *   match id pages -> match info fetches (rate limited by the riot client) -> decode and store on worker threads
+ * Ids that are stored already, or queued by another account's history, are skipped before fetching.
+ * Each stage is bounded, history pages are only requested while the fetch queue has room for their ids
+ * and fetches are only started while the decode queue has room.
+ *
+ * Example call:
+ * match_ingester_t ingester;
+ * ingester.init(&riot, config,
+ *   [](const std::string& match_id) {
+ *     return store.contains(match_id);
+ *   },
+ *   [](const std::string& match_id, const nlohmann::json& match_info) {
+ *     return store.append(match_info);
+ *   }
+ * );
+ * ingester.ingest_async(riot_api::REGION_EUW, riot_api::GAME_TYPE_RANKED, puuid, 500);
+ * ingester.wait();
+*/
+struct match_ingester_t {
+    match_ingester_t() = default;
+    match_ingester_t(const match_ingester_t&) = delete;
+    match_ingester_t& operator=(const match_ingester_t&) = delete;
+    ~match_ingester_t();
+
+    /**
+     * is_stored: called before fetching, from any thread
+     * on_match: decodes and stores one match, runs on the decode workers concurrently, returns 0 on success
+     * on_batch: called on a decode worker each time the decoded matches caught up with the fetched ones, e.g. to make them durable
+    */
+    void init(
+        riot_client_t* riot, const match_ingester_config_t& config,
+        std::function<bool(const std::string& match_id)> is_stored,
+        std::function<int(const std::string& match_id, const nlohmann::json& match_info)> on_match,
+        std::function<void()> on_batch = std::function<void()>()
+    );
+    // waits for everything in progress
+    void destroy();
+
+    // the n_of_matches most recent matches of the account
+    void ingest_async(riot_api::region_t region, riot_api::game_type_t game_type, const std::string& puuid, size_t n_of_matches);
+    // blocks until every ingestion started so far is done, must not be called from a pipeline thread
+    void wait();
+
+    struct pending_page_t {
+        riot_api::region_t    region;
+        riot_api::game_type_t game_type;
+        std::string           puuid;
+        size_t                start;
+        size_t                n_of_matches_left;
+    };
+    struct pending_fetch_t {
+        riot_api::region_t region;
+        std::string        match_id;
+    };
+
+    // dequeues the fetches and the history pages the bounds allow to start now, m_mutex must be held
+    std::vector<pending_fetch_t> take_fetches(std::vector<pending_page_t>* pending_pages);
+    // must be called without m_mutex, a stopped riot client fails requests from inside the call
+    void                         start(std::vector<pending_fetch_t> pending_fetches, std::vector<pending_page_t> pending_pages);
+    void                         fetch_page(const pending_page_t& pending_page);
+    void                         fetch_matches(std::vector<pending_fetch_t> pending_fetches);
+    // m_mutex must be held
+    bool                         is_idle() const;
+
+    riot_client_t*                                                                    m_riot = 0;
+    match_ingester_config_t                                                           m_config;
+    std::function<bool(const std::string& match_id)>                                  m_is_stored;
+    std::function<int(const std::string& match_id, const nlohmann::json& match_info)> m_on_match;
+    std::function<void()>                                                             m_on_batch;
+    executor_t                                                                        m_decode_executor;
+    std::mutex                                                                        m_mutex;
+    std::condition_variable                                                           m_cv;
+    std::deque<pending_page_t>                                                        m_page_queue;
+    std::deque<pending_fetch_t>                                                       m_fetch_queue;
+    // queued, in flight or ingested in this session
+    std::unordered_set<std::string>                                                   m_seen_match_ids;
+    // accounts with history pages left, queued or in flight
+    size_t                                                                            m_n_of_pending_pages = 0;
+    size_t                                                                            m_n_of_in_flight_pages = 0;
+    size_t                                                                            m_n_of_in_flight_fetches = 0;
+    size_t                                                                            m_n_of_queued_decodes = 0;
+    match_ingester_stats_t                                                            m_stats;
+};
+
+#endif // MATCH_INGESTER_H
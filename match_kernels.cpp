@@ -0,0 +1,526 @@
+#include "match_kernels.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+// sse2 is part of x86-64, avx2 is compiled per function and only called after checking the cpu
+#define MATCH_KERNELS_X86
+#define MATCH_KERNELS_AVX2 __attribute__((target("avx2")))
+#include <immintrin.h>
+#endif
+
+static match_kernel_isa_t supported_isa() {
+#if defined(MATCH_KERNELS_X86)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return MATCH_KERNEL_ISA_AVX2;
+    }
+    return MATCH_KERNEL_ISA_SSE2;
+#else
+    return MATCH_KERNEL_ISA_SCALAR;
+#endif
+}
+
+static match_kernel_isa_t kernel_isa = supported_isa();
+
+match_kernel_isa_t match_kernel_isa() {
+    return kernel_isa;
+}
+
+match_kernel_isa_t match_kernel_set_isa(match_kernel_isa_t isa) {
+    kernel_isa = std::min(isa, supported_isa());
+
+    return kernel_isa;
+}
+
+const char* match_kernel_isa_name(match_kernel_isa_t isa) {
+    switch (isa) {
+    case MATCH_KERNEL_ISA_SCALAR: return "scalar";
+    case MATCH_KERNEL_ISA_SSE2: return "sse2";
+    case MATCH_KERNEL_ISA_AVX2: return "avx2";
+    default: return "unknown";
+    }
+}
+
+void match_aggregate_t::merge(const match_aggregate_t& other) {
+    sum += other.sum;
+    n += other.n;
+    min = std::min(min, other.min);
+    max = std::max(max, other.max);
+}
+
+double match_aggregate_t::mean() const {
+    return n ? sum / static_cast<double>(n) : 0.0;
+}
+
+size_t match_selection_size(size_t n_of_rows) {
+    return (n_of_rows + 63) / 64;
+}
+
+void match_select_all(size_t n_of_rows, uint64_t* selection) {
+    const size_t n_of_words = match_selection_size(n_of_rows);
+    for (size_t word = 0; word < n_of_words; ++word) {
+        selection[word] = ~0ull;
+    }
+    if (n_of_rows % 64) {
+        selection[n_of_words - 1] = (1ull << (n_of_rows % 64)) - 1;
+    }
+}
+
+size_t match_selection_count(size_t n_of_rows, const uint64_t* selection) {
+    size_t result = 0;
+    const size_t n_of_words = match_selection_size(n_of_rows);
+    for (size_t word = 0; word < n_of_words; ++word) {
+        result += std::popcount(selection[word]);
+    }
+
+    return result;
+}
+
+/**
+ * Scalar kernels, they start at begin_word so the vectorized ones can hand them the last partial word.
+*/
+template <typename column_t>
+static void select_equal_scalar(const column_t* column, size_t begin_word, size_t n_of_rows, column_t value, uint64_t* selection) {
+    for (size_t word = begin_word; word * 64 < n_of_rows; ++word) {
+        if (!selection[word]) {
+            continue ;
+        }
+        const column_t* rows = column + word * 64;
+        const size_t n = std::min<size_t>(64, n_of_rows - word * 64);
+        uint64_t mask = 0;
+        for (size_t row = 0; row < n; ++row) {
+            mask |= static_cast<uint64_t>(rows[row] == value) << row;
+        }
+        selection[word] &= mask;
+    }
+}
+
+static void select_range_scalar(const int64_t* column, size_t begin_word, size_t n_of_rows, int64_t min, int64_t max, uint64_t* selection) {
+    for (size_t word = begin_word; word * 64 < n_of_rows; ++word) {
+        if (!selection[word]) {
+            continue ;
+        }
+        const int64_t* rows = column + word * 64;
+        const size_t n = std::min<size_t>(64, n_of_rows - word * 64);
+        uint64_t mask = 0;
+        for (size_t row = 0; row < n; ++row) {
+            mask |= static_cast<uint64_t>(min <= rows[row] && rows[row] < max) << row;
+        }
+        selection[word] &= mask;
+    }
+}
+
+template <typename value_t>
+static void aggregate_scalar(const value_t* values, size_t begin_word, size_t n_of_rows, const uint64_t* selection, match_aggregate_t* result) {
+    for (size_t word = begin_word; word * 64 < n_of_rows; ++word) {
+        uint64_t bits = selection[word];
+        while (bits) {
+            const double value = static_cast<double>(values[word * 64 + std::countr_zero(bits)]);
+            bits &= bits - 1;
+            result->sum += value;
+            ++result->n;
+            result->min = std::min(result->min, value);
+            result->max = std::max(result->max, value);
+        }
+    }
+}
+
+template <typename value_t, typename key_t>
+static void aggregate_grouped_scalar(const value_t* values, const key_t* keys, size_t n_of_rows, const uint64_t* selection, match_aggregate_t* groups) {
+    for (size_t word = 0; word * 64 < n_of_rows; ++word) {
+        uint64_t bits = selection[word];
+        if (bits == ~0ull) {
+            // dense words skip the bit scan
+            for (size_t row = word * 64; row < word * 64 + 64; ++row) {
+                const double value = static_cast<double>(values[row]);
+                match_aggregate_t& group = groups[keys[row]];
+                group.sum += value;
+                ++group.n;
+                group.min = std::min(group.min, value);
+                group.max = std::max(group.max, value);
+            }
+            continue ;
+        }
+        while (bits) {
+            const size_t row = word * 64 + std::countr_zero(bits);
+            bits &= bits - 1;
+            const double value = static_cast<double>(values[row]);
+            match_aggregate_t& group = groups[keys[row]];
+            group.sum += value;
+            ++group.n;
+            group.min = std::min(group.min, value);
+            group.max = std::max(group.max, value);
+        }
+    }
+}
+
+#if defined(MATCH_KERNELS_X86)
+
+/**
+ * SSE2 kernels, whole words of 64 rows at a time.
+*/
+static void select_equal_u8_sse2(const uint8_t* column, size_t n_of_rows, uint8_t value, uint64_t* selection) {
+    const __m128i needle = _mm_set1_epi8(static_cast<char>(value));
+    const size_t n_of_full_words = n_of_rows / 64;
+    for (size_t word = 0; word < n_of_full_words; ++word) {
+        if (!selection[word]) {
+            continue ;
+        }
+        const uint8_t* rows = column + word * 64;
+        uint64_t mask = 0;
+        for (int part = 0; part < 4; ++part) {
+            const __m128i equal = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + part * 16)), needle);
+            mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(equal))) << (part * 16);
+        }
+        selection[word] &= mask;
+    }
+    select_equal_scalar(column, n_of_full_words, n_of_rows, value, selection);
+}
+
+static void select_equal_u16_sse2(const uint16_t* column, size_t n_of_rows, uint16_t value, uint64_t* selection) {
+    const __m128i needle = _mm_set1_epi16(static_cast<short>(value));
+    const size_t n_of_full_words = n_of_rows / 64;
+    for (size_t word = 0; word < n_of_full_words; ++word) {
+        if (!selection[word]) {
+            continue ;
+        }
+        const __m128i* rows = reinterpret_cast<const __m128i*>(column + word * 64);
+        uint64_t mask = 0;
+        for (int part = 0; part < 4; ++part) {
+            // the 0/-1 lanes survive the signed saturation
+            const __m128i equal = _mm_packs_epi16(
+                _mm_cmpeq_epi16(_mm_loadu_si128(rows + part * 2), needle),
+                _mm_cmpeq_epi16(_mm_loadu_si128(rows + part * 2 + 1), needle)
+            );
+            mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(equal))) << (part * 16);
+        }
+        selection[word] &= mask;
+    }
+    select_equal_scalar(column, n_of_full_words, n_of_rows, value, selection);
+}
+
+static void select_equal_u32_sse2(const uint32_t* column, size_t n_of_rows, uint32_t value, uint64_t* selection) {
+    const __m128i needle = _mm_set1_epi32(static_cast<int>(value));
+    const size_t n_of_full_words = n_of_rows / 64;
+    for (size_t word = 0; word < n_of_full_words; ++word) {
+        if (!selection[word]) {
+            continue ;
+        }
+        const __m128i* rows = reinterpret_cast<const __m128i*>(column + word * 64);
+        uint64_t mask = 0;
+        for (int part = 0; part < 4; ++part) {
+            const __m128i equal = _mm_packs_epi16(
+                _mm_packs_epi32(_mm_cmpeq_epi32(_mm_loadu_si128(rows + part * 4), needle), _mm_cmpeq_epi32(_mm_loadu_si128(rows + part * 4 + 1), needle)),
+                _mm_packs_epi32(_mm_cmpeq_epi32(_mm_loadu_si128(rows + part * 4 + 2), needle), _mm_cmpeq_epi32(_mm_loadu_si128(rows + part * 4 + 3), needle))
+            );
+            mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(equal))) << (part * 16);
+        }
+        selection[word] &= mask;
+    }
+    select_equal_scalar(column, n_of_full_words, n_of_rows, value, selection);
+}
+
+static void aggregate_f32_sse2(const float* values, size_t n_of_rows, const uint64_t* selection, match_aggregate_t* result) {
+    const __m128i bit_values = _mm_setr_epi32(1, 2, 4, 8);
+    const __m128 positive_infinity = _mm_set1_ps(INFINITY);
+    const __m128 negative_infinity = _mm_set1_ps(-INFINITY);
+    __m128d sum = _mm_setzero_pd();
+    __m128 min = positive_infinity;
+    __m128 max = negative_infinity;
+    uint64_t n = 0;
+
+    const size_t n_of_full_words = n_of_rows / 64;
+    for (size_t word = 0; word < n_of_full_words; ++word) {
+        const uint64_t bits = selection[word];
+        if (!bits) {
+            continue ;
+        }
+        n += std::popcount(bits);
+        for (int part = 0; part < 16; ++part) {
+            const int part_bits = static_cast<int>((bits >> (part * 4)) & 0xF);
+            if (!part_bits) {
+                continue ;
+            }
+            const __m128 mask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(part_bits), bit_values), bit_values));
+            const __m128 value = _mm_loadu_ps(values + word * 64 + part * 4);
+            const __m128 selected = _mm_and_ps(mask, value);
+            sum = _mm_add_pd(sum, _mm_add_pd(_mm_cvtps_pd(selected), _mm_cvtps_pd(_mm_movehl_ps(selected, selected))));
+            min = _mm_min_ps(min, _mm_or_ps(selected, _mm_andnot_ps(mask, positive_infinity)));
+            max = _mm_max_ps(max, _mm_or_ps(selected, _mm_andnot_ps(mask, negative_infinity)));
+        }
+    }
+
+    double sums[2];
+    float mins[4];
+    float maxs[4];
+    _mm_storeu_pd(sums, sum);
+    _mm_storeu_ps(mins, min);
+    _mm_storeu_ps(maxs, max);
+    result->sum += sums[0] + sums[1];
+    result->n += n;
+    for (int lane = 0; lane < 4; ++lane) {
+        result->min = std::min(result->min, static_cast<double>(mins[lane]));
+        result->max = std::max(result->max, static_cast<double>(maxs[lane]));
+    }
+    aggregate_scalar(values, n_of_full_words, n_of_rows, selection, result);
+}
+
+/**
+ * AVX2 kernels, same shape as the SSE2 ones with twice the lanes, plus the 64 bit compares SSE2 lacks.
+*/
+MATCH_KERNELS_AVX2 static void select_equal_u8_avx2(const uint8_t* column, size_t n_of_rows, uint8_t value, uint64_t* selection) {
+    const __m256i needle = _mm256_set1_epi8(static_cast<char>(value));
+    const size_t n_of_full_words = n_of_rows / 64;
+    for (size_t word = 0; word < n_of_full_words; ++word) {
+        if (!selection[word]) {
+            continue ;
+        }
+        const __m256i* rows = reinterpret_cast<const __m256i*>(column + word * 64);
+        const uint32_t low = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(rows), needle)));
+        const uint32_t high = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(rows + 1), needle)));
+        selection[word] &= (static_cast<uint64_t>(high) << 32) | low;
+    }
+    select_equal_scalar(column, n_of_full_words, n_of_rows, value, selection);
+}
+
+MATCH_KERNELS_AVX2 static void select_equal_u16_avx2(const uint16_t* column, size_t n_of_rows, uint16_t value, uint64_t* selection) {
+    const __m256i needle = _mm256_set1_epi16(static_cast<short>(value));
+    const size_t n_of_full_words = n_of_rows / 64;
+    for (size_t word = 0; word < n_of_full_words; ++word) {
+        if (!selection[word]) {
+            continue ;
+        }
+        const __m256i* rows = reinterpret_cast<const __m256i*>(column + word * 64);
+        uint64_t mask = 0;
+        for (int part = 0; part < 2; ++part) {
+            // packs works per 128 bit lane, the permute puts the rows back in order
+            const __m256i equal = _mm256_permute4x64_epi64(
+                _mm256_packs_epi16(
+                    _mm256_cmpeq_epi16(_mm256_loadu_si256(rows + part * 2), needle),
+                    _mm256_cmpeq_epi16(_mm256_loadu_si256(rows + part * 2 + 1), needle)
+                ),
+                0xD8
+            );
+            mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(equal))) << (part * 32);
+        }
+        selection[word] &= mask;
+    }
+    select_equal_scalar(column, n_of_full_words, n_of_rows, value, selection);
+}
+
+MATCH_KERNELS_AVX2 static void select_equal_u32_avx2(const uint32_t* column, size_t n_of_rows, uint32_t value, uint64_t* selection) {
+    const __m256i needle = _mm256_set1_epi32(static_cast<int>(value));
+    const size_t n_of_full_words = n_of_rows / 64;
+    for (size_t word = 0; word < n_of_full_words; ++word) {
+        if (!selection[word]) {
+            continue ;
+        }
+        const __m256i* rows = reinterpret_cast<const __m256i*>(column + word * 64);
+        uint64_t mask = 0;
+        for (int part = 0; part < 8; ++part) {
+            const __m256i equal = _mm256_cmpeq_epi32(_mm256_loadu_si256(rows + part), needle);
+            mask |= static_cast<uint64_t>(_mm256_movemask_ps(_mm256_castsi256_ps(equal))) << (part * 8);
+        }
+        selection[word] &= mask;
+    }
+    select_equal_scalar(column, n_of_full_words, n_of_rows, value, selection);
+}
+
+MATCH_KERNELS_AVX2 static void select_range_avx2(const int64_t* column, size_t n_of_rows, int64_t min, int64_t max, uint64_t* selection) {
+    const __m256i lower = _mm256_set1_epi64x(min);
+    const __m256i upper = _mm256_set1_epi64x(max);
+    const size_t n_of_full_words = n_of_rows / 64;
+    for (size_t word = 0; word < n_of_full_words; ++word) {
+        if (!selection[word]) {
+            continue ;
+        }
+        const __m256i* rows = reinterpret_cast<const __m256i*>(column + word * 64);
+        uint64_t mask = 0;
+        for (int part = 0; part < 16; ++part) {
+            const __m256i value = _mm256_loadu_si256(rows + part);
+            const __m256i is_in_range = _mm256_andnot_si256(_mm256_cmpgt_epi64(lower, value), _mm256_cmpgt_epi64(upper, value));
+            mask |= static_cast<uint64_t>(_mm256_movemask_pd(_mm256_castsi256_pd(is_in_range))) << (part * 4);
+        }
+        selection[word] &= mask;
+    }
+    select_range_scalar(column, n_of_full_words, n_of_rows, min, max, selection);
+}
+
+MATCH_KERNELS_AVX2 static void aggregate_f32_avx2(const float* values, size_t n_of_rows, const uint64_t* selection, match_aggregate_t* result) {
+    const __m256i bit_values = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    const __m256 positive_infinity = _mm256_set1_ps(INFINITY);
+    const __m256 negative_infinity = _mm256_set1_ps(-INFINITY);
+    // f32 sums drift over a few hundred thousand rows, they are widened to f64 before adding up
+    __m256d sum_low = _mm256_setzero_pd();
+    __m256d sum_high = _mm256_setzero_pd();
+    __m256 min = positive_infinity;
+    __m256 max = negative_infinity;
+    uint64_t n = 0;
+
+    const size_t n_of_full_words = n_of_rows / 64;
+    for (size_t word = 0; word < n_of_full_words; ++word) {
+        const uint64_t bits = selection[word];
+        if (!bits) {
+            continue ;
+        }
+        n += std::popcount(bits);
+        for (int part = 0; part < 8; ++part) {
+            const int part_bits = static_cast<int>((bits >> (part * 8)) & 0xFF);
+            if (!part_bits) {
+                continue ;
+            }
+            const __m256 mask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32(part_bits), bit_values), bit_values));
+            const __m256 value = _mm256_loadu_ps(values + word * 64 + part * 8);
+            const __m256 selected = _mm256_and_ps(mask, value);
+            sum_low = _mm256_add_pd(sum_low, _mm256_cvtps_pd(_mm256_castps256_ps128(selected)));
+            sum_high = _mm256_add_pd(sum_high, _mm256_cvtps_pd(_mm256_extractf128_ps(selected, 1)));
+            min = _mm256_min_ps(min, _mm256_blendv_ps(positive_infinity, value, mask));
+            max = _mm256_max_ps(max, _mm256_blendv_ps(negative_infinity, value, mask));
+        }
+    }
+
+    double sums[4];
+    float mins[8];
+    float maxs[8];
+    _mm256_storeu_pd(sums, _mm256_add_pd(sum_low, sum_high));
+    _mm256_storeu_ps(mins, min);
+    _mm256_storeu_ps(maxs, max);
+    result->sum += sums[0] + sums[1] + sums[2] + sums[3];
+    result->n += n;
+    for (int lane = 0; lane < 8; ++lane) {
+        result->min = std::min(result->min, static_cast<double>(mins[lane]));
+        result->max = std::max(result->max, static_cast<double>(maxs[lane]));
+    }
+    aggregate_scalar(values, n_of_full_words, n_of_rows, selection, result);
+}
+
+#endif // MATCH_KERNELS_X86
+
+void match_select_equal(const void* column, match_column_type_t type, size_t n_of_rows, uint32_t value, uint64_t* selection) {
+    switch (type) {
+    case MATCH_COLUMN_TYPE_U8: {
+        if (UINT8_MAX < value) {
+            memset(selection, 0, match_selection_size(n_of_rows) * sizeof(*selection));
+            return ;
+        }
+        const uint8_t* column_u8 = static_cast<const uint8_t*>(column);
+#if defined(MATCH_KERNELS_X86)
+        if (kernel_isa == MATCH_KERNEL_ISA_AVX2) {
+            select_equal_u8_avx2(column_u8, n_of_rows, static_cast<uint8_t>(value), selection);
+            return ;
+        }
+        if (kernel_isa == MATCH_KERNEL_ISA_SSE2) {
+            select_equal_u8_sse2(column_u8, n_of_rows, static_cast<uint8_t>(value), selection);
+            return ;
+        }
+#endif
+        select_equal_scalar(column_u8, 0, n_of_rows, static_cast<uint8_t>(value), selection);
+    } break ;
+    case MATCH_COLUMN_TYPE_U16: {
+        if (UINT16_MAX < value) {
+            memset(selection, 0, match_selection_size(n_of_rows) * sizeof(*selection));
+            return ;
+        }
+        const uint16_t* column_u16 = static_cast<const uint16_t*>(column);
+#if defined(MATCH_KERNELS_X86)
+        if (kernel_isa == MATCH_KERNEL_ISA_AVX2) {
+            select_equal_u16_avx2(column_u16, n_of_rows, static_cast<uint16_t>(value), selection);
+            return ;
+        }
+        if (kernel_isa == MATCH_KERNEL_ISA_SSE2) {
+            select_equal_u16_sse2(column_u16, n_of_rows, static_cast<uint16_t>(value), selection);
+            return ;
+        }
+#endif
+        select_equal_scalar(column_u16, 0, n_of_rows, static_cast<uint16_t>(value), selection);
+    } break ;
+    case MATCH_COLUMN_TYPE_U32: {
+        const uint32_t* column_u32 = static_cast<const uint32_t*>(column);
+#if defined(MATCH_KERNELS_X86)
+        if (kernel_isa == MATCH_KERNEL_ISA_AVX2) {
+            select_equal_u32_avx2(column_u32, n_of_rows, value, selection);
+            return ;
+        }
+        if (kernel_isa == MATCH_KERNEL_ISA_SSE2) {
+            select_equal_u32_sse2(column_u32, n_of_rows, value, selection);
+            return ;
+        }
+#endif
+        select_equal_scalar(column_u32, 0, n_of_rows, value, selection);
+    } break ;
+    default: {
+        assert(false && "equality filters take u8, u16 and u32 columns");
+    }
+    }
+}
+
+void match_select_range(const int64_t* column, size_t n_of_rows, int64_t min, int64_t max, uint64_t* selection) {
+#if defined(MATCH_KERNELS_X86)
+    if (kernel_isa == MATCH_KERNEL_ISA_AVX2) {
+        select_range_avx2(column, n_of_rows, min, max, selection);
+        return ;
+    }
+#endif
+    select_range_scalar(column, 0, n_of_rows, min, max, selection);
+}
+
+void match_aggregate(const void* values, match_column_type_t type, size_t n_of_rows, const uint64_t* selection, match_aggregate_t* result) {
+    switch (type) {
+    case MATCH_COLUMN_TYPE_U8: aggregate_scalar(static_cast<const uint8_t*>(values), 0, n_of_rows, selection, result); break ;
+    case MATCH_COLUMN_TYPE_U16: aggregate_scalar(static_cast<const uint16_t*>(values), 0, n_of_rows, selection, result); break ;
+    case MATCH_COLUMN_TYPE_U32: aggregate_scalar(static_cast<const uint32_t*>(values), 0, n_of_rows, selection, result); break ;
+    case MATCH_COLUMN_TYPE_I64: aggregate_scalar(static_cast<const int64_t*>(values), 0, n_of_rows, selection, result); break ;
+    case MATCH_COLUMN_TYPE_F32: {
+        const float* values_f32 = static_cast<const float*>(values);
+#if defined(MATCH_KERNELS_X86)
+        if (kernel_isa == MATCH_KERNEL_ISA_AVX2) {
+            aggregate_f32_avx2(values_f32, n_of_rows, selection, result);
+            return ;
+        }
+        if (kernel_isa == MATCH_KERNEL_ISA_SSE2) {
+            aggregate_f32_sse2(values_f32, n_of_rows, selection, result);
+            return ;
+        }
+#endif
+        aggregate_scalar(values_f32, 0, n_of_rows, selection, result);
+    } break ;
+    default: {
+        assert(false && "unknown column type");
+    }
+    }
+}
+
+template <typename value_t>
+static void aggregate_grouped_by(
+    const value_t* values, const void* keys, match_column_type_t key_type,
+    size_t n_of_rows, const uint64_t* selection, match_aggregate_t* groups
+) {
+    switch (key_type) {
+    case MATCH_COLUMN_TYPE_U8: aggregate_grouped_scalar(values, static_cast<const uint8_t*>(keys), n_of_rows, selection, groups); break ;
+    case MATCH_COLUMN_TYPE_U16: aggregate_grouped_scalar(values, static_cast<const uint16_t*>(keys), n_of_rows, selection, groups); break ;
+    case MATCH_COLUMN_TYPE_U32: aggregate_grouped_scalar(values, static_cast<const uint32_t*>(keys), n_of_rows, selection, groups); break ;
+    default: {
+        assert(false && "group keys are u8, u16 or u32 columns");
+    }
+    }
+}
+
+void match_aggregate_grouped(
+    const void* values, match_column_type_t type, const void* keys, match_column_type_t key_type,
+    size_t n_of_rows, const uint64_t* selection, match_aggregate_t* groups
+) {
+    switch (type) {
+    case MATCH_COLUMN_TYPE_U8: aggregate_grouped_by(static_cast<const uint8_t*>(values), keys, key_type, n_of_rows, selection, groups); break ;
+    case MATCH_COLUMN_TYPE_U16: aggregate_grouped_by(static_cast<const uint16_t*>(values), keys, key_type, n_of_rows, selection, groups); break ;
+    case MATCH_COLUMN_TYPE_U32: aggregate_grouped_by(static_cast<const uint32_t*>(values), keys, key_type, n_of_rows, selection, groups); break ;
+    case MATCH_COLUMN_TYPE_I64: aggregate_grouped_by(static_cast<const int64_t*>(values), keys, key_type, n_of_rows, selection, groups); break ;
+    case MATCH_COLUMN_TYPE_F32: aggregate_grouped_by(static_cast<const float*>(values), keys, key_type, n_of_rows, selection, groups); break ;
+    default: {
+        assert(false && "unknown column type");
+    }
+    }
+}
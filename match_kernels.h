@@ -0,0 +1,66 @@
+#ifndef MATCH_KERNELS_H
+# define MATCH_KERNELS_H
+
+# include <cstddef>
+# include <cstdint>
+# include <cmath>
+
+# include "match_store.h"
+
+enum match_kernel_isa_t {
+    MATCH_KERNEL_ISA_SCALAR,
+    MATCH_KERNEL_ISA_SSE2,
+    MATCH_KERNEL_ISA_AVX2,
+
+    _MATCH_KERNEL_ISA_SIZE
+};
+
+// the best one the cpu supports is picked on startup
+match_kernel_isa_t match_kernel_isa();
+// clamps to what the cpu supports, returns the one in effect, not thread safe against running kernels
+match_kernel_isa_t match_kernel_set_isa(match_kernel_isa_t isa);
+const char*        match_kernel_isa_name(match_kernel_isa_t isa);
+
+struct match_aggregate_t {
+    double   sum = 0.0;
+    uint64_t n   = 0;
+    double   min = INFINITY;
+    double   max = -INFINITY;
+
+    void   merge(const match_aggregate_t& other);
+    double mean() const;
+};
+
+/**
+ * Filter and aggregate kernels over match_store_t columns.
+ * Filters narrow a selection bitmap, bit i of word i / 64 selects row i and the bits past the last row stay 0,
+ * aggregates fold the selected rows of a column into their result in a single pass, so consecutive segments add up.
+ * Equality filters and f32 aggregates have SSE2 and AVX2 versions, i64 ranges an AVX2 one,
+ * other aggregates and the grouped scatter into per-key results stay scalar.
+ *
+ * Example call:
+ * std::vector<uint64_t> selection(match_selection_size(view.n_of_rows));
+ * match_select_all(view.n_of_rows, selection.data());
+ * match_select_equal(view.data[MATCH_COLUMN_QUEUE], MATCH_COLUMN_TYPE_U16, view.n_of_rows, queue_code, selection.data());
+ * match_aggregate_grouped(
+ *   view.data[damage_column], MATCH_COLUMN_TYPE_F32, view.data[MATCH_COLUMN_CHAMPION], MATCH_COLUMN_TYPE_U16,
+ *   view.n_of_rows, selection.data(), champion_aggregates.data()
+ * );
+*/
+size_t match_selection_size(size_t n_of_rows);
+void   match_select_all(size_t n_of_rows, uint64_t* selection);
+size_t match_selection_count(size_t n_of_rows, const uint64_t* selection);
+
+// keeps the rows whose u8/u16/u32 column equals value
+void match_select_equal(const void* column, match_column_type_t type, size_t n_of_rows, uint32_t value, uint64_t* selection);
+// keeps the rows with min <= column < max
+void match_select_range(const int64_t* column, size_t n_of_rows, int64_t min, int64_t max, uint64_t* selection);
+
+void match_aggregate(const void* values, match_column_type_t type, size_t n_of_rows, const uint64_t* selection, match_aggregate_t* result);
+// groups: indexed by the u8/u16/u32 key of each row, large enough for every key present
+void match_aggregate_grouped(
+    const void* values, match_column_type_t type, const void* keys, match_column_type_t key_type,
+    size_t n_of_rows, const uint64_t* selection, match_aggregate_t* groups
+);
+
+#endif // MATCH_KERNELS_H
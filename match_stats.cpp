@@ -0,0 +1,133 @@
+#include "match_stats.h"
+
+#include <iostream>
+#include <algorithm>
+#include <mutex>
+
+double match_stats_t::win_rate() const {
+    return n_of_games ? static_cast<double>(n_of_wins) / static_cast<double>(n_of_games) : 0.0;
+}
+
+double match_stats_t::per_minute(size_t column) const {
+    return n_of_seconds ? columns[column].sum / (n_of_seconds / 60.0) : 0.0;
+}
+
+double match_stats_t::kda(size_t kills_column, size_t deaths_column, size_t assists_column) const {
+    return (columns[kills_column].sum + columns[assists_column].sum) / std::max(columns[deaths_column].sum, 1.0);
+}
+
+static bool group_dictionary(int group_column, match_dictionary_t* dictionary) {
+    switch (group_column) {
+    case MATCH_COLUMN_MATCH: *dictionary = MATCH_DICTIONARY_MATCH_ID; return true;
+    case MATCH_COLUMN_QUEUE: *dictionary = MATCH_DICTIONARY_QUEUE; return true;
+    case MATCH_COLUMN_PUUID: *dictionary = MATCH_DICTIONARY_PUUID; return true;
+    case MATCH_COLUMN_CHAMPION: *dictionary = MATCH_DICTIONARY_CHAMPION; return true;
+    case MATCH_COLUMN_ROLE: *dictionary = MATCH_DICTIONARY_ROLE; return true;
+    default: return false;
+    }
+}
+
+int match_stats_summarize(
+    match_store_t* store, const match_stats_filter_t& filter, int group_column,
+    const std::vector<std::string>& column_names, std::vector<match_stats_t>* result
+) {
+    std::shared_lock<std::shared_mutex> lock(store->m_mutex);
+
+    size_t n_of_groups = 1;
+    match_dictionary_t dictionary;
+    if (group_column == MATCH_COLUMN_WIN) {
+        n_of_groups = 2;
+    } else if (group_dictionary(group_column, &dictionary)) {
+        n_of_groups = store->m_dictionaries[dictionary].values.size();
+    } else if (group_column != -1) {
+        std::cerr << "CLIENT can not group match stats by column " << group_column << std::endl;
+        return 1;
+    }
+
+    match_stats_t empty_stats;
+    empty_stats.columns.resize(column_names.size());
+    result->assign(n_of_groups, empty_stats);
+
+    struct equal_filter_t {
+        int      column;
+        uint32_t code;
+    };
+    std::vector<equal_filter_t> equal_filters;
+    const struct {
+        match_dictionary_t dictionary;
+        int                column;
+        const std::string* value;
+    } filter_values[] = {
+        { MATCH_DICTIONARY_CHAMPION, MATCH_COLUMN_CHAMPION, &filter.champion_name },
+        { MATCH_DICTIONARY_ROLE, MATCH_COLUMN_ROLE, &filter.role },
+        { MATCH_DICTIONARY_QUEUE, MATCH_COLUMN_QUEUE, &filter.queue },
+        { MATCH_DICTIONARY_PUUID, MATCH_COLUMN_PUUID, &filter.puuid }
+    };
+    for (const auto& filter_value : filter_values) {
+        if (filter_value.value->empty()) {
+            continue ;
+        }
+        const uint32_t code = store->dictionary_code(filter_value.dictionary, *filter_value.value);
+        if (code == UINT32_MAX) {
+            return 0;
+        }
+        equal_filters.push_back({ .column = filter_value.column, .code = code });
+    }
+    const bool is_time_filtered = filter.from != INT64_MIN || filter.to != INT64_MAX;
+
+    std::vector<int> column_indices;
+    for (const std::string& column_name : column_names) {
+        column_indices.push_back(store->match_column_index(column_name));
+    }
+
+    // per group accumulators, the kernels scatter into contiguous arrays
+    std::vector<match_aggregate_t> games(n_of_groups);
+    std::vector<match_aggregate_t> durations(n_of_groups);
+    std::vector<std::vector<match_aggregate_t>> column_groups(column_names.size(), std::vector<match_aggregate_t>(n_of_groups));
+
+    std::vector<match_segment_view_t> views;
+    store->segment_views(&views);
+    std::vector<uint64_t> selection;
+    for (const match_segment_view_t& view : views) {
+        selection.resize(match_selection_size(view.n_of_rows));
+        match_select_all(view.n_of_rows, selection.data());
+        for (const equal_filter_t& equal_filter : equal_filters) {
+            match_select_equal(view.data[equal_filter.column], store->m_columns[equal_filter.column].type, view.n_of_rows, equal_filter.code, selection.data());
+        }
+        if (is_time_filtered) {
+            match_select_range(static_cast<const int64_t*>(view.data[MATCH_COLUMN_GAME_CREATION]), view.n_of_rows, filter.from, filter.to, selection.data());
+        }
+
+        auto aggregate = [&](int column_index, match_aggregate_t* groups) {
+            if (group_column < 0) {
+                match_aggregate(view.data[column_index], store->m_columns[column_index].type, view.n_of_rows, selection.data(), groups);
+            } else {
+                match_aggregate_grouped(
+                    view.data[column_index], store->m_columns[column_index].type, view.data[group_column], store->m_columns[group_column].type,
+                    view.n_of_rows, selection.data(), groups
+                );
+            }
+        };
+        // the sum of the win column counts the wins, its n the games
+        aggregate(MATCH_COLUMN_WIN, games.data());
+        aggregate(MATCH_COLUMN_GAME_DURATION, durations.data());
+        for (size_t column = 0; column < column_indices.size(); ++column) {
+            if (column_indices[column] < 0 || !view.data[column_indices[column]]) {
+                continue ;
+            }
+            aggregate(column_indices[column], column_groups[column].data());
+        }
+    }
+
+    for (size_t group = 0; group < n_of_groups; ++group) {
+        match_stats_t& stats = (*result)[group];
+        stats.n_of_games = games[group].n;
+        stats.n_of_wins = static_cast<uint64_t>(games[group].sum);
+        stats.n_of_seconds = durations[group].sum;
+        for (size_t column = 0; column < column_groups.size(); ++column) {
+            stats.columns[column] = column_groups[column][group];
+        }
+    }
+
+    return 0;
+}
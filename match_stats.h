@@ -0,0 +1,55 @@
+#ifndef MATCH_STATS_H
+# define MATCH_STATS_H
+
+# include <string>
+# include <vector>
+# include <cstdint>
+
+# include "match_store.h"
+# include "match_kernels.h"
+
+struct match_stats_filter_t {
+    // dictionary values to match, empty for any
+    std::string champion_name;
+    std::string role;
+    std::string queue;
+    std::string puuid;
+    // game creation in unix seconds, from <= creation < to
+    int64_t     from = INT64_MIN;
+    int64_t     to   = INT64_MAX;
+};
+
+struct match_stats_t {
+    // participant rows, one per game of one player
+    uint64_t                       n_of_games   = 0;
+    uint64_t                       n_of_wins    = 0;
+    double                         n_of_seconds = 0.0;
+    // in order of the requested columns, rows of segments older than a column do not count towards its n
+    std::vector<match_aggregate_t> columns;
+
+    double win_rate() const;
+    // sum of a column per minute played, e.g. damage per minute
+    double per_minute(size_t column) const;
+    // (kills + assists) / max(deaths, 1) from the sums of the three columns
+    double kda(size_t kills_column, size_t deaths_column, size_t assists_column) const;
+};
+
+/**
+ * Summaries of the stored participant rows that pass filter, grouped by one of the dictionary columns or by MATCH_COLUMN_WIN.
+ * result is indexed by the group column's code, a group_column of -1 puts every row in result[0].
+ * Filter values never seen by the store leave every group empty. Returns 1 if group_column can not be grouped by.
+ *
+ * Example call:
+ * match_stats_filter_t filter;
+ * filter.queue = "420";
+ * std::vector<match_stats_t> champion_stats;
+ * match_stats_summarize(&store, filter, MATCH_COLUMN_CHAMPION, { "kills", "deaths", "assists", "totalDamageDealtToChampions" }, &champion_stats);
+ * const match_stats_t& ahri_stats = champion_stats[store.dictionary_code(MATCH_DICTIONARY_CHAMPION, "Ahri")];
+ * std::cout << ahri_stats.win_rate() << " " << ahri_stats.kda(0, 1, 2) << " " << ahri_stats.per_minute(3) << std::endl;
+*/
+int match_stats_summarize(
+    match_store_t* store, const match_stats_filter_t& filter, int group_column,
+    const std::vector<std::string>& column_names, std::vector<match_stats_t>* result
+);
+
+#endif // MATCH_STATS_H
@@ -0,0 +1,617 @@
+#include "match_store.h"
+
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <climits>
+#include <mutex>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define MATCH_DICTIONARIES_MAGIC "LTMD"
+#define MATCH_SEGMENT_MAGIC "LTMS"
+#define MATCH_JOURNAL_MAGIC "LTMJ"
+#define MATCH_STORE_VERSION 1
+#define MATCH_SEGMENT_ALIGNMENT 64
+
+static const char* const fixed_column_names[_MATCH_FIXED_COLUMN_SIZE] = {
+    "match",
+    "game_creation",
+    "game_duration",
+    "queue",
+    "puuid",
+    "champion",
+    "role",
+    "team_id",
+    "win"
+};
+
+static const match_column_type_t fixed_column_types[_MATCH_FIXED_COLUMN_SIZE] = {
+    MATCH_COLUMN_TYPE_U32,
+    MATCH_COLUMN_TYPE_I64,
+    MATCH_COLUMN_TYPE_U32,
+    MATCH_COLUMN_TYPE_U16,
+    MATCH_COLUMN_TYPE_U32,
+    MATCH_COLUMN_TYPE_U16,
+    MATCH_COLUMN_TYPE_U8,
+    MATCH_COLUMN_TYPE_U16,
+    MATCH_COLUMN_TYPE_U8
+};
+
+size_t match_column_type_size(match_column_type_t type) {
+    switch (type) {
+    case MATCH_COLUMN_TYPE_U8: return 1;
+    case MATCH_COLUMN_TYPE_U16: return 2;
+    case MATCH_COLUMN_TYPE_U32: return 4;
+    case MATCH_COLUMN_TYPE_I64: return 8;
+    case MATCH_COLUMN_TYPE_F32: return 4;
+    default: return 0;
+    }
+}
+
+static std::string segment_path(const std::string& directory, uint32_t segment_index) {
+    char file_name[32];
+    snprintf(file_name, sizeof(file_name), "segment_%08u.lms", segment_index);
+    return directory + "/" + file_name;
+}
+
+static void append_bytes(std::vector<unsigned char>* buffer, const void* data, size_t size) {
+    buffer->insert(buffer->end(), static_cast<const unsigned char*>(data), static_cast<const unsigned char*>(data) + size);
+}
+
+static void append_string(std::vector<unsigned char>* buffer, const std::string& value) {
+    const uint32_t value_size = static_cast<uint32_t>(value.size());
+    append_bytes(buffer, &value_size, sizeof(value_size));
+    append_bytes(buffer, value.data(), value.size());
+}
+
+match_store_t::~match_store_t() {
+    close();
+}
+
+int match_store_t::open(const std::string& directory) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    m_directory = directory;
+    if (mkdir(m_directory.c_str(), 0755) && errno != EEXIST) {
+        std::cerr << "CLIENT failed to create match store '" << m_directory << "'" << std::endl;
+        return 1;
+    }
+
+    m_columns.clear();
+    m_column_name_to_index.clear();
+    for (int column = 0; column < _MATCH_FIXED_COLUMN_SIZE; ++column) {
+        add_column(fixed_column_names[column], fixed_column_types[column]);
+    }
+
+    std::vector<unsigned char> buffer;
+    if (m_dictionaries_log.open(m_directory + "/dictionaries.bin", MATCH_DICTIONARIES_MAGIC, MATCH_STORE_VERSION, "match dictionaries", &buffer)) {
+        return 1;
+    }
+    size_t offset = APPEND_LOG_HEADER_SIZE;
+    while (offset + 5 <= buffer.size()) {
+        const uint8_t dictionary = buffer[offset];
+        uint32_t value_size;
+        memcpy(&value_size, buffer.data() + offset + 1, sizeof(value_size));
+        if (_MATCH_DICTIONARY_SIZE <= dictionary || buffer.size() < offset + 5 + value_size) {
+            break ;
+        }
+        dictionary_t& dictionary_values = m_dictionaries[dictionary];
+        std::string value(reinterpret_cast<const char*>(buffer.data() + offset + 5), value_size);
+        dictionary_values.value_to_code[value] = static_cast<uint32_t>(dictionary_values.values.size());
+        dictionary_values.values.push_back(std::move(value));
+        offset += 5 + value_size;
+    }
+    if (m_dictionaries_log.truncate_torn_tail(offset)) {
+        return 1;
+    }
+
+    m_segments.clear();
+    m_stored_match_codes.clear();
+    for (m_n_of_segment_files = 0; access(segment_path(m_directory, m_n_of_segment_files).c_str(), F_OK) == 0; ++m_n_of_segment_files) {
+        if (load_segment(segment_path(m_directory, m_n_of_segment_files))) {
+            std::cerr << "CLIENT skipping corrupted match segment " << m_n_of_segment_files << std::endl;
+        }
+    }
+
+    m_tail.clear();
+    m_tail.resize(m_columns.size());
+    m_n_of_tail_rows = 0;
+    m_is_tail_journaled = true;
+    if (open_journal()) {
+        return 1;
+    }
+    if (m_max_tail_rows <= m_n_of_tail_rows) {
+        flush_tail();
+    }
+
+    return 0;
+}
+
+int match_store_t::open_journal() {
+    std::vector<unsigned char> buffer;
+    m_journal_synced_at = std::chrono::steady_clock::now();
+    if (m_journal_log.open(m_directory + "/tail.journal", MATCH_JOURNAL_MAGIC, MATCH_STORE_VERSION, "match journal", &buffer)) {
+        return 1;
+    }
+
+    const unsigned char* cur = buffer.data() + APPEND_LOG_HEADER_SIZE;
+    const unsigned char* record_end = cur;
+    auto read_bytes = [&](void* value, size_t size) {
+        if (static_cast<size_t>(record_end - cur) < size) {
+            return 1;
+        }
+        memcpy(value, cur, size);
+        cur += size;
+        return 0;
+    };
+    auto read_string = [&](std::string* value) {
+        uint32_t value_size;
+        if (read_bytes(&value_size, sizeof(value_size)) || static_cast<size_t>(record_end - cur) < value_size) {
+            return 1;
+        }
+        value->assign(reinterpret_cast<const char*>(cur), value_size);
+        cur += value_size;
+        return 0;
+    };
+    size_t offset = APPEND_LOG_HEADER_SIZE;
+    size_t n_of_replayed_matches = 0;
+    while (offset + 4 <= buffer.size()) {
+        uint32_t record_size;
+        memcpy(&record_size, buffer.data() + offset, sizeof(record_size));
+        if (buffer.size() < offset + 4 + record_size) {
+            break ;
+        }
+        cur = buffer.data() + offset + 4;
+        record_end = cur + record_size;
+
+        std::string match_id;
+        match_rows_t rows;
+        uint32_t n_of_participants;
+        if (
+            read_string(&match_id) ||
+            read_bytes(&rows.game_creation, sizeof(rows.game_creation)) ||
+            read_bytes(&rows.game_duration, sizeof(rows.game_duration)) ||
+            read_string(&rows.queue) ||
+            read_bytes(&n_of_participants, sizeof(n_of_participants))
+        ) {
+            break ;
+        }
+        bool is_read = true;
+        for (uint32_t participant_index = 0; participant_index < n_of_participants && is_read; ++participant_index) {
+            match_rows_t::participant_t& participant = rows.participants.emplace_back();
+            uint32_t n_of_stats;
+            is_read =
+                !read_string(&participant.puuid) && !read_string(&participant.champion) && !read_string(&participant.role) &&
+                !read_bytes(&participant.team_id, sizeof(participant.team_id)) && !read_bytes(&participant.win, sizeof(participant.win)) &&
+                !read_bytes(&n_of_stats, sizeof(n_of_stats));
+            for (uint32_t stat_index = 0; stat_index < n_of_stats && is_read; ++stat_index) {
+                std::pair<std::string, float>& stat = participant.stats.emplace_back();
+                is_read = !read_string(&stat.first) && !read_bytes(&stat.second, sizeof(stat.second));
+            }
+        }
+        if (!is_read || cur != record_end) {
+            break ;
+        }
+        push_rows(match_id, rows);
+        ++n_of_replayed_matches;
+        offset += 4 + record_size;
+    }
+    if (m_journal_log.truncate_torn_tail(offset)) {
+        return 1;
+    }
+    if (n_of_replayed_matches) {
+        std::cerr << "CLIENT replayed " << n_of_replayed_matches << " matches from the match journal" << std::endl;
+    }
+
+    return 0;
+}
+
+void match_store_t::close() {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    // the tail stays in the journal for the next session, a segment is only written once it is full
+    if (!m_is_tail_journaled || m_journal_log.sync()) {
+        flush_tail();
+    }
+    m_journal_log.close();
+    m_dictionaries_log.close();
+    m_segments.clear();
+}
+
+int match_store_t::load_segment(const std::string& path) {
+    segment_t segment;
+    segment.file = std::make_unique<mapped_file_t>();
+    if (segment.file->open(path)) {
+        return 1;
+    }
+
+    const unsigned char* data = segment.file->m_data;
+    const size_t size = segment.file->m_size;
+    uint32_t version;
+    uint32_t n_of_columns;
+    if (size < 16 || memcmp(data, MATCH_SEGMENT_MAGIC, 4)) {
+        return 1;
+    }
+    memcpy(&version, data + 4, sizeof(version));
+    memcpy(&segment.view.n_of_rows, data + 8, sizeof(segment.view.n_of_rows));
+    memcpy(&n_of_columns, data + 12, sizeof(n_of_columns));
+    if (version != MATCH_STORE_VERSION) {
+        return 1;
+    }
+
+    size_t offset = 16;
+    for (uint32_t column_index = 0; column_index < n_of_columns; ++column_index) {
+        uint32_t name_size;
+        if (size < offset + 4) {
+            return 1;
+        }
+        memcpy(&name_size, data + offset, sizeof(name_size));
+        if (size < offset + 4 + name_size + 9) {
+            return 1;
+        }
+        const std::string name(reinterpret_cast<const char*>(data + offset + 4), name_size);
+        const match_column_type_t type = static_cast<match_column_type_t>(data[offset + 4 + name_size]);
+        uint64_t column_offset;
+        memcpy(&column_offset, data + offset + 4 + name_size + 1, sizeof(column_offset));
+        offset += 4 + name_size + 9;
+
+        const size_t type_size = match_column_type_size(type);
+        if (type_size == 0 || size < column_offset || (size - column_offset) / type_size < segment.view.n_of_rows) {
+            return 1;
+        }
+        int schema_index = match_column_index(name);
+        if (schema_index < 0) {
+            schema_index = add_column(name, type);
+        }
+        if (m_columns[schema_index].type != type) {
+            std::cerr << "CLIENT match column '" << name << "' changed type, ignored in '" << path << "'" << std::endl;
+            continue ;
+        }
+        if (segment.view.data.size() <= static_cast<size_t>(schema_index)) {
+            segment.view.data.resize(schema_index + 1, 0);
+        }
+        segment.view.data[schema_index] = data + column_offset;
+    }
+    if (segment.view.data.size() <= MATCH_COLUMN_MATCH || !segment.view.data[MATCH_COLUMN_MATCH]) {
+        return 1;
+    }
+
+    const uint32_t* match_codes = static_cast<const uint32_t*>(segment.view.data[MATCH_COLUMN_MATCH]);
+    for (uint32_t row = 0; row < segment.view.n_of_rows; ++row) {
+        m_stored_match_codes.insert(match_codes[row]);
+    }
+    m_segments.push_back(std::move(segment));
+
+    return 0;
+}
+
+int match_store_t::add_column(const std::string& name, match_column_type_t type) {
+    const int column_index = static_cast<int>(m_columns.size());
+    m_columns.push_back({ .name = name, .type = type });
+    m_column_name_to_index[name] = column_index;
+    if (m_tail.size() < m_columns.size()) {
+        // rows appended before the column existed read as 0
+        m_tail.emplace_back(static_cast<size_t>(m_n_of_tail_rows) * match_column_type_size(type), 0);
+    }
+
+    return column_index;
+}
+
+void match_store_t::push(int column_index, const void* value) {
+    append_bytes(&m_tail[column_index], value, match_column_type_size(m_columns[column_index].type));
+}
+
+uint32_t match_store_t::encode(match_dictionary_t dictionary, const std::string& value) {
+    dictionary_t& dictionary_values = m_dictionaries[dictionary];
+    auto code_it = dictionary_values.value_to_code.find(value);
+    if (code_it != dictionary_values.value_to_code.end()) {
+        return code_it->second;
+    }
+
+    const uint32_t code = static_cast<uint32_t>(dictionary_values.values.size());
+    dictionary_values.values.push_back(value);
+    dictionary_values.value_to_code[value] = code;
+
+    const uint32_t value_size = static_cast<uint32_t>(value.size());
+    m_pending_dictionary_records.push_back(dictionary);
+    append_bytes(&m_pending_dictionary_records, &value_size, sizeof(value_size));
+    append_bytes(&m_pending_dictionary_records, value.data(), value.size());
+
+    return code;
+}
+
+bool match_store_t::contains(const std::string& match_id) {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+    const uint32_t code = dictionary_code(MATCH_DICTIONARY_MATCH_ID, match_id);
+    return code != UINT32_MAX && m_stored_match_codes.count(code);
+}
+
+int match_store_t::append(const std::string& match_id, const nlohmann::json& match_info) {
+    match_rows_t rows;
+    try {
+        const nlohmann::json& info = match_info.at("info");
+        rows.game_creation = info.at("gameCreation").get<int64_t>() / 1000;
+        int64_t duration = info.at("gameDuration").get<int64_t>();
+        if (!info.contains("gameEndTimestamp")) {
+            // matches before patch 11.20 report the duration in milliseconds
+            duration /= 1000;
+        }
+        rows.game_duration = static_cast<uint32_t>(duration);
+        rows.queue = std::to_string(info.at("queueId").get<int>());
+
+        for (const nlohmann::json& participant_json : info.at("participants")) {
+            match_rows_t::participant_t& participant = rows.participants.emplace_back();
+            participant.puuid = participant_json.at("puuid").get<std::string>();
+            participant.champion = participant_json.at("championName").get<std::string>();
+            participant.role = participant_json.value("teamPosition", "");
+            participant.team_id = participant_json.at("teamId").get<uint16_t>();
+            participant.win = participant_json.at("win").get<bool>();
+            for (const auto& [key, value] : participant_json.items()) {
+                if (key == "championId" || key == "teamId" || key == "win") {
+                    continue ;
+                }
+                if (value.is_number() || value.is_boolean()) {
+                    participant.stats.push_back({ key, value.get<float>() });
+                } else if (key == "challenges" && value.is_object()) {
+                    for (const auto& [challenge_key, challenge_value] : value.items()) {
+                        if (challenge_value.is_number()) {
+                            participant.stats.push_back({ "challenges." + challenge_key, challenge_value.get<float>() });
+                        }
+                    }
+                }
+            }
+        }
+    } catch (std::exception& e) {
+        std::cerr << "CLIENT failed to decode match '" << match_id << "': " << e.what() << std::endl;
+        return 1;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    const uint32_t match_code = dictionary_code(MATCH_DICTIONARY_MATCH_ID, match_id);
+    if (match_code != UINT32_MAX && m_stored_match_codes.count(match_code)) {
+        return 0;
+    }
+    if (journal(match_id, rows)) {
+        std::cerr << "CLIENT match '" << match_id << "' is lost on a crash until its segment is written" << std::endl;
+        m_is_tail_journaled = false;
+    }
+    push_rows(match_id, rows);
+
+    if (m_max_tail_rows <= m_n_of_tail_rows) {
+        return flush_tail();
+    }
+
+    return 0;
+}
+
+int match_store_t::journal(const std::string& match_id, const match_rows_t& rows) {
+    if (!m_journal_log.is_open()) {
+        return 1;
+    }
+
+    m_journal_record.assign(sizeof(uint32_t), 0);
+    append_string(&m_journal_record, match_id);
+    append_bytes(&m_journal_record, &rows.game_creation, sizeof(rows.game_creation));
+    append_bytes(&m_journal_record, &rows.game_duration, sizeof(rows.game_duration));
+    append_string(&m_journal_record, rows.queue);
+    const uint32_t n_of_participants = static_cast<uint32_t>(rows.participants.size());
+    append_bytes(&m_journal_record, &n_of_participants, sizeof(n_of_participants));
+    for (const match_rows_t::participant_t& participant : rows.participants) {
+        append_string(&m_journal_record, participant.puuid);
+        append_string(&m_journal_record, participant.champion);
+        append_string(&m_journal_record, participant.role);
+        append_bytes(&m_journal_record, &participant.team_id, sizeof(participant.team_id));
+        append_bytes(&m_journal_record, &participant.win, sizeof(participant.win));
+        const uint32_t n_of_stats = static_cast<uint32_t>(participant.stats.size());
+        append_bytes(&m_journal_record, &n_of_stats, sizeof(n_of_stats));
+        for (const auto& [name, value] : participant.stats) {
+            append_string(&m_journal_record, name);
+            append_bytes(&m_journal_record, &value, sizeof(value));
+        }
+    }
+    const uint32_t record_size = static_cast<uint32_t>(m_journal_record.size() - sizeof(uint32_t));
+    memcpy(m_journal_record.data(), &record_size, sizeof(record_size));
+
+    // flushed per match so a crash of the process loses none, synced to the disk periodically and on sync()
+    if (m_journal_log.append(m_journal_record.data(), m_journal_record.size())) {
+        return 1;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (std::chrono::milliseconds(m_journal_sync_interval_ms) <= now - m_journal_synced_at) {
+        m_journal_log.sync();
+        m_journal_synced_at = now;
+    }
+
+    return 0;
+}
+
+void match_store_t::push_rows(const std::string& match_id, const match_rows_t& rows) {
+    const uint32_t match_code = encode(MATCH_DICTIONARY_MATCH_ID, match_id);
+    if (m_stored_match_codes.count(match_code)) {
+        return ;
+    }
+    const uint16_t queue_code = static_cast<uint16_t>(encode(MATCH_DICTIONARY_QUEUE, rows.queue));
+
+    std::vector<float> stat_values;
+    for (const match_rows_t::participant_t& participant : rows.participants) {
+        const uint32_t puuid_code = encode(MATCH_DICTIONARY_PUUID, participant.puuid);
+        const uint16_t champion_code = static_cast<uint16_t>(encode(MATCH_DICTIONARY_CHAMPION, participant.champion));
+        const uint8_t role_code = static_cast<uint8_t>(encode(MATCH_DICTIONARY_ROLE, participant.role));
+        push(MATCH_COLUMN_MATCH, &match_code);
+        push(MATCH_COLUMN_GAME_CREATION, &rows.game_creation);
+        push(MATCH_COLUMN_GAME_DURATION, &rows.game_duration);
+        push(MATCH_COLUMN_QUEUE, &queue_code);
+        push(MATCH_COLUMN_PUUID, &puuid_code);
+        push(MATCH_COLUMN_CHAMPION, &champion_code);
+        push(MATCH_COLUMN_ROLE, &role_code);
+        push(MATCH_COLUMN_TEAM_ID, &participant.team_id);
+        push(MATCH_COLUMN_WIN, &participant.win);
+
+        for (const auto& [name, value] : participant.stats) {
+            if (match_column_index(name) < 0) {
+                add_column(name, MATCH_COLUMN_TYPE_F32);
+            }
+        }
+        stat_values.assign(m_columns.size(), 0.0f);
+        for (const auto& [name, value] : participant.stats) {
+            stat_values[m_column_name_to_index[name]] = value;
+        }
+        for (size_t column = _MATCH_FIXED_COLUMN_SIZE; column < m_columns.size(); ++column) {
+            if (m_columns[column].type == MATCH_COLUMN_TYPE_F32) {
+                push(static_cast<int>(column), &stat_values[column]);
+            } else {
+                // a stat column of a newer version with a type this one does not write
+                const uint64_t zero = 0;
+                push(static_cast<int>(column), &zero);
+            }
+        }
+        ++m_n_of_tail_rows;
+    }
+    m_stored_match_codes.insert(match_code);
+}
+
+int match_store_t::flush() {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    return flush_tail();
+}
+
+int match_store_t::sync() {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+
+    if (!m_journal_log.is_open()) {
+        return 0;
+    }
+    m_journal_synced_at = std::chrono::steady_clock::now();
+    if (m_journal_log.sync()) {
+        std::cerr << "CLIENT failed to sync the match journal" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+int match_store_t::flush_tail() {
+    if (m_n_of_tail_rows == 0 || !m_dictionaries_log.is_open()) {
+        return 0;
+    }
+
+    // dictionary values go first, a segment must never reference codes the dictionaries file does not have
+    if (!m_pending_dictionary_records.empty()) {
+        if (m_dictionaries_log.append(m_pending_dictionary_records.data(), m_pending_dictionary_records.size())) {
+            return 1;
+        }
+        m_pending_dictionary_records.clear();
+        if (m_dictionaries_log.sync()) {
+            std::cerr << "CLIENT failed to sync match dictionaries" << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<unsigned char> header;
+    const uint32_t version = MATCH_STORE_VERSION;
+    const uint32_t n_of_columns = static_cast<uint32_t>(m_columns.size());
+    append_bytes(&header, MATCH_SEGMENT_MAGIC, 4);
+    append_bytes(&header, &version, sizeof(version));
+    append_bytes(&header, &m_n_of_tail_rows, sizeof(m_n_of_tail_rows));
+    append_bytes(&header, &n_of_columns, sizeof(n_of_columns));
+    size_t header_size = header.size();
+    for (const match_column_t& column : m_columns) {
+        header_size += 4 + column.name.size() + 1 + 8;
+    }
+
+    uint64_t column_offset = (header_size + MATCH_SEGMENT_ALIGNMENT - 1) / MATCH_SEGMENT_ALIGNMENT * MATCH_SEGMENT_ALIGNMENT;
+    std::vector<uint64_t> column_offsets;
+    for (size_t column = 0; column < m_columns.size(); ++column) {
+        const match_column_t& column_info = m_columns[column];
+        const uint32_t name_size = static_cast<uint32_t>(column_info.name.size());
+        append_bytes(&header, &name_size, sizeof(name_size));
+        append_bytes(&header, column_info.name.data(), name_size);
+        header.push_back(column_info.type);
+        append_bytes(&header, &column_offset, sizeof(column_offset));
+        column_offsets.push_back(column_offset);
+        column_offset = (column_offset + m_tail[column].size() + MATCH_SEGMENT_ALIGNMENT - 1) / MATCH_SEGMENT_ALIGNMENT * MATCH_SEGMENT_ALIGNMENT;
+    }
+
+    const std::string path = segment_path(m_directory, m_n_of_segment_files);
+    const std::string tmp_path = path + ".tmp";
+    FILE* file = fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "CLIENT failed to create '" << tmp_path << "'" << std::endl;
+        return 1;
+    }
+    bool is_written = fwrite(header.data(), 1, header.size(), file) == header.size();
+    static const unsigned char padding[MATCH_SEGMENT_ALIGNMENT] = { 0 };
+    uint64_t written_size = header.size();
+    for (size_t column = 0; column < m_columns.size() && is_written; ++column) {
+        is_written = fwrite(padding, 1, column_offsets[column] - written_size, file) == column_offsets[column] - written_size;
+        is_written = is_written && fwrite(m_tail[column].data(), 1, m_tail[column].size(), file) == m_tail[column].size();
+        written_size = column_offsets[column] + m_tail[column].size();
+    }
+    is_written = is_written && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    is_written = fclose(file) == 0 && is_written;
+    if (!is_written || rename(tmp_path.c_str(), path.c_str())) {
+        std::cerr << "CLIENT failed to write '" << path << "'" << std::endl;
+        remove(tmp_path.c_str());
+        return 1;
+    }
+    ++m_n_of_segment_files;
+
+    if (load_segment(path)) {
+        std::cerr << "CLIENT failed to map '" << path << "'" << std::endl;
+        return 1;
+    }
+    for (std::vector<unsigned char>& column : m_tail) {
+        column.clear();
+    }
+    m_n_of_tail_rows = 0;
+    m_is_tail_journaled = true;
+
+    // the rows are in the segment now, if the journal keeps them they are skipped as stored when replayed
+    if (m_journal_log.is_open()) {
+        m_journal_log.clear();
+    }
+
+    return 0;
+}
+
+int match_store_t::match_column_index(const std::string& name) const {
+    auto column_it = m_column_name_to_index.find(name);
+    if (column_it == m_column_name_to_index.end()) {
+        return -1;
+    }
+
+    return column_it->second;
+}
+
+uint32_t match_store_t::dictionary_code(match_dictionary_t dictionary, const std::string& value) const {
+    const dictionary_t& dictionary_values = m_dictionaries[dictionary];
+    auto code_it = dictionary_values.value_to_code.find(value);
+    if (code_it == dictionary_values.value_to_code.end()) {
+        return UINT32_MAX;
+    }
+
+    return code_it->second;
+}
+
+const std::string& match_store_t::dictionary_value(match_dictionary_t dictionary, uint32_t code) const {
+    return m_dictionaries[dictionary].values[code];
+}
+
+void match_store_t::segment_views(std::vector<match_segment_view_t>* result) const {
+    result->clear();
+    for (const segment_t& segment : m_segments) {
+        match_segment_view_t& view = result->emplace_back(segment.view);
+        view.data.resize(m_columns.size(), 0);
+    }
+    if (m_n_of_tail_rows) {
+        match_segment_view_t& view = result->emplace_back();
+        view.n_of_rows = m_n_of_tail_rows;
+        for (const std::vector<unsigned char>& column : m_tail) {
+            view.data.push_back(column.data());
+        }
+    }
+}
@@ -0,0 +1,160 @@
+#ifndef MATCH_STORE_H
+# define MATCH_STORE_H
+
+# include <string>
+# include <vector>
+# include <memory>
+# include <unordered_map>
+# include <unordered_set>
+# include <shared_mutex>
+# include <chrono>
+# include <cstdint>
+
+# include "json.hpp"
+# include "mapped_file.h"
+# include "append_log.h"
+
+enum match_column_type_t : uint8_t {
+    MATCH_COLUMN_TYPE_U8,
+    MATCH_COLUMN_TYPE_U16,
+    MATCH_COLUMN_TYPE_U32,
+    MATCH_COLUMN_TYPE_I64,
+    MATCH_COLUMN_TYPE_F32,
+
+    _MATCH_COLUMN_TYPE_SIZE
+};
+size_t match_column_type_size(match_column_type_t type);
+
+enum match_dictionary_t : uint8_t {
+    MATCH_DICTIONARY_MATCH_ID,
+    MATCH_DICTIONARY_PUUID,
+    MATCH_DICTIONARY_CHAMPION,
+    MATCH_DICTIONARY_ROLE,
+    MATCH_DICTIONARY_QUEUE,
+
+    _MATCH_DICTIONARY_SIZE
+};
+
+// columns every row has, the participant stats follow them in the schema in order of discovery
+enum match_fixed_column_t {
+    MATCH_COLUMN_MATCH,         // u32, MATCH_DICTIONARY_MATCH_ID code
+    MATCH_COLUMN_GAME_CREATION, // i64, unix seconds
+    MATCH_COLUMN_GAME_DURATION, // u32, seconds
+    MATCH_COLUMN_QUEUE,         // u16, MATCH_DICTIONARY_QUEUE code
+    MATCH_COLUMN_PUUID,         // u32, MATCH_DICTIONARY_PUUID code
+    MATCH_COLUMN_CHAMPION,      // u16, MATCH_DICTIONARY_CHAMPION code
+    MATCH_COLUMN_ROLE,          // u8, MATCH_DICTIONARY_ROLE code
+    MATCH_COLUMN_TEAM_ID,       // u16
+    MATCH_COLUMN_WIN,           // u8
+
+    _MATCH_FIXED_COLUMN_SIZE
+};
+
+struct match_column_t {
+    std::string         name;
+    match_column_type_t type;
+};
+
+// contiguous rows of every column, data[column] is 0 for stat columns the segment predates
+struct match_segment_view_t {
+    uint32_t                 n_of_rows;
+    std::vector<const void*> data;
+};
+
+/**
+ * Participant rows of stored matches, column by column. One row per participant, the match level columns are repeated in each.
+ * Every numeric participant stat becomes a f32 column, including the nested 'challenges' ones as "challenges.<name>",
+ * strings with few distinct values (champion, role, queue, ids) are dictionary encoded.
+ *
+ * Directory layout:
+ *   dictionaries.bin: "LTMD" magic, u32 version, then records: u8 dictionary, u32 size, value; the code of a value is its rank in its dictionary
+ *   segment_<n>.lms:  "LTMS" magic, u32 version, u32 n_of_rows, u32 n_of_columns,
+ *                     n_of_columns * (u32 name size, name, u8 type, u64 offset), column data, every column 64 byte aligned
+ *   tail.journal:     "LTMJ" magic, u32 version, then one record per match in the tail: u32 size, the match's rows with their strings
+ * Appended rows collect in an in-memory tail that is written out as the next segment once it is full or on flush,
+ * segments are immutable and mapped on open. Each match of the tail is also appended to the journal, which is replayed on open
+ * and emptied once its rows are in a segment, so a crash loses no stored match and a session does not end in a small segment.
+*/
+struct match_store_t {
+    match_store_t() = default;
+    match_store_t(const match_store_t&) = delete;
+    match_store_t& operator=(const match_store_t&) = delete;
+    ~match_store_t();
+
+    int  open(const std::string& directory);
+    // the tail is left in the journal, only flushed if the journal cannot keep it
+    void close();
+
+    bool contains(const std::string& match_id);
+    // thread safe, returns 0 on success
+    int  append(const std::string& match_id, const nlohmann::json& match_info);
+    int  flush();
+    // makes the journaled tail durable, appends only do so every m_journal_sync_interval_ms
+    int  sync();
+
+    // queries, take m_mutex shared around them so no append lands in between
+    int                match_column_index(const std::string& name) const;
+    // returns UINT32_MAX if the value was never seen
+    uint32_t           dictionary_code(match_dictionary_t dictionary, const std::string& value) const;
+    const std::string& dictionary_value(match_dictionary_t dictionary, uint32_t code) const;
+    // every mapped segment followed by the tail
+    void               segment_views(std::vector<match_segment_view_t>* result) const;
+
+    struct dictionary_t {
+        std::vector<std::string>                  values;
+        std::unordered_map<std::string, uint32_t> value_to_code;
+    };
+    struct segment_t {
+        std::unique_ptr<mapped_file_t> file;
+        match_segment_view_t           view;
+    };
+    // a match decoded into its participant rows, what is journaled and pushed to the tail
+    struct match_rows_t {
+        struct participant_t {
+            std::string                                puuid;
+            std::string                                champion;
+            std::string                                role;
+            uint16_t                                   team_id;
+            uint8_t                                    win;
+            std::vector<std::pair<std::string, float>> stats;
+        };
+        int64_t                    game_creation;
+        uint32_t                   game_duration;
+        std::string                queue;
+        std::vector<participant_t> participants;
+    };
+
+    int      flush_tail();
+    int      load_segment(const std::string& path);
+    // opens the journal and pushes its matches to the tail, a torn last record is truncated
+    int      open_journal();
+    int      journal(const std::string& match_id, const match_rows_t& rows);
+    // a match stored already is skipped
+    void     push_rows(const std::string& match_id, const match_rows_t& rows);
+    uint32_t encode(match_dictionary_t dictionary, const std::string& value);
+    int      add_column(const std::string& name, match_column_type_t type);
+    void     push(int column_index, const void* value);
+
+    mutable std::shared_mutex                 m_mutex;
+    std::string                               m_directory;
+    append_log_t                              m_dictionaries_log;
+    dictionary_t                              m_dictionaries[_MATCH_DICTIONARY_SIZE];
+    // dictionary records of values first seen in the tail, written just before the tail's segment
+    std::vector<unsigned char>                m_pending_dictionary_records;
+    std::vector<match_column_t>               m_columns;
+    std::unordered_map<std::string, int>      m_column_name_to_index;
+    std::vector<segment_t>                    m_segments;
+    uint32_t                                  m_n_of_segment_files = 0;
+    std::vector<std::vector<unsigned char>>   m_tail;
+    uint32_t                                  m_n_of_tail_rows = 0;
+    uint32_t                                  m_max_tail_rows = 4096;
+    append_log_t                              m_journal_log;
+    // false once a match of the tail could not be journaled, close() then writes the tail out
+    bool                                      m_is_tail_journaled = true;
+    std::vector<unsigned char>                m_journal_record;
+    std::chrono::steady_clock::time_point     m_journal_synced_at;
+    int                                       m_journal_sync_interval_ms = 1000;
+    std::unordered_set<uint32_t>              m_stored_match_codes;
+};
+
+#endif // MATCH_STORE_H
@@ -0,0 +1,204 @@
+#include "pending_matches.h"
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+#define PENDING_MATCHES_MAGIC "LTPM"
+#define PENDING_MATCHES_VERSION 1
+
+enum pending_match_record_t : uint8_t {
+    PENDING_MATCH_RECORD_ADD = 1,
+    PENDING_MATCH_RECORD_REMOVE = 2,
+    PENDING_MATCH_RECORD_FAILED = 3
+};
+
+static void append_bytes(std::vector<unsigned char>* buffer, const void* data, size_t size) {
+    buffer->insert(buffer->end(), static_cast<const unsigned char*>(data), static_cast<const unsigned char*>(data) + size);
+}
+
+static void append_record(std::vector<unsigned char>* buffer, pending_match_record_t kind, const std::string& match_id, const std::vector<uint8_t>* serialized_match_info) {
+    buffer->push_back(kind);
+    const uint32_t match_id_size = static_cast<uint32_t>(match_id.size());
+    append_bytes(buffer, &match_id_size, sizeof(match_id_size));
+    append_bytes(buffer, match_id.data(), match_id.size());
+    if (serialized_match_info) {
+        const uint32_t info_size = static_cast<uint32_t>(serialized_match_info->size());
+        append_bytes(buffer, &info_size, sizeof(info_size));
+        append_bytes(buffer, serialized_match_info->data(), serialized_match_info->size());
+    }
+}
+
+pending_matches_t::~pending_matches_t() {
+    close();
+}
+
+int pending_matches_t::open(const std::string& path) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_match_id_to_entry.clear();
+    std::vector<unsigned char> buffer;
+    if (m_log.open(path, PENDING_MATCHES_MAGIC, PENDING_MATCHES_VERSION, "pending matches", &buffer)) {
+        return 1;
+    }
+
+    const unsigned char* cur = buffer.data() + APPEND_LOG_HEADER_SIZE;
+    const unsigned char* end = buffer.data() + buffer.size();
+    auto read_bytes = [&](uint32_t* size, const unsigned char** data) {
+        if (end - cur < 4) {
+            return 1;
+        }
+        memcpy(size, cur, sizeof(*size));
+        if (end - cur - 4 < static_cast<ptrdiff_t>(*size)) {
+            return 1;
+        }
+        *data = cur + 4;
+        cur += 4 + *size;
+        return 0;
+    };
+    const unsigned char* last_complete_record = cur;
+    size_t n_of_removed = 0;
+    while (cur < end) {
+        const uint8_t kind = *cur++;
+        uint32_t match_id_size;
+        const unsigned char* match_id_data;
+        if (read_bytes(&match_id_size, &match_id_data)) {
+            break ;
+        }
+        const std::string match_id(reinterpret_cast<const char*>(match_id_data), match_id_size);
+
+        if (kind == PENDING_MATCH_RECORD_ADD) {
+            uint32_t info_size;
+            const unsigned char* info_data;
+            if (read_bytes(&info_size, &info_data)) {
+                break ;
+            }
+            try {
+                m_match_id_to_entry[match_id] = {
+                    .match_info = std::make_shared<const nlohmann::json>(nlohmann::json::from_msgpack(info_data, info_data + info_size)),
+                    .is_taken = false,
+                    .n_of_failures = 0
+                };
+            } catch (std::exception& e) {
+                std::cerr << "CLIENT corrupted pending match '" << match_id << "'" << std::endl;
+                ++n_of_removed;
+            }
+        } else if (kind == PENDING_MATCH_RECORD_REMOVE) {
+            m_match_id_to_entry.erase(match_id);
+            ++n_of_removed;
+        } else if (kind == PENDING_MATCH_RECORD_FAILED) {
+            auto entry_it = m_match_id_to_entry.find(match_id);
+            if (entry_it != m_match_id_to_entry.end()) {
+                ++entry_it->second.n_of_failures;
+            }
+        } else {
+            break ;
+        }
+
+        last_complete_record = cur;
+    }
+    if (m_log.truncate_torn_tail(last_complete_record - buffer.data())) {
+        return 1;
+    }
+
+    if (n_of_removed) {
+        std::vector<unsigned char> compacted(buffer.begin(), buffer.begin() + APPEND_LOG_HEADER_SIZE);
+        for (const auto& [match_id, entry] : m_match_id_to_entry) {
+            const std::vector<uint8_t> serialized_match_info = nlohmann::json::to_msgpack(*entry.match_info);
+            append_record(&compacted, PENDING_MATCH_RECORD_ADD, match_id, &serialized_match_info);
+            for (int failure_index = 0; failure_index < entry.n_of_failures; ++failure_index) {
+                append_record(&compacted, PENDING_MATCH_RECORD_FAILED, match_id, 0);
+            }
+        }
+        if (m_log.rewrite(compacted) && !m_log.is_open()) {
+            return 1;
+        }
+    }
+    if (!m_match_id_to_entry.empty()) {
+        std::cerr << "CLIENT " << m_match_id_to_entry.size() << " matches are still waiting for their timeline" << std::endl;
+    }
+
+    return 0;
+}
+
+void pending_matches_t::close() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_log.close();
+}
+
+int pending_matches_t::add(const std::string& match_id, std::shared_ptr<const nlohmann::json> match_info) {
+    const std::vector<uint8_t> serialized_match_info = nlohmann::json::to_msgpack(*match_info);
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    auto entry_it = m_match_id_to_entry.find(match_id);
+    if (entry_it != m_match_id_to_entry.end()) {
+        entry_it->second.is_taken = true;
+        return 0;
+    }
+    std::vector<unsigned char> buffer;
+    append_record(&buffer, PENDING_MATCH_RECORD_ADD, match_id, &serialized_match_info);
+    if (m_log.append(buffer.data(), buffer.size())) {
+        return 1;
+    }
+    m_match_id_to_entry[match_id] = { .match_info = std::move(match_info), .is_taken = true, .n_of_failures = 0 };
+
+    return 0;
+}
+
+int pending_matches_t::remove(const std::string& match_id) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    auto entry_it = m_match_id_to_entry.find(match_id);
+    if (entry_it == m_match_id_to_entry.end()) {
+        return 0;
+    }
+    std::vector<unsigned char> buffer;
+    append_record(&buffer, PENDING_MATCH_RECORD_REMOVE, match_id, 0);
+    if (m_log.append(buffer.data(), buffer.size())) {
+        // driven again on the next start, the consumers skip matches they have
+        return 1;
+    }
+    m_match_id_to_entry.erase(entry_it);
+
+    return 0;
+}
+
+int pending_matches_t::fail(const std::string& match_id) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    auto entry_it = m_match_id_to_entry.find(match_id);
+    if (entry_it == m_match_id_to_entry.end()) {
+        return 0;
+    }
+    entry_it->second.is_taken = false;
+    std::vector<unsigned char> buffer;
+    append_record(&buffer, PENDING_MATCH_RECORD_FAILED, match_id, 0);
+    // a failure that does not make it to the disk gives the match one more attempt next session
+    m_log.append(buffer.data(), buffer.size());
+
+    return ++entry_it->second.n_of_failures;
+}
+
+void pending_matches_t::take(const std::string& puuid, std::vector<pending_match_t>* result) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    result->clear();
+    for (auto& [match_id, entry] : m_match_id_to_entry) {
+        if (entry.is_taken) {
+            continue ;
+        }
+        // match-v5 lists the participants' puuids in the metadata
+        auto metadata_it = entry.match_info->find("metadata");
+        if (metadata_it == entry.match_info->end() || !metadata_it->contains("participants")) {
+            continue ;
+        }
+        const nlohmann::json& participants = metadata_it->at("participants");
+        if (std::find(participants.begin(), participants.end(), puuid) == participants.end()) {
+            continue ;
+        }
+        entry.is_taken = true;
+        result->push_back({ .match_id = match_id, .match_info = entry.match_info });
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef PENDING_MATCHES_H
+# define PENDING_MATCHES_H
+
+# include <string>
+# include <vector>
+# include <memory>
+# include <unordered_map>
+# include <mutex>
+
+# include "json.hpp"
+# include "append_log.h"
+
+// failed timeline requests of a match, over every session, before it is applied without its timeline
+# define PENDING_MATCH_MAX_FAILURES 3
+
+struct pending_match_t {
+    std::string                           match_id;
+    std::shared_ptr<const nlohmann::json> match_info;
+};
+
+/**
+ * Stored matches whose timeline consumers, the attribution and the heatmap, have not seen them yet, with their match json.
+ * A match is added before it goes to the match store and removed once its timeline was applied, so a match the store
+ * already has, and which the ingester therefore skips, is still driven again after a crash in between or a failed timeline request.
+ *
+ * File layout: "LTPM" magic, u32 version, then records:
+ *   add:    u8 PENDING_MATCH_RECORD_ADD, u32 match id size, match id, u32 info size, msgpack match info
+ *   remove: u8 PENDING_MATCH_RECORD_REMOVE, u32 match id size, match id
+ *   failed: u8 PENDING_MATCH_RECORD_FAILED, u32 match id size, match id
+ * Records are replayed on open and the file is rewritten with only the matches still pending.
+ *
+ * Example call:
+ * pending_matches_t pending_matches;
+ * pending_matches.open("pending_matches.bin");
+ * pending_matches.add(match_id, match_info);
+ * std::vector<pending_match_t> matches;
+ * pending_matches.take(puuid, &matches);
+ * pending_matches.remove(match_id);
+*/
+struct pending_matches_t {
+    pending_matches_t() = default;
+    pending_matches_t(const pending_matches_t&) = delete;
+    pending_matches_t& operator=(const pending_matches_t&) = delete;
+    ~pending_matches_t();
+
+    int  open(const std::string& path);
+    void close();
+
+    // thread safe, the caller works on the match, take() does not hand it out
+    int  add(const std::string& match_id, std::shared_ptr<const nlohmann::json> match_info);
+    int  remove(const std::string& match_id);
+    // the timeline request of a taken match failed, take() hands it out again, returns its number of failures so far
+    int  fail(const std::string& match_id);
+    // the pending matches the puuid played in that nobody works on yet, they are worked on from now on
+    void take(const std::string& puuid, std::vector<pending_match_t>* result);
+
+    struct entry_t {
+        std::shared_ptr<const nlohmann::json> match_info;
+        bool                                  is_taken;
+        int                                   n_of_failures;
+    };
+
+    std::mutex                               m_mutex;
+    append_log_t                             m_log;
+    std::unordered_map<std::string, entry_t> m_match_id_to_entry;
+};
+
+#endif // PENDING_MATCHES_H
@@ -0,0 +1,89 @@
+#include "persistence.h"
+
+#include <iostream>
+#include <cstdio>
+#include <unistd.h>
+
+static int write_file_atomically(const std::string& path, const std::string& data) {
+    const std::string tmp_path = path + ".tmp";
+
+    FILE* file = fopen(tmp_path.c_str(), "wb");
+    if (!file) {
+        return 1;
+    }
+
+    const bool is_written = fwrite(data.data(), 1, data.size(), file) == data.size() && fflush(file) == 0 && fsync(fileno(file)) == 0;
+    if (fclose(file) != 0 || !is_written) {
+        remove(tmp_path.c_str());
+        return 1;
+    }
+
+    if (rename(tmp_path.c_str(), path.c_str())) {
+        remove(tmp_path.c_str());
+        return 1;
+    }
+
+    return 0;
+}
+
+persistence_writer_t::~persistence_writer_t() {
+    destroy();
+}
+
+void persistence_writer_t::init() {
+    m_should_stop = false;
+    m_thread = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_cv.wait(lock, [this]() {
+                return m_should_stop || !m_path_to_pending_write.empty();
+            });
+            if (m_path_to_pending_write.empty()) {
+                // only reachable when stopping
+                break ;
+            }
+
+            std::unordered_map<std::string, std::function<std::string()>> path_to_write;
+            path_to_write.swap(m_path_to_pending_write);
+            lock.unlock();
+
+            for (auto& [path, serialize] : path_to_write) {
+                try {
+                    if (write_file_atomically(path, serialize())) {
+                        std::cerr << "CLIENT failed to write '" << path << "'" << std::endl;
+                    }
+                } catch (std::exception& e) {
+                    std::cerr << "CLIENT failed to serialize '" << path << "': " << e.what() << std::endl;
+                }
+            }
+
+            lock.lock();
+        }
+    });
+}
+
+void persistence_writer_t::destroy() {
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_should_stop = true;
+    }
+    m_cv.notify_all();
+
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void persistence_writer_t::write_async(const std::string& path, std::function<std::string()> serialize) {
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_path_to_pending_write[path] = std::move(serialize);
+    }
+    m_cv.notify_all();
+}
+
+void persistence_writer_t::write_json_async(const std::string& path, nlohmann::json json) {
+    write_async(path, [json = std::move(json)]() {
+        return json.dump();
+    });
+}
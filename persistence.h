@@ -0,0 +1,40 @@
+#ifndef PERSISTENCE_H
+# define PERSISTENCE_H
+
+# include <string>
+# include <functional>
+# include <unordered_map>
+# include <mutex>
+# include <condition_variable>
+# include <thread>
+
+# include "json.hpp"
+
+/**
+ * Background file writer, callers only enqueue.
+ * Serialization runs on the writer thread, each file is written to '<path>.tmp' and renamed over 'path',
+ * so readers never observe a half written file.
+ * Writes to the same path that are still pending are coalesced, only the latest one hits the disk.
+*/
+struct persistence_writer_t {
+    persistence_writer_t() = default;
+    persistence_writer_t(const persistence_writer_t&) = delete;
+    persistence_writer_t& operator=(const persistence_writer_t&) = delete;
+    ~persistence_writer_t();
+
+    void init();
+    // writes out everything pending, then stops the writer thread
+    void destroy();
+
+    void write_async(const std::string& path, std::function<std::string()> serialize);
+    // compact dump, no indentation
+    void write_json_async(const std::string& path, nlohmann::json json);
+
+    std::mutex                                                    m_mutex;
+    std::condition_variable                                       m_cv;
+    std::unordered_map<std::string, std::function<std::string()>> m_path_to_pending_write;
+    bool                                                          m_should_stop = false;
+    std::thread                                                   m_thread;
+};
+
+#endif // PERSISTENCE_H
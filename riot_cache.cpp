@@ -0,0 +1,202 @@
+#include "riot_cache.h"
+
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+
+#define RIOT_CACHE_MAGIC "LTRC"
+#define RIOT_CACHE_VERSION 1
+#define RIOT_CACHE_ENTRY_HEADER_SIZE 16
+
+static bool is_expired(int64_t expires_at, int64_t now) {
+    return expires_at != RIOT_CACHE_NEVER_EXPIRES && expires_at <= now;
+}
+
+static void append_entry(std::vector<unsigned char>* buffer, const std::string& key, const unsigned char* value, uint32_t value_size, int64_t expires_at) {
+    const uint32_t key_size = key.size();
+    unsigned char header[RIOT_CACHE_ENTRY_HEADER_SIZE];
+    memcpy(header, &key_size, sizeof(key_size));
+    memcpy(header + 4, &value_size, sizeof(value_size));
+    memcpy(header + 8, &expires_at, sizeof(expires_at));
+    buffer->insert(buffer->end(), header, header + sizeof(header));
+    buffer->insert(buffer->end(), key.begin(), key.end());
+    buffer->insert(buffer->end(), value, value + value_size);
+}
+
+riot_cache_t::~riot_cache_t() {
+    close();
+}
+
+int riot_cache_t::open(const std::string& path, size_t memory_capacity) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_memory_capacity = memory_capacity;
+    m_key_to_disk_entry.clear();
+    m_lru.clear();
+    m_key_to_lru_entry.clear();
+    m_memory_size = 0;
+    m_n_of_dead_bytes = 0;
+
+    std::vector<unsigned char> buffer;
+    if (m_log.open(path, RIOT_CACHE_MAGIC, RIOT_CACHE_VERSION, "riot cache", &buffer)) {
+        return 1;
+    }
+
+    const int64_t now = time(0);
+    uint64_t offset = APPEND_LOG_HEADER_SIZE;
+    while (offset + RIOT_CACHE_ENTRY_HEADER_SIZE <= buffer.size()) {
+        uint32_t key_size;
+        uint32_t value_size;
+        int64_t expires_at;
+        memcpy(&key_size, buffer.data() + offset, sizeof(key_size));
+        memcpy(&value_size, buffer.data() + offset + 4, sizeof(value_size));
+        memcpy(&expires_at, buffer.data() + offset + 8, sizeof(expires_at));
+        const uint64_t entry_size = RIOT_CACHE_ENTRY_HEADER_SIZE + static_cast<uint64_t>(key_size) + value_size;
+        if (buffer.size() < offset + entry_size) {
+            break ;
+        }
+
+        const std::string key(reinterpret_cast<const char*>(buffer.data() + offset + RIOT_CACHE_ENTRY_HEADER_SIZE), key_size);
+        auto disk_entry_it = m_key_to_disk_entry.find(key);
+        if (disk_entry_it != m_key_to_disk_entry.end()) {
+            m_n_of_dead_bytes += RIOT_CACHE_ENTRY_HEADER_SIZE + key.size() + disk_entry_it->second.value_size;
+            m_key_to_disk_entry.erase(disk_entry_it);
+        }
+        if (is_expired(expires_at, now)) {
+            m_n_of_dead_bytes += entry_size;
+        } else {
+            m_key_to_disk_entry[key] = {
+                .value_offset = offset + RIOT_CACHE_ENTRY_HEADER_SIZE + key_size,
+                .value_size = value_size,
+                .expires_at = expires_at
+            };
+        }
+        offset += entry_size;
+    }
+    if (m_log.truncate_torn_tail(offset)) {
+        return 1;
+    }
+
+    if (m_log.m_size / 2 < m_n_of_dead_bytes) {
+        std::vector<unsigned char> compacted(buffer.begin(), buffer.begin() + APPEND_LOG_HEADER_SIZE);
+        std::unordered_map<std::string, disk_entry_t> key_to_compacted_disk_entry;
+        for (const auto& [key, disk_entry] : m_key_to_disk_entry) {
+            append_entry(&compacted, key, buffer.data() + disk_entry.value_offset, disk_entry.value_size, disk_entry.expires_at);
+            key_to_compacted_disk_entry[key] = {
+                .value_offset = compacted.size() - disk_entry.value_size,
+                .value_size = disk_entry.value_size,
+                .expires_at = disk_entry.expires_at
+            };
+        }
+        if (m_log.rewrite(compacted) == 0) {
+            m_key_to_disk_entry.swap(key_to_compacted_disk_entry);
+            m_n_of_dead_bytes = 0;
+        } else if (!m_log.is_open()) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+void riot_cache_t::close() {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_log.close();
+}
+
+void riot_cache_t::insert_in_memory(const std::string& key, std::shared_ptr<const nlohmann::json> value, int64_t expires_at, size_t size) {
+    auto lru_entry_it = m_key_to_lru_entry.find(key);
+    if (lru_entry_it != m_key_to_lru_entry.end()) {
+        m_memory_size -= lru_entry_it->second->size;
+        m_lru.erase(lru_entry_it->second);
+        m_key_to_lru_entry.erase(lru_entry_it);
+    }
+    if (m_memory_capacity < size) {
+        return ;
+    }
+
+    m_lru.push_front({ .key = key, .value = std::move(value), .expires_at = expires_at, .size = size });
+    m_key_to_lru_entry[key] = m_lru.begin();
+    m_memory_size += size;
+    while (m_memory_capacity < m_memory_size) {
+        const memory_entry_t& least_recently_used = m_lru.back();
+        m_memory_size -= least_recently_used.size;
+        m_key_to_lru_entry.erase(least_recently_used.key);
+        m_lru.pop_back();
+    }
+}
+
+std::shared_ptr<const nlohmann::json> riot_cache_t::get(const std::string& key, int64_t now) {
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    auto lru_entry_it = m_key_to_lru_entry.find(key);
+    if (lru_entry_it != m_key_to_lru_entry.end()) {
+        if (!is_expired(lru_entry_it->second->expires_at, now)) {
+            ++m_stats.n_of_memory_hits;
+            m_lru.splice(m_lru.begin(), m_lru, lru_entry_it->second);
+            return lru_entry_it->second->value;
+        }
+        m_memory_size -= lru_entry_it->second->size;
+        m_lru.erase(lru_entry_it->second);
+        m_key_to_lru_entry.erase(lru_entry_it);
+    }
+
+    auto disk_entry_it = m_key_to_disk_entry.find(key);
+    if (!m_log.is_open() || disk_entry_it == m_key_to_disk_entry.end() || is_expired(disk_entry_it->second.expires_at, now)) {
+        ++m_stats.n_of_misses;
+        return 0;
+    }
+
+    const disk_entry_t& disk_entry = disk_entry_it->second;
+    std::vector<unsigned char> serialized_value(disk_entry.value_size);
+    if (pread(fileno(m_log.m_file), serialized_value.data(), serialized_value.size(), disk_entry.value_offset) != static_cast<ssize_t>(serialized_value.size())) {
+        ++m_stats.n_of_misses;
+        return 0;
+    }
+
+    std::shared_ptr<const nlohmann::json> value;
+    try {
+        value = std::make_shared<const nlohmann::json>(nlohmann::json::from_msgpack(serialized_value));
+    } catch (std::exception& e) {
+        std::cerr << "CLIENT corrupted riot cache entry '" << key << "'" << std::endl;
+        m_key_to_disk_entry.erase(disk_entry_it);
+        ++m_stats.n_of_misses;
+        return 0;
+    }
+    ++m_stats.n_of_disk_hits;
+    insert_in_memory(key, value, disk_entry.expires_at, serialized_value.size());
+
+    return value;
+}
+
+void riot_cache_t::put(const std::string& key, const nlohmann::json& value, int64_t expires_at) {
+    const std::vector<uint8_t> serialized_value = nlohmann::json::to_msgpack(value);
+    std::shared_ptr<const nlohmann::json> shared_value = std::make_shared<const nlohmann::json>(value);
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    insert_in_memory(key, std::move(shared_value), expires_at, serialized_value.size());
+    if (!m_log.is_open()) {
+        return ;
+    }
+
+    std::vector<unsigned char> entry;
+    append_entry(&entry, key, serialized_value.data(), serialized_value.size(), expires_at);
+    const uint64_t entry_offset = m_log.m_size;
+    if (m_log.append(entry.data(), entry.size())) {
+        return ;
+    }
+
+    auto disk_entry_it = m_key_to_disk_entry.find(key);
+    if (disk_entry_it != m_key_to_disk_entry.end()) {
+        m_n_of_dead_bytes += RIOT_CACHE_ENTRY_HEADER_SIZE + key.size() + disk_entry_it->second.value_size;
+    }
+    m_key_to_disk_entry[key] = {
+        .value_offset = entry_offset + entry.size() - serialized_value.size(),
+        .value_size = static_cast<uint32_t>(serialized_value.size()),
+        .expires_at = expires_at
+    };
+}
@@ -0,0 +1,71 @@
+#ifndef RIOT_CACHE_H
+# define RIOT_CACHE_H
+
+# include <string>
+# include <list>
+# include <memory>
+# include <unordered_map>
+# include <mutex>
+# include <atomic>
+# include <cstdint>
+
+# include "append_log.h"
+# include "json.hpp"
+
+# define RIOT_CACHE_NEVER_EXPIRES 0
+
+struct riot_cache_stats_t {
+    std::atomic<size_t> n_of_memory_hits{ 0 };
+    std::atomic<size_t> n_of_disk_hits{ 0 };
+    std::atomic<size_t> n_of_misses{ 0 };
+};
+
+/**
+ * Two tier cache of parsed Riot API responses, keyed by url.
+ * A byte bounded in-memory LRU sits in front of an append-only file holding every entry as msgpack.
+ *
+ * File layout: "LTRC" magic, u32 version, then a stream of entries
+ *   entry: u32 key size, u32 value size, i64 expires at (unix seconds, RIOT_CACHE_NEVER_EXPIRES), key, msgpack value
+ * A later entry of a key replaces the earlier ones. The file is indexed in memory on open
+ * and rewritten without replaced and expired entries once those make up more than half of it.
+*/
+struct riot_cache_t {
+    riot_cache_t() = default;
+    riot_cache_t(const riot_cache_t&) = delete;
+    riot_cache_t& operator=(const riot_cache_t&) = delete;
+    ~riot_cache_t();
+
+    int  open(const std::string& path, size_t memory_capacity);
+    void close();
+
+    // returns 0 if the key is missing or expired
+    std::shared_ptr<const nlohmann::json> get(const std::string& key, int64_t now);
+    void                                  put(const std::string& key, const nlohmann::json& value, int64_t expires_at);
+
+    struct memory_entry_t {
+        std::string                           key;
+        std::shared_ptr<const nlohmann::json> value;
+        int64_t                               expires_at;
+        size_t                                size;
+    };
+    struct disk_entry_t {
+        uint64_t value_offset;
+        uint32_t value_size;
+        int64_t  expires_at;
+    };
+
+    void insert_in_memory(const std::string& key, std::shared_ptr<const nlohmann::json> value, int64_t expires_at, size_t size);
+
+    std::mutex                                                            m_mutex;
+    append_log_t                                                          m_log;
+    uint64_t                                                              m_n_of_dead_bytes = 0;
+    std::unordered_map<std::string, disk_entry_t>                         m_key_to_disk_entry;
+    // front is the most recently used
+    std::list<memory_entry_t>                                             m_lru;
+    std::unordered_map<std::string, std::list<memory_entry_t>::iterator> m_key_to_lru_entry;
+    size_t                                                                m_memory_size = 0;
+    size_t                                                                m_memory_capacity = 0;
+    riot_cache_stats_t                                                    m_stats;
+};
+
+#endif // RIOT_CACHE_H
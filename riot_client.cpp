@@ -0,0 +1,627 @@
+#include "riot_client.h"
+
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <memory>
+#include <climits>
+#include <cstdio>
+#include <random>
+#include <ctime>
+
+static int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// routing host of the platform, for summoner/challenges endpoints
+static std::string region_to_platform_host_name(riot_api::region_t region) {
+    switch (region) {
+    case riot_api::REGION_NA: return "na1.api.riotgames.com";
+    case riot_api::REGION_LAN: return "la1.api.riotgames.com";
+    case riot_api::REGION_EUW: return "euw1.api.riotgames.com";
+    case riot_api::REGION_EUNE: return "eun1.api.riotgames.com";
+    case riot_api::REGION_OCE: return "oc1.api.riotgames.com";
+    case riot_api::REGION_KR: return "kr.api.riotgames.com";
+    default: return "euw1.api.riotgames.com";
+    }
+}
+
+// regional routing host, for match endpoints
+static std::string region_to_regional_host_name(riot_api::region_t region) {
+    switch (region) {
+    case riot_api::REGION_NA:
+    case riot_api::REGION_LAN: return "americas.api.riotgames.com";
+    case riot_api::REGION_EUW:
+    case riot_api::REGION_EUNE: return "europe.api.riotgames.com";
+    case riot_api::REGION_OCE: return "sea.api.riotgames.com";
+    case riot_api::REGION_KR: return "asia.api.riotgames.com";
+    default: return "europe.api.riotgames.com";
+    }
+}
+
+static const char* game_type_to_str(riot_api::game_type_t game_type) {
+    switch (game_type) {
+    case riot_api::GAME_TYPE_RANKED: return "ranked";
+    case riot_api::GAME_TYPE_TUTORIAL: return "tutorial";
+    case riot_api::GAME_TYPE_NORMAL: return "normal";
+    case riot_api::GAME_TYPE_TOURNEY: return "tourney";
+    default: return "ranked";
+    }
+}
+
+static std::string url_encode(const std::string& str) {
+    static const char hex_digits[] = "0123456789ABCDEF";
+    std::string result;
+    result.reserve(str.size());
+    for (unsigned char c : str) {
+        if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~') {
+            result += static_cast<char>(c);
+        } else {
+            result += '%';
+            result += hex_digits[c >> 4];
+            result += hex_digits[c & 15];
+        }
+    }
+
+    return result;
+}
+
+// "20:1,100:120" -> { {20, 1}, {100, 120} }
+static std::vector<std::pair<uint32_t, int64_t>> parse_rate_limit_header(const std::string& value) {
+    std::vector<std::pair<uint32_t, int64_t>> result;
+    size_t pair_start = 0;
+    while (pair_start < value.size()) {
+        size_t pair_end = value.find(',', pair_start);
+        if (pair_end == std::string::npos) {
+            pair_end = value.size();
+        }
+        unsigned int n = 0;
+        long long seconds = 0;
+        if (sscanf(value.c_str() + pair_start, "%u:%lld", &n, &seconds) == 2 && 0 < seconds) {
+            result.push_back({ n, seconds });
+        }
+        pair_start = pair_end + 1;
+    }
+
+    return result;
+}
+
+static void learn_rate_limits(riot_rate_bucket_t* bucket, const std::string* limits, const std::string* counts, int64_t window_slack_ms, int64_t now_ms) {
+    if (!limits) {
+        return ;
+    }
+
+    std::vector<riot_rate_window_t> windows;
+    for (const auto& [limit, seconds] : parse_rate_limit_header(*limits)) {
+        riot_rate_window_t window = {
+            .duration_ms = seconds * 1000 + window_slack_ms,
+            .limit = limit,
+            .count = 0,
+            .start_ms = 0
+        };
+        for (const riot_rate_window_t& old_window : bucket->windows) {
+            if (old_window.duration_ms == window.duration_ms) {
+                window.count = old_window.count;
+                window.start_ms = old_window.start_ms;
+            }
+        }
+        if (counts) {
+            // the server may have seen requests we did not send, e.g. from another process with the same key
+            for (const auto& [count, count_seconds] : parse_rate_limit_header(*counts)) {
+                if (count_seconds == seconds && window.count < count) {
+                    if (window.count == 0) {
+                        window.start_ms = now_ms;
+                    }
+                    window.count = count;
+                }
+            }
+        }
+        windows.push_back(window);
+    }
+
+    bucket->windows = std::move(windows);
+    bucket->is_learned = true;
+}
+
+static int64_t bucket_wait_ms(riot_rate_bucket_t* bucket, int64_t now_ms) {
+    if (!bucket->is_learned && bucket->n_of_in_flight) {
+        return INT64_MAX;
+    }
+
+    int64_t result = now_ms < bucket->blocked_until_ms ? bucket->blocked_until_ms - now_ms : 0;
+    for (riot_rate_window_t& window : bucket->windows) {
+        if (window.count && window.start_ms + window.duration_ms <= now_ms) {
+            window.count = 0;
+        }
+        if (window.limit <= window.count) {
+            result = std::max(result, window.start_ms + window.duration_ms - now_ms);
+        }
+    }
+
+    return result;
+}
+
+static void bucket_consume(riot_rate_bucket_t* bucket, int64_t now_ms) {
+    for (riot_rate_window_t& window : bucket->windows) {
+        if (window.count == 0) {
+            window.start_ms = now_ms;
+        }
+        ++window.count;
+    }
+    ++bucket->n_of_in_flight;
+}
+
+const char* riot_error_kind_to_str(riot_error_kind_t kind) {
+    switch (kind) {
+    case RIOT_ERROR_TRANSPORT: return "transport";
+    case RIOT_ERROR_RATE_LIMITED: return "rate limited";
+    case RIOT_ERROR_SERVER: return "server";
+    case RIOT_ERROR_UNAUTHORIZED: return "unauthorized";
+    case RIOT_ERROR_NOT_FOUND: return "not found";
+    case RIOT_ERROR_BAD_REQUEST: return "bad request";
+    case RIOT_ERROR_PARSE: return "parse";
+    case RIOT_ERROR_CANCELLED: return "cancelled";
+    default: return "unknown";
+    }
+}
+
+std::ostream& operator<<(std::ostream& os, const riot_error_t& error) {
+    os << riot_error_kind_to_str(error.kind) << " error";
+    if (error.status) {
+        os << " (status " << error.status << ")";
+    }
+    os << " for '" << error.url << "' after " << error.n_of_attempts << " attempt" << (error.n_of_attempts == 1 ? "" : "s");
+    if (!error.message.empty()) {
+        os << ": " << error.message;
+    }
+
+    return os;
+}
+
+static riot_error_kind_t status_to_error_kind(int status) {
+    if (status == 429) {
+        return RIOT_ERROR_RATE_LIMITED;
+    }
+    if (500 <= status) {
+        return RIOT_ERROR_SERVER;
+    }
+    if (status == 401 || status == 403) {
+        return RIOT_ERROR_UNAUTHORIZED;
+    }
+    if (status == 404) {
+        return RIOT_ERROR_NOT_FOUND;
+    }
+
+    return RIOT_ERROR_BAD_REQUEST;
+}
+
+static riot_error_t make_error(const riot_request_t& request, riot_error_kind_t kind, int status, const std::string& message) {
+    return {
+        .kind = kind,
+        .status = status,
+        .n_of_attempts = request.n_of_attempts,
+        .url = request.host_name + "/" + request.path_name,
+        .message = message
+    };
+}
+
+riot_client_t::~riot_client_t() {
+    destroy();
+}
+
+int riot_client_t::init(http_pool_t* pool, const std::string& api_key) {
+    m_pool = pool;
+    m_api_key = api_key;
+    m_should_stop = false;
+
+    m_scheduler = std::thread([this]() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (!m_should_stop) {
+            const int64_t now = now_ms();
+            int64_t wait_ms = INT64_MAX;
+            for (auto request_it = m_queue.begin(); request_it != m_queue.end();) {
+                const int64_t request_wait_ms = try_acquire(*request_it, now);
+                if (request_wait_ms == 0) {
+                    dispatch(std::move(*request_it));
+                    request_it = m_queue.erase(request_it);
+                    continue ;
+                }
+                wait_ms = std::min(wait_ms, request_wait_ms);
+                ++request_it;
+            }
+
+            if (wait_ms == INT64_MAX) {
+                m_cv.wait(lock);
+            } else {
+                m_cv.wait_for(lock, std::chrono::milliseconds(wait_ms));
+            }
+        }
+    });
+
+    return 0;
+}
+
+void riot_client_t::destroy() {
+    std::deque<riot_request_t> unsent_requests;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_should_stop = true;
+        unsent_requests.swap(m_queue);
+    }
+    m_cv.notify_all();
+
+    if (m_scheduler.joinable()) {
+        m_scheduler.join();
+    }
+
+    for (riot_request_t& request : unsent_requests) {
+        request.on_failure(make_error(request, RIOT_ERROR_CANCELLED, 0, "client destroyed"));
+    }
+}
+
+int64_t riot_client_t::try_acquire(const riot_request_t& request, int64_t now_ms) {
+    if (now_ms < request.not_before_ms) {
+        return request.not_before_ms - now_ms;
+    }
+
+    auto app_bucket_it = m_host_name_to_app_bucket.find(request.host_name);
+    if (app_bucket_it == m_host_name_to_app_bucket.end()) {
+        riot_rate_bucket_t app_bucket;
+        learn_rate_limits(&app_bucket, &m_default_app_rate_limits, 0, m_window_slack_ms, now_ms);
+        app_bucket_it = m_host_name_to_app_bucket.insert({ request.host_name, std::move(app_bucket) }).first;
+    }
+    riot_rate_bucket_t* app_bucket = &app_bucket_it->second;
+    riot_rate_bucket_t* method_bucket = &m_method_key_to_method_bucket[request.host_name + " " + request.method_name];
+
+    const int64_t wait_ms = std::max(bucket_wait_ms(app_bucket, now_ms), bucket_wait_ms(method_bucket, now_ms));
+    if (wait_ms == 0) {
+        bucket_consume(app_bucket, now_ms);
+        bucket_consume(method_bucket, now_ms);
+    }
+
+    return wait_ms;
+}
+
+void riot_client_t::on_response_headers(const riot_request_t& request, const http_response_t* response, int64_t now_ms) {
+    riot_rate_bucket_t* app_bucket = &m_host_name_to_app_bucket[request.host_name];
+    riot_rate_bucket_t* method_bucket = &m_method_key_to_method_bucket[request.host_name + " " + request.method_name];
+    if (app_bucket->n_of_in_flight) {
+        --app_bucket->n_of_in_flight;
+    }
+    if (method_bucket->n_of_in_flight) {
+        --method_bucket->n_of_in_flight;
+    }
+    if (!response) {
+        return ;
+    }
+
+    learn_rate_limits(app_bucket, response->find_header("x-app-rate-limit"), response->find_header("x-app-rate-limit-count"), m_window_slack_ms, now_ms);
+    learn_rate_limits(method_bucket, response->find_header("x-method-rate-limit"), response->find_header("x-method-rate-limit-count"), m_window_slack_ms, now_ms);
+
+    if (response->status == 429) {
+        ++m_stats.n_of_rate_limited_responses;
+        const std::string* retry_after = response->find_header("retry-after");
+        const std::string* rate_limit_type = response->find_header("x-rate-limit-type");
+        const int64_t retry_after_ms = retry_after ? std::max(1ll, atoll(retry_after->c_str())) * 1000 : 1000;
+        riot_rate_bucket_t* blocked_bucket = rate_limit_type && *rate_limit_type == "application" ? app_bucket : method_bucket;
+        blocked_bucket->blocked_until_ms = std::max(blocked_bucket->blocked_until_ms, now_ms + retry_after_ms);
+    }
+}
+
+int riot_client_t::retry(riot_request_t* request, const riot_error_t& error, const http_response_t* response) {
+    const bool is_transient = error.kind == RIOT_ERROR_TRANSPORT || error.kind == RIOT_ERROR_RATE_LIMITED || error.kind == RIOT_ERROR_SERVER;
+    if (!is_transient || m_retry_policy.max_attempts <= request->n_of_attempts) {
+        return 1;
+    }
+
+    int64_t delay_ms = 0;
+    const std::string* retry_after = response ? response->find_header("retry-after") : 0;
+    if (retry_after) {
+        delay_ms = std::max(0ll, atoll(retry_after->c_str())) * 1000;
+    } else {
+        // full jitter, spreads the retries of a burst that failed together
+        thread_local std::mt19937_64 random_engine(std::random_device{}());
+        const int64_t ceiling_ms = std::min(m_retry_policy.max_delay_ms, m_retry_policy.base_delay_ms << std::min(request->n_of_attempts - 1, 20));
+        delay_ms = std::uniform_int_distribution<int64_t>(0, std::max<int64_t>(ceiling_ms - 1, 0))(random_engine);
+    }
+    request->not_before_ms = now_ms() + delay_ms;
+
+    ++m_stats.n_of_retries;
+    std::cerr << "CLIENT retrying after " << error << " in " << delay_ms << "ms" << std::endl;
+    submit(std::move(*request));
+
+    return 0;
+}
+
+void riot_client_t::dispatch(riot_request_t request) {
+    ++m_stats.n_of_requests;
+    ++request.n_of_attempts;
+    m_pool->m_executor.submit([this, request = std::move(request)]() mutable {
+        http_request_t http_request = {
+            .scheme = m_scheme,
+            .host_name = m_host_name_override.empty() ? request.host_name : m_host_name_override,
+            .port = m_port,
+            .path_name = request.path_name,
+            .headers = { { .name = "X-Riot-Token", .value = m_api_key } }
+        };
+        http_request.headers.insert(http_request.headers.end(), request.headers.begin(), request.headers.end());
+        http_response_t response;
+        bool is_body_rejected = false;
+        const int result = !request.on_data ?
+            m_pool->request(http_request, &response) :
+            m_pool->request_streamed(http_request, &response, [&request, &response, &is_body_rejected](const char* data, size_t size) {
+                // error bodies are kept as usual, only a success is streamed
+                if (response.status < 200 || 300 <= response.status) {
+                    response.body.append(data, size);
+                    return 0;
+                }
+                is_body_rejected = request.on_data(request, data, size) != 0;
+                return is_body_rejected ? 1 : 0;
+            });
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            on_response_headers(request, result && !is_body_rejected ? 0 : &response, now_ms());
+        }
+        m_cv.notify_all();
+
+        if (is_body_rejected) {
+            request.on_failure(make_error(request, RIOT_ERROR_PARSE, response.status, "malformed body"));
+            return ;
+        }
+
+        const bool is_not_modified = response.status == 304 && !request.headers.empty();
+        if (result == 0 && ((200 <= response.status && response.status < 300) || is_not_modified)) {
+            request.on_response(request, response);
+            return ;
+        }
+
+        const riot_error_t error = result ?
+            make_error(request, RIOT_ERROR_TRANSPORT, 0, "no response") :
+            make_error(request, status_to_error_kind(response.status), response.status, "");
+        if (retry(&request, error, result ? 0 : &response)) {
+            request.on_failure(error);
+        }
+    });
+}
+
+void riot_client_t::submit(riot_request_t request) {
+    bool is_queued = false;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (!m_should_stop) {
+            m_queue.push_back(std::move(request));
+            is_queued = true;
+        }
+    }
+    if (!is_queued) {
+        request.on_failure(make_error(request, RIOT_ERROR_CANCELLED, 0, "client destroyed"));
+        return ;
+    }
+
+    m_cv.notify_all();
+}
+
+void riot_client_t::get_json_async(
+    const std::string& host_name, const std::string& method_name, const std::string& path_name,
+    std::function<void(const nlohmann::json& result)> on_success,
+    std::function<void(const riot_error_t& error)> on_failure
+) {
+    const std::string url = host_name + "/" + path_name;
+    const bool is_revalidated = m_http_cache && m_revalidated_method_names.count(method_name);
+    // both caches are keyed by where the request actually goes, a stand-in's responses are not served for the real host
+    const std::string cache_url = m_scheme + "://" + (m_host_name_override.empty() ? host_name : m_host_name_override) + ":" + std::to_string(m_port) + "/" + path_name;
+
+    auto cache_ttl_it = m_method_name_to_cache_ttl.find(method_name);
+    const int64_t cache_ttl = m_cache && cache_ttl_it != m_method_name_to_cache_ttl.end() ? cache_ttl_it->second : 0;
+    if (cache_ttl) {
+        std::shared_ptr<const nlohmann::json> cached_result = m_cache->get(cache_url, time(0));
+        if (cached_result) {
+            // hits are delivered from the executor as well, callbacks never run inside the call
+            m_pool->m_executor.submit([cached_result, on_success]() {
+                on_success(*cached_result);
+            });
+            return ;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_in_flight_mutex);
+        auto waiters_it = m_url_to_in_flight_waiters.find(url);
+        if (waiters_it != m_url_to_in_flight_waiters.end()) {
+            ++m_stats.n_of_coalesced;
+            waiters_it->second.push_back({ .on_success = std::move(on_success), .on_failure = std::move(on_failure) });
+            return ;
+        }
+        m_url_to_in_flight_waiters[url].push_back({ .on_success = std::move(on_success), .on_failure = std::move(on_failure) });
+    }
+
+    // the waiters are taken out before any of them runs, a callback repeating the call starts a new request
+    auto take_waiters = [this, url]() {
+        std::lock_guard<std::mutex> guard(m_in_flight_mutex);
+        auto waiters_it = m_url_to_in_flight_waiters.find(url);
+        std::vector<riot_json_waiter_t> waiters = std::move(waiters_it->second);
+        m_url_to_in_flight_waiters.erase(waiters_it);
+        return waiters;
+    };
+
+    riot_request_t request = {
+        .host_name = host_name,
+        .method_name = method_name,
+        .path_name = path_name,
+        .headers = {},
+        .on_response = [this, url, cache_ttl, is_revalidated, cache_url, take_waiters](const riot_request_t& request, const http_response_t& response) {
+            mapped_file_t kept_body;
+            if (response.status == 304 && m_http_cache->read_body(cache_url, &kept_body)) {
+                const riot_error_t error = make_error(request, RIOT_ERROR_PARSE, response.status, "revalidated body is missing");
+                for (riot_json_waiter_t& waiter : take_waiters()) {
+                    waiter.on_failure(error);
+                }
+                return ;
+            }
+            nlohmann::json result;
+            try {
+                result = response.status == 304 ?
+                    nlohmann::json::parse(kept_body.m_data, kept_body.m_data + kept_body.m_size) :
+                    nlohmann::json::parse(response.body);
+            } catch (std::exception& e) {
+                const riot_error_t error = make_error(request, RIOT_ERROR_PARSE, response.status, e.what());
+                for (riot_json_waiter_t& waiter : take_waiters()) {
+                    waiter.on_failure(error);
+                }
+                return ;
+            }
+            if (is_revalidated && response.status != 304 && m_http_cache->store(cache_url, response, response.body)) {
+                std::cerr << "CLIENT failed to keep the body of '" << url << "' for revalidation" << std::endl;
+            }
+            if (cache_ttl) {
+                m_cache->put(cache_url, result, cache_ttl == RIOT_CLIENT_CACHE_FOREVER ? RIOT_CACHE_NEVER_EXPIRES : time(0) + cache_ttl);
+            }
+            for (riot_json_waiter_t& waiter : take_waiters()) {
+                waiter.on_success(result);
+            }
+        },
+        .on_data = {},
+        .on_failure = [take_waiters](const riot_error_t& error) {
+            for (riot_json_waiter_t& waiter : take_waiters()) {
+                waiter.on_failure(error);
+            }
+        },
+        .n_of_attempts = 0,
+        .not_before_ms = 0
+    };
+    if (is_revalidated) {
+        m_http_cache->add_validators(cache_url, &request.headers);
+    }
+    submit(std::move(request));
+}
+
+void riot_client_t::get_puuid_async(
+    const std::string& game_name, const std::string& tag_line,
+    std::function<void(const std::string& resulting_puuid)> on_success,
+    std::function<void(const riot_error_t& error)> on_failure
+) {
+    get_json_async(
+        m_account_host_name, "account-v1.by-riot-id",
+        "riot/account/v1/accounts/by-riot-id/" + url_encode(game_name) + "/" + url_encode(tag_line),
+        [game_name, tag_line, on_success, on_failure](const nlohmann::json& result) {
+            if (!result.contains("puuid") || !result["puuid"].is_string()) {
+                on_failure({
+                    .kind = RIOT_ERROR_PARSE,
+                    .status = 200,
+                    .n_of_attempts = 1,
+                    .url = "account-v1/" + game_name + "#" + tag_line,
+                    .message = "response has no puuid"
+                });
+                return ;
+            }
+            on_success(result["puuid"].get<std::string>());
+        },
+        on_failure
+    );
+}
+
+void riot_client_t::get_match_history_async(
+    riot_api::region_t region, riot_api::game_type_t game_type, const std::string& puuid,
+    std::function<void(const nlohmann::json& resulting_match_history)> on_success,
+    std::function<void(const riot_error_t& error)> on_failure
+) {
+    get_match_ids_async(region, game_type, puuid, 0, 20, std::move(on_success), std::move(on_failure));
+}
+
+void riot_client_t::get_match_ids_async(
+    riot_api::region_t region, riot_api::game_type_t game_type, const std::string& puuid, size_t start, size_t count,
+    std::function<void(const nlohmann::json& resulting_match_ids)> on_success,
+    std::function<void(const riot_error_t& error)> on_failure
+) {
+    get_json_async(
+        region_to_regional_host_name(region), "match-v5.ids-by-puuid",
+        "lol/match/v5/matches/by-puuid/" + url_encode(puuid) + "/ids?type=" + game_type_to_str(game_type) + "&start=" + std::to_string(start) + "&count=" + std::to_string(count),
+        std::move(on_success), std::move(on_failure)
+    );
+}
+
+void riot_client_t::get_match_info_async(
+    riot_api::region_t region, const std::string& match_id,
+    std::function<void(const nlohmann::json& resulting_match_info)> on_success,
+    std::function<void(const riot_error_t& error)> on_failure
+) {
+    get_json_async(
+        region_to_regional_host_name(region), "match-v5.match",
+        "lol/match/v5/matches/" + url_encode(match_id),
+        std::move(on_success), std::move(on_failure)
+    );
+}
+
+void riot_client_t::get_match_timeline_async(
+    riot_api::region_t region, const std::string& match_id,
+    std::function<void(const nlohmann::json& resulting_match_timeline)> on_success,
+    std::function<void(const riot_error_t& error)> on_failure
+) {
+    get_json_async(
+        region_to_regional_host_name(region), "match-v5.timeline",
+        "lol/match/v5/matches/" + url_encode(match_id) + "/timeline",
+        std::move(on_success), std::move(on_failure)
+    );
+}
+
+void riot_client_t::get_match_timeline_decoded_async(
+    riot_api::region_t region, const std::string& match_id,
+    std::function<void(const match_timeline_t& resulting_match_timeline)> on_success,
+    std::function<void(const riot_error_t& error)> on_failure
+) {
+    // decoded as the body arrives, the timeline json is never held whole
+    struct timeline_stream_t {
+        match_timeline_t         timeline;
+        match_timeline_decoder_t decoder{ &timeline };
+        int                      n_of_attempts = 0;
+    };
+    std::shared_ptr<timeline_stream_t> timeline_stream = std::make_shared<timeline_stream_t>();
+    riot_request_t request = {
+        .host_name = region_to_regional_host_name(region),
+        .method_name = "match-v5.timeline",
+        .path_name = "lol/match/v5/matches/" + url_encode(match_id) + "/timeline",
+        .headers = {},
+        .on_response = [on_success, on_failure, timeline_stream](const riot_request_t& request, const http_response_t& response) {
+            if (timeline_stream->n_of_attempts != request.n_of_attempts || timeline_stream->decoder.finish()) {
+                on_failure(make_error(request, RIOT_ERROR_PARSE, response.status, "malformed timeline"));
+                return ;
+            }
+            on_success(timeline_stream->timeline);
+        },
+        .on_data = [timeline_stream](const riot_request_t& request, const char* data, size_t size) {
+            if (timeline_stream->n_of_attempts != request.n_of_attempts) {
+                timeline_stream->decoder.reset();
+                timeline_stream->n_of_attempts = request.n_of_attempts;
+            }
+            return timeline_stream->decoder.write(data, size);
+        },
+        .on_failure = on_failure,
+        .n_of_attempts = 0,
+        .not_before_ms = 0
+    };
+    submit(std::move(request));
+}
+
+void riot_client_t::get_challenges_info_async(
+    riot_api::region_t region,
+    std::function<void(const nlohmann::json& resulting_challenges_info)> on_success,
+    std::function<void(const riot_error_t& error)> on_failure
+) {
+    get_json_async(
+        region_to_platform_host_name(region), "challenges-v1.config",
+        "lol/challenges/v1/challenges/config",
+        std::move(on_success), std::move(on_failure)
+    );
+}
+
+void riot_client_t::get_challenges_by_puuid_async(
+    riot_api::region_t region, const std::string& puuid,
+    std::function<void(const nlohmann::json& resulting_challenges_info_for_puuid)> on_success,
+    std::function<void(const riot_error_t& error)> on_failure
+) {
+    get_json_async(
+        region_to_platform_host_name(region), "challenges-v1.player-data",
+        "lol/challenges/v1/player-data/" + url_encode(puuid),
+        std::move(on_success), std::move(on_failure)
+    );
+}
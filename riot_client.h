@@ -0,0 +1,240 @@
+#ifndef RIOT_CLIENT_H
+# define RIOT_CLIENT_H
+
+# include <string>
+# include <functional>
+# include <deque>
+# include <vector>
+# include <unordered_map>
+# include <unordered_set>
+# include <mutex>
+# include <condition_variable>
+# include <thread>
+# include <atomic>
+# include <cstdint>
+# include <ostream>
+
+# include "json.hpp"
+# include "riot.h"
+# include "http.h"
+# include "http_cache.h"
+# include "riot_cache.h"
+# include "timeline.h"
+
+# define RIOT_CLIENT_CACHE_FOREVER -1
+
+struct riot_rate_window_t {
+    int64_t  duration_ms;
+    uint32_t limit;
+    uint32_t count;
+    int64_t  start_ms;
+};
+
+/**
+ * Limits of one Riot rate limit scope (the app on a routing host, or one method on it),
+ * each window allows 'limit' requests and is refilled once 'duration_ms' has passed since its first request.
+*/
+struct riot_rate_bucket_t {
+    std::vector<riot_rate_window_t> windows;
+    int64_t                         blocked_until_ms = 0;
+    // until the first response tells the limits, only one request of the scope is let through at a time
+    bool                            is_learned = false;
+    uint32_t                        n_of_in_flight = 0;
+};
+
+enum riot_error_kind_t {
+    RIOT_ERROR_TRANSPORT,    // no response, connection or tls failure
+    RIOT_ERROR_RATE_LIMITED, // 429
+    RIOT_ERROR_SERVER,       // 5xx
+    RIOT_ERROR_UNAUTHORIZED, // 401/403, usually an expired api key
+    RIOT_ERROR_NOT_FOUND,    // 404
+    RIOT_ERROR_BAD_REQUEST,  // any other 4xx
+    RIOT_ERROR_PARSE,        // 2xx with a body that is not the expected json
+    RIOT_ERROR_CANCELLED,    // client destroyed before the request was sent
+
+    _RIOT_ERROR_SIZE
+};
+const char* riot_error_kind_to_str(riot_error_kind_t kind);
+
+struct riot_error_t {
+    riot_error_kind_t kind;
+    int               status;      // 0 if no response arrived
+    int               n_of_attempts;
+    std::string       url;
+    std::string       message;
+};
+std::ostream& operator<<(std::ostream& os, const riot_error_t& error);
+
+struct riot_retry_policy_t {
+    int     max_attempts = 4;
+    // delay before retry n is uniform in [0, min(max_delay_ms, base_delay_ms * 2^n)), unless the server sent Retry-After
+    int64_t base_delay_ms = 500;
+    int64_t max_delay_ms = 30000;
+};
+
+struct riot_request_t {
+    std::string                                                                         host_name;
+    std::string                                                                         method_name;
+    std::string                                                                         path_name;
+    // sent along with the api key
+    std::vector<http_header_t>                                                          headers;
+    // 2xx responses only, and 304 if headers carry validators
+    std::function<void(const riot_request_t& request, const http_response_t& response)> on_response;
+    // optional, a 2xx body is handed to it as it arrives instead of being kept in the response, before on_response
+    // a retried request delivers its body again with a higher n_of_attempts, a nonzero return fails the request as malformed
+    std::function<int(const riot_request_t& request, const char* data, size_t size)>   on_data;
+    std::function<void(const riot_error_t& error)>                                      on_failure;
+    int                                                                                 n_of_attempts;
+    int64_t                                                                             not_before_ms;
+};
+
+struct riot_json_waiter_t {
+    std::function<void(const nlohmann::json& result)> on_success;
+    std::function<void(const riot_error_t& error)>    on_failure;
+};
+
+struct riot_client_stats_t {
+    std::atomic<size_t> n_of_requests{ 0 };
+    std::atomic<size_t> n_of_rate_limited_responses{ 0 };
+    std::atomic<size_t> n_of_retries{ 0 };
+    // calls that joined an identical request already in flight instead of sending their own
+    std::atomic<size_t> n_of_coalesced{ 0 };
+};
+
+/**
+ * Riot API client on top of the tracker's http_pool_t, with the same calls as gil_riot's riot_api.
+ * Requests are queued and let out by a scheduler thread at the pace the app and method rate limits allow,
+ * the limits are learned from the X-App-Rate-Limit/X-Method-Rate-Limit response headers.
+ * Transport failures, 429 and 5xx are retried with jittered exponential backoff (or after Retry-After) through the same queue,
+ * on_failure gets the error of the last attempt.
+ * Identical calls made while one is in flight share its network call and all get its result.
+ * With a cache set, responses of the methods in m_method_name_to_cache_ttl are served from it until their ttl runs out.
+ * With an http cache set, the methods in m_revalidated_method_names are then asked with the validators of their last body,
+ * a 304 is answered from the kept body so an unchanged challenge config is not downloaded again.
+ *
+ * Example call:
+ * riot_client_t riot;
+ * riot.init(&pool, api_key);
+ * riot.get_puuid_async(
+ *   "game_name", "tag_line",
+ *   [](const std::string& resulting_puuid) {
+ *     // ...
+ *   },
+ *   [](const riot_error_t& error) {
+ *     std::cerr << error << std::endl;
+ *   }
+ * );
+*/
+struct riot_client_t {
+    riot_client_t() = default;
+    riot_client_t(const riot_client_t&) = delete;
+    riot_client_t& operator=(const riot_client_t&) = delete;
+    ~riot_client_t();
+
+    int  init(http_pool_t* pool, const std::string& api_key);
+    // queued requests that were not sent yet fail with RIOT_ERROR_CANCELLED
+    void destroy();
+
+    void get_puuid_async(
+        const std::string& game_name, const std::string& tag_line,
+        std::function<void(const std::string& resulting_puuid)> on_success,
+        std::function<void(const riot_error_t& error)> on_failure
+    );
+
+    void get_match_history_async(
+        riot_api::region_t region, riot_api::game_type_t game_type, const std::string& puuid,
+        std::function<void(const nlohmann::json& resulting_match_history)> on_success,
+        std::function<void(const riot_error_t& error)> on_failure
+    );
+
+    // page of match ids, most recent first, count is at most 100
+    void get_match_ids_async(
+        riot_api::region_t region, riot_api::game_type_t game_type, const std::string& puuid, size_t start, size_t count,
+        std::function<void(const nlohmann::json& resulting_match_ids)> on_success,
+        std::function<void(const riot_error_t& error)> on_failure
+    );
+
+    void get_match_info_async(
+        riot_api::region_t region, const std::string& match_id,
+        std::function<void(const nlohmann::json& resulting_match_info)> on_success,
+        std::function<void(const riot_error_t& error)> on_failure
+    );
+
+    void get_match_timeline_async(
+        riot_api::region_t region, const std::string& match_id,
+        std::function<void(const nlohmann::json& resulting_match_timeline)> on_success,
+        std::function<void(const riot_error_t& error)> on_failure
+    );
+
+    // same request, decoded straight from the response body into the compact form, neither cached nor coalesced
+    void get_match_timeline_decoded_async(
+        riot_api::region_t region, const std::string& match_id,
+        std::function<void(const match_timeline_t& resulting_match_timeline)> on_success,
+        std::function<void(const riot_error_t& error)> on_failure
+    );
+
+    void get_challenges_info_async(
+        riot_api::region_t region,
+        std::function<void(const nlohmann::json& resulting_challenges_info)> on_success,
+        std::function<void(const riot_error_t& error)> on_failure
+    );
+
+    void get_challenges_by_puuid_async(
+        riot_api::region_t region, const std::string& puuid,
+        std::function<void(const nlohmann::json& resulting_challenges_info_for_puuid)> on_success,
+        std::function<void(const riot_error_t& error)> on_failure
+    );
+
+    void submit(riot_request_t request);
+    void get_json_async(
+        const std::string& host_name, const std::string& method_name, const std::string& path_name,
+        std::function<void(const nlohmann::json& result)> on_success,
+        std::function<void(const riot_error_t& error)> on_failure
+    );
+
+    // returns 0 if the request may go now and consumes from its buckets, otherwise how long to wait, INT64_MAX for the next response
+    int64_t try_acquire(const riot_request_t& request, int64_t now_ms);
+    // response: 0 if the request failed before a response arrived
+    void    on_response_headers(const riot_request_t& request, const http_response_t* response, int64_t now_ms);
+    void    dispatch(riot_request_t request);
+    // requeues the request if the error is transient and attempts are left, returns 1 if it did not
+    int     retry(riot_request_t* request, const riot_error_t& error, const http_response_t* response);
+
+    http_pool_t*                                                     m_pool = 0;
+    std::string                                                      m_api_key;
+    // routing host for account lookups, riot ids are global so any host answers
+    std::string                                                      m_account_host_name = "europe.api.riotgames.com";
+    // every request goes to m_host_name_override instead of the Riot host when set, for local stand-ins
+    std::string                                                      m_scheme = "https";
+    std::string                                                      m_host_name_override;
+    size_t                                                           m_port = 443;
+    riot_retry_policy_t                                              m_retry_policy;
+    riot_cache_t*                                                    m_cache = 0;
+    // seconds, RIOT_CLIENT_CACHE_FOREVER for immutable objects, methods not listed are never cached
+    std::unordered_map<std::string, int64_t>                         m_method_name_to_cache_ttl = {
+        { "account-v1.by-riot-id", 30 * 24 * 60 * 60 },
+        { "match-v5.ids-by-puuid", 60 },
+        { "match-v5.match", RIOT_CLIENT_CACHE_FOREVER },
+        { "match-v5.timeline", RIOT_CLIENT_CACHE_FOREVER },
+        { "challenges-v1.config", 24 * 60 * 60 }
+    };
+    http_cache_t*                                                    m_http_cache = 0;
+    // large bodies that rarely change, kept in m_http_cache with their ETag/Last-Modified
+    std::unordered_set<std::string>                                  m_revalidated_method_names = { "challenges-v1.config" };
+    // development key limits, used for a host until its first response tells the real ones
+    std::string                                                      m_default_app_rate_limits = "20:1,100:120";
+    // added to every window, our windows start when we send while Riot's start when it receives
+    int64_t                                                          m_window_slack_ms = 100;
+    std::mutex                                                       m_mutex;
+    std::condition_variable                                          m_cv;
+    std::deque<riot_request_t>                                       m_queue;
+    std::unordered_map<std::string, riot_rate_bucket_t>              m_host_name_to_app_bucket;
+    std::unordered_map<std::string, riot_rate_bucket_t>              m_method_key_to_method_bucket;
+    bool                                                             m_should_stop = false;
+    std::thread                                                      m_scheduler;
+    std::mutex                                                       m_in_flight_mutex;
+    std::unordered_map<std::string, std::vector<riot_json_waiter_t>> m_url_to_in_flight_waiters;
+    riot_client_stats_t                                              m_stats;
+};
+
+#endif // RIOT_CLIENT_H
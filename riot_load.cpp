@@ -0,0 +1,402 @@
+#include "riot_mock.h"
+#include "riot_client.h"
+#include "riot_cache.h"
+#include "http_cache.h"
+#include "match_ingester.h"
+#include "http_server.h"
+
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <filesystem>
+#include <unordered_set>
+#include <cstring>
+
+/**
+ * Load generator for the riot_api path: account lookups, challenges, match ingestion, timelines and cached match reads
+ * go through riot_client_t, riot_cache_t, http_cache_t and match_ingester_t against riot_mock_t, in process unless --address names a running riot_mock_server.
+ * Each phase runs on its own and reports throughput, call latencies, retries and what the server answered.
+ *
+ * Example call:
+ * ./riot_load --players 20 --matches 200 --latency 40 --jitter 30 --error-rate 0.02
+ * ./riot_load --app-limits 20:1,100:120 --players 5 --matches 20
+*/
+
+struct riot_load_args_t {
+    std::string        address;
+    riot_mock_config_t mock_config;
+    size_t             n_of_players = 20;
+    size_t             n_of_matches_per_player = 200;
+    size_t             n_of_timelines = 200;
+    size_t             n_of_connections = 8;
+    std::string        cache_path = "riot_load_cache.bin";
+    std::string        http_cache_directory = "riot_load_http_cache";
+};
+
+/**
+ * Calls of one phase, counted in and out so the phase can wait for the last callback.
+*/
+struct load_phase_t {
+    explicit load_phase_t(const std::string& name) : m_name(name), m_start(std::chrono::steady_clock::now()) {}
+
+    std::chrono::steady_clock::time_point begin_call() {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        ++m_n_of_pending;
+        return std::chrono::steady_clock::now();
+    }
+
+    void end_call(std::chrono::steady_clock::time_point call_start, const riot_error_t* error) {
+        const uint64_t latency_us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - call_start).count();
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            m_latencies_us.push_back(latency_us);
+            if (error) {
+                ++m_n_of_errors_by_kind[error->kind];
+            } else {
+                ++m_n_of_ok;
+            }
+            --m_n_of_pending;
+        }
+        m_cv.notify_all();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_cv.wait(lock, [this]() {
+            return m_n_of_pending == 0;
+        });
+    }
+
+    std::string                           m_name;
+    std::chrono::steady_clock::time_point m_start;
+    std::mutex                            m_mutex;
+    std::condition_variable               m_cv;
+    size_t                                m_n_of_pending = 0;
+    size_t                                m_n_of_ok = 0;
+    size_t                                m_n_of_errors_by_kind[_RIOT_ERROR_SIZE] = { 0 };
+    std::vector<uint64_t>                 m_latencies_us;
+};
+
+struct load_counters_t {
+    size_t n_of_requests;
+    size_t n_of_retries;
+    size_t n_of_rate_limited;
+    size_t n_of_coalesced;
+    size_t n_of_cache_hits;
+    size_t n_of_body_bytes_received;
+    size_t n_of_served;
+    size_t n_of_injected_errors;
+};
+
+static double percentile_ms(std::vector<uint64_t> samples, double fraction) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    const size_t index = std::min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index] / 1000.0;
+}
+
+static load_counters_t take_counters(riot_client_t* riot, riot_cache_t* riot_cache, riot_mock_t* riot_mock) {
+    return {
+        .n_of_requests = riot->m_stats.n_of_requests,
+        .n_of_retries = riot->m_stats.n_of_retries,
+        .n_of_rate_limited = riot->m_stats.n_of_rate_limited_responses,
+        .n_of_coalesced = riot->m_stats.n_of_coalesced,
+        .n_of_cache_hits = riot_cache->m_stats.n_of_memory_hits + riot_cache->m_stats.n_of_disk_hits,
+        .n_of_body_bytes_received = riot->m_pool->m_stats.n_of_body_bytes_received,
+        .n_of_served = riot_mock ? riot_mock->m_stats.n_of_requests.load() : 0,
+        .n_of_injected_errors = riot_mock ? riot_mock->m_stats.n_of_injected_errors.load() : 0
+    };
+}
+
+static void report(load_phase_t* phase, size_t n_of_items, const load_counters_t& before, const load_counters_t& after) {
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - phase->m_start).count();
+    std::cout << phase->m_name << ": " << phase->m_n_of_ok << " ok";
+    for (int kind = 0; kind < _RIOT_ERROR_SIZE; ++kind) {
+        if (phase->m_n_of_errors_by_kind[kind]) {
+            std::cout << ", " << phase->m_n_of_errors_by_kind[kind] << " " << riot_error_kind_to_str(static_cast<riot_error_kind_t>(kind));
+        }
+    }
+    std::cout << " in " << seconds * 1000.0 << " ms, " << n_of_items / std::max(seconds, 1e-9) << "/s" << std::endl;
+    if (!phase->m_latencies_us.empty()) {
+        std::cout << "  latency p50 " << percentile_ms(phase->m_latencies_us, 0.5) << " ms, p99 " << percentile_ms(phase->m_latencies_us, 0.99)
+                  << " ms, max " << percentile_ms(phase->m_latencies_us, 1.0) << " ms" << std::endl;
+    }
+    std::cout << "  client " << after.n_of_requests - before.n_of_requests << " requests, " << after.n_of_retries - before.n_of_retries << " retries, "
+              << after.n_of_rate_limited - before.n_of_rate_limited << " 429s, " << after.n_of_coalesced - before.n_of_coalesced << " coalesced, "
+              << after.n_of_cache_hits - before.n_of_cache_hits << " cache hits, " << after.n_of_body_bytes_received - before.n_of_body_bytes_received << " body bytes";
+    if (after.n_of_served) {
+        std::cout << "; server " << after.n_of_served - before.n_of_served << " answered, " << after.n_of_injected_errors - before.n_of_injected_errors << " injected errors";
+    }
+    std::cout << std::endl;
+}
+
+static int parse_args(int argc, char** argv, riot_load_args_t* args) {
+    // a production key's limits by default so the client, not the mock, is what is measured
+    args->mock_config.app_rate_limits = "500:10,30000:600";
+    args->mock_config.method_rate_limits = "2000:10";
+    for (int arg_index = 1; arg_index < argc; ++arg_index) {
+        const bool has_value = arg_index + 1 < argc;
+        if (!strcmp(argv[arg_index], "--address") && has_value) {
+            args->address = argv[++arg_index];
+        } else if (!strcmp(argv[arg_index], "--players") && has_value) {
+            args->n_of_players = std::stoul(argv[++arg_index]);
+        } else if (!strcmp(argv[arg_index], "--matches") && has_value) {
+            args->n_of_matches_per_player = std::stoul(argv[++arg_index]);
+        } else if (!strcmp(argv[arg_index], "--timelines") && has_value) {
+            args->n_of_timelines = std::stoul(argv[++arg_index]);
+        } else if (!strcmp(argv[arg_index], "--connections") && has_value) {
+            args->n_of_connections = std::stoul(argv[++arg_index]);
+        } else if (!strcmp(argv[arg_index], "--cache") && has_value) {
+            args->cache_path = argv[++arg_index];
+        } else if (!strcmp(argv[arg_index], "--http-cache") && has_value) {
+            args->http_cache_directory = argv[++arg_index];
+        } else if (!strcmp(argv[arg_index], "--latency") && has_value) {
+            args->mock_config.latency_ms = std::stoi(argv[++arg_index]);
+        } else if (!strcmp(argv[arg_index], "--jitter") && has_value) {
+            args->mock_config.latency_jitter_ms = std::stoi(argv[++arg_index]);
+        } else if (!strcmp(argv[arg_index], "--error-rate") && has_value) {
+            args->mock_config.error_rate = std::stod(argv[++arg_index]);
+        } else if (!strcmp(argv[arg_index], "--app-limits") && has_value) {
+            args->mock_config.app_rate_limits = argv[++arg_index];
+        } else if (!strcmp(argv[arg_index], "--method-limits") && has_value) {
+            args->mock_config.method_rate_limits = argv[++arg_index];
+        } else if (!strcmp(argv[arg_index], "--pool") && has_value) {
+            args->mock_config.n_of_matches = std::stoul(argv[++arg_index]);
+        } else {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    riot_load_args_t args;
+    if (parse_args(argc, argv, &args)) {
+        std::cerr << "usage: <riot_load_bin> [--address <scheme>://<host name>:<port>] [--players <n>] [--matches <n per player>] [--timelines <n>] "
+                     "[--connections <n>] [--cache <path>] [--http-cache <directory>] [--latency <ms>] [--jitter <ms>] [--error-rate <0..1>] "
+                     "[--app-limits <limit:seconds,...>] [--method-limits <limit:seconds,...>] [--pool <n of distinct matches>]" << std::endl;
+        return 1;
+    }
+
+    riot_mock_t riot_mock;
+    http_server_t server;
+    std::string scheme = "http";
+    std::string host_name = "127.0.0.1";
+    size_t port = 0;
+    const bool is_in_process = args.address.empty();
+    if (is_in_process) {
+        if (riot_mock.init(args.mock_config) || server.init(http_server_config_t(), [&riot_mock](const http_server_request_t& request, http_response_t* response) {
+            riot_mock.handle(request, response);
+        })) {
+            return 1;
+        }
+        port = server.m_port;
+    } else {
+        const size_t scheme_end = args.address.find("://");
+        const size_t port_begin = args.address.rfind(':');
+        if (scheme_end == std::string::npos || port_begin <= scheme_end + 3) {
+            std::cerr << "CLIENT '" << args.address << "' is not <scheme>://<host name>:<port>" << std::endl;
+            return 1;
+        }
+        scheme = args.address.substr(0, scheme_end);
+        host_name = args.address.substr(scheme_end + 3, port_begin - scheme_end - 3);
+        port = strtoul(args.address.c_str() + port_begin + 1, 0, 10);
+    }
+
+    http_pool_t http_pool;
+    http_pool_config_t http_pool_config;
+    http_pool_config.max_idle_connections_per_host = args.n_of_connections;
+    http_pool_config.max_concurrent_requests = args.n_of_connections;
+    // riot_mock_server --https has a self signed certificate
+    http_pool_config.is_peer_verified = false;
+    if (http_pool.init(http_pool_config)) {
+        return 1;
+    }
+    std::filesystem::remove(args.cache_path);
+    riot_cache_t riot_cache;
+    if (riot_cache.open(args.cache_path, 64 * 1024 * 1024)) {
+        return 1;
+    }
+    riot_client_t riot;
+    riot.m_scheme = scheme;
+    riot.m_host_name_override = host_name;
+    riot.m_port = port;
+    riot.m_cache = &riot_cache;
+    std::filesystem::remove_all(args.http_cache_directory);
+    http_cache_t http_cache;
+    if (http_cache.init(&http_pool, args.http_cache_directory)) {
+        return 1;
+    }
+    riot.m_http_cache = &http_cache;
+    // the first response tells the real limits
+    riot.m_default_app_rate_limits = args.mock_config.app_rate_limits;
+    riot.init(&http_pool, "mock-key");
+    riot_mock_t* counted_mock = is_in_process ? &riot_mock : 0;
+
+    std::vector<std::string> puuids(args.n_of_players);
+    {
+        load_phase_t phase("accounts");
+        const load_counters_t before = take_counters(&riot, &riot_cache, counted_mock);
+        for (size_t player = 0; player < args.n_of_players; ++player) {
+            const auto call_start = phase.begin_call();
+            riot.get_puuid_async(
+                "load" + std::to_string(player), "EUW",
+                [&phase, &puuids, player, call_start](const std::string& resulting_puuid) {
+                    puuids[player] = resulting_puuid;
+                    phase.end_call(call_start, 0);
+                },
+                [&phase, call_start](const riot_error_t& error) {
+                    phase.end_call(call_start, &error);
+                }
+            );
+        }
+        phase.wait();
+        report(&phase, args.n_of_players, before, take_counters(&riot, &riot_cache, counted_mock));
+    }
+    puuids.erase(std::remove(puuids.begin(), puuids.end(), std::string()), puuids.end());
+    std::sort(puuids.begin(), puuids.end());
+    puuids.erase(std::unique(puuids.begin(), puuids.end()), puuids.end());
+
+    {
+        load_phase_t phase("challenges");
+        const load_counters_t before = take_counters(&riot, &riot_cache, counted_mock);
+        auto on_failure = [&phase](std::chrono::steady_clock::time_point call_start) {
+            return [&phase, call_start](const riot_error_t& error) {
+                phase.end_call(call_start, &error);
+            };
+        };
+        const auto config_call_start = phase.begin_call();
+        riot.get_challenges_info_async(
+            riot_api::REGION_EUW,
+            [&phase, config_call_start](const nlohmann::json&) {
+                phase.end_call(config_call_start, 0);
+            },
+            on_failure(config_call_start)
+        );
+        for (const std::string& puuid : puuids) {
+            const auto call_start = phase.begin_call();
+            riot.get_challenges_by_puuid_async(
+                riot_api::REGION_EUW, puuid,
+                [&phase, call_start](const nlohmann::json&) {
+                    phase.end_call(call_start, 0);
+                },
+                on_failure(call_start)
+            );
+        }
+        phase.wait();
+        report(&phase, puuids.size() + 1, before, take_counters(&riot, &riot_cache, counted_mock));
+    }
+
+    {
+        // past the config's ttl it is asked for again with the validators of the body fetched above, and answered with a 304
+        riot.m_method_name_to_cache_ttl.erase("challenges-v1.config");
+        load_phase_t phase("challenge config refresh");
+        const load_counters_t before = take_counters(&riot, &riot_cache, counted_mock);
+        const size_t n_of_kept_bodies_served = http_cache.m_n_of_hits;
+        const auto call_start = phase.begin_call();
+        riot.get_challenges_info_async(
+            riot_api::REGION_EUW,
+            [&phase, call_start](const nlohmann::json&) {
+                phase.end_call(call_start, 0);
+            },
+            [&phase, call_start](const riot_error_t& error) {
+                phase.end_call(call_start, &error);
+            }
+        );
+        phase.wait();
+        report(&phase, 1, before, take_counters(&riot, &riot_cache, counted_mock));
+        std::cout << "  " << http_cache.m_n_of_hits - n_of_kept_bodies_served << " answered from the kept body" << std::endl;
+    }
+
+    std::mutex stored_mutex;
+    std::unordered_set<std::string> stored_match_ids;
+    {
+        load_phase_t phase("ingest");
+        const load_counters_t before = take_counters(&riot, &riot_cache, counted_mock);
+        match_ingester_t ingester;
+        ingester.init(
+            &riot, match_ingester_config_t(),
+            [&stored_mutex, &stored_match_ids](const std::string& match_id) {
+                std::lock_guard<std::mutex> guard(stored_mutex);
+                return stored_match_ids.count(match_id) != 0;
+            },
+            [&stored_mutex, &stored_match_ids](const std::string& match_id, const nlohmann::json& match_info) {
+                if (!match_info.contains("info")) {
+                    return 1;
+                }
+                std::lock_guard<std::mutex> guard(stored_mutex);
+                stored_match_ids.insert(match_id);
+                return 0;
+            }
+        );
+        for (const std::string& puuid : puuids) {
+            ingester.ingest_async(riot_api::REGION_EUW, riot_api::GAME_TYPE_RANKED, puuid, args.n_of_matches_per_player);
+        }
+        ingester.wait();
+        // the ingester reports per match, not per call
+        phase.m_n_of_ok = ingester.m_stats.n_of_stored;
+        report(&phase, ingester.m_stats.n_of_stored, before, take_counters(&riot, &riot_cache, counted_mock));
+        std::cout << "  " << ingester.m_stats.n_of_pages << " pages, " << ingester.m_stats.n_of_skipped << " already stored, "
+                  << ingester.m_stats.n_of_fetched << " fetched, " << ingester.m_stats.n_of_failed << " failed" << std::endl;
+        ingester.destroy();
+    }
+    std::vector<std::string> match_ids(stored_match_ids.begin(), stored_match_ids.end());
+    std::sort(match_ids.begin(), match_ids.end());
+
+    {
+        load_phase_t phase("timelines");
+        const load_counters_t before = take_counters(&riot, &riot_cache, counted_mock);
+        const size_t n_of_timelines = std::min(args.n_of_timelines, match_ids.size());
+        std::atomic<size_t> n_of_kills{ 0 };
+        for (size_t match_index = 0; match_index < n_of_timelines; ++match_index) {
+            const auto call_start = phase.begin_call();
+            riot.get_match_timeline_decoded_async(
+                riot_api::REGION_EUW, match_ids[match_index],
+                [&phase, &n_of_kills, call_start](const match_timeline_t& resulting_match_timeline) {
+                    n_of_kills += resulting_match_timeline.kills.size();
+                    phase.end_call(call_start, 0);
+                },
+                [&phase, call_start](const riot_error_t& error) {
+                    phase.end_call(call_start, &error);
+                }
+            );
+        }
+        phase.wait();
+        report(&phase, n_of_timelines, before, take_counters(&riot, &riot_cache, counted_mock));
+        std::cout << "  " << n_of_kills << " kills decoded" << std::endl;
+    }
+
+    {
+        // every match was cached forever by the ingest phase, nothing should reach the server
+        load_phase_t phase("cached matches");
+        const load_counters_t before = take_counters(&riot, &riot_cache, counted_mock);
+        for (const std::string& match_id : match_ids) {
+            const auto call_start = phase.begin_call();
+            riot.get_match_info_async(
+                riot_api::REGION_EUW, match_id,
+                [&phase, call_start](const nlohmann::json&) {
+                    phase.end_call(call_start, 0);
+                },
+                [&phase, call_start](const riot_error_t& error) {
+                    phase.end_call(call_start, &error);
+                }
+            );
+        }
+        phase.wait();
+        report(&phase, match_ids.size(), before, take_counters(&riot, &riot_cache, counted_mock));
+    }
+
+    riot.destroy();
+    http_pool.destroy();
+    riot_cache.close();
+    if (is_in_process) {
+        std::cout << "server " << riot_mock.m_stats.n_of_requests << " requests over " << server.m_stats.n_of_connections << " connections, "
+                  << riot_mock.m_stats.n_of_rate_limited << " rate limited, " << riot_mock.m_stats.n_of_injected_errors << " injected errors" << std::endl;
+        server.destroy();
+    }
+
+    return 0;
+}
@@ -0,0 +1,426 @@
+#include "riot_mock.h"
+#include "json.hpp"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <functional>
+#include <cctype>
+#include <cstdio>
+
+static const char* const champion_names[] = {
+    "Ahri", "Zed", "Lux", "Jinx", "Thresh", "LeeSin", "Yasuo", "Ezreal", "Leona", "Darius",
+    "Garen", "Annie", "Ashe", "Vayne", "Orianna", "Sett", "Kaisa", "Viego", "Nami", "Ornn"
+};
+static const char* const team_positions[] = { "TOP", "JUNGLE", "MIDDLE", "BOTTOM", "UTILITY" };
+static const char* const ward_types[] = { "YELLOW_TRINKET", "CONTROL_WARD", "SIGHT_WARD", "BLUE_TRINKET" };
+
+#define RIOT_MOCK_FIRST_MATCH_ID 6000000000ull
+#define RIOT_MOCK_N_OF_PUUIDS 5000
+
+static int64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// stateless generator, the nth draw of a seed is the same wherever it is made
+static uint64_t splitmix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+static double to_unit(uint64_t x) {
+    return static_cast<double>(x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static std::string url_decode(const std::string& str) {
+    std::string result;
+    result.reserve(str.size());
+    for (size_t i = 0; i < str.size(); ++i) {
+        if (str[i] == '%' && i + 2 < str.size() && isxdigit(static_cast<unsigned char>(str[i + 1])) && isxdigit(static_cast<unsigned char>(str[i + 2]))) {
+            result.push_back(static_cast<char>(std::stoi(str.substr(i + 1, 2), 0, 16)));
+            i += 2;
+        } else {
+            result.push_back(str[i]);
+        }
+    }
+    return result;
+}
+
+static int read_file(const std::string& path, std::string* result) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return 1;
+    }
+    std::stringstream stream;
+    stream << file.rdbuf();
+    *result = stream.str();
+    return 0;
+}
+
+// "20:1,100:120" into windows, malformed entries are skipped
+static std::vector<riot_mock_t::window_t> parse_rate_limits(const std::string& rate_limits) {
+    std::vector<riot_mock_t::window_t> result;
+    std::stringstream stream(rate_limits);
+    std::string entry;
+    while (std::getline(stream, entry, ',')) {
+        const size_t colon = entry.find(':');
+        if (colon == std::string::npos) {
+            continue ;
+        }
+        const uint32_t limit = static_cast<uint32_t>(strtoul(entry.c_str(), 0, 10));
+        const int64_t seconds = strtoll(entry.c_str() + colon + 1, 0, 10);
+        if (limit && 0 < seconds) {
+            result.push_back({ .duration_ms = seconds * 1000, .limit = limit, .count = 0, .start_ms = 0 });
+        }
+    }
+    return result;
+}
+
+static std::string windows_to_str(const std::vector<riot_mock_t::window_t>& windows, bool is_count) {
+    std::string result;
+    for (const riot_mock_t::window_t& window : windows) {
+        if (!result.empty()) {
+            result += ",";
+        }
+        result += std::to_string(is_count ? window.count : window.limit) + ":" + std::to_string(window.duration_ms / 1000);
+    }
+    return result;
+}
+
+static std::string mock_puuid(uint64_t index) {
+    return "mock-puuid-" + std::to_string(index % RIOT_MOCK_N_OF_PUUIDS);
+}
+
+// the same in a match and its timeline
+static std::string participant_puuid(uint64_t seed, uint64_t match_number, int participant) {
+    return mock_puuid(splitmix64(splitmix64(seed ^ match_number) + participant));
+}
+
+static uint64_t match_number(const std::string& match_id) {
+    const size_t underscore = match_id.find('_');
+    return underscore == std::string::npos ? 0 : strtoull(match_id.c_str() + underscore + 1, 0, 10);
+}
+
+int riot_mock_t::init(const riot_mock_config_t& config) {
+    m_config = config;
+
+    if (read_file(m_config.global_challenges_path, &m_global_challenges) || read_file(m_config.account_challenges_path, &m_account_challenges)) {
+        std::cerr << "CLIENT failed to read '" << m_config.global_challenges_path << "' or '" << m_config.account_challenges_path << "'" << std::endl;
+        return 1;
+    }
+    uint64_t global_challenges_hash = 14695981039346656037ull;
+    for (unsigned char c : m_global_challenges) {
+        global_challenges_hash ^= c;
+        global_challenges_hash *= 1099511628211ull;
+    }
+    char global_challenges_etag[32];
+    snprintf(global_challenges_etag, sizeof(global_challenges_etag), "\"%016llx\"", static_cast<unsigned long long>(global_challenges_hash));
+    m_global_challenges_etag = global_challenges_etag;
+    m_app_windows = parse_rate_limits(m_config.app_rate_limits);
+    m_app_rate_limits_header = windows_to_str(m_app_windows, false);
+    m_method_rate_limits_header = windows_to_str(parse_rate_limits(m_config.method_rate_limits), false);
+    m_method_name_to_windows.clear();
+    m_n_of_draws = 0;
+
+    return 0;
+}
+
+int64_t riot_mock_t::acquire(std::vector<window_t>* windows, int64_t now_ms) {
+    int64_t wait_ms = 0;
+    for (window_t& window : *windows) {
+        if (window.count && window.start_ms + window.duration_ms <= now_ms) {
+            window.count = 0;
+        }
+        if (window.limit <= window.count) {
+            wait_ms = std::max(wait_ms, window.start_ms + window.duration_ms - now_ms);
+        }
+    }
+    if (wait_ms) {
+        return (wait_ms + 999) / 1000;
+    }
+
+    for (window_t& window : *windows) {
+        if (window.count == 0) {
+            window.start_ms = now_ms;
+        }
+        ++window.count;
+    }
+    return 0;
+}
+
+std::string riot_mock_t::route(const std::string& path_name, std::vector<std::string>* path_parts) {
+    path_parts->clear();
+    const std::string path = path_name.substr(0, path_name.find('?'));
+    std::stringstream stream(path);
+    std::string part;
+    while (std::getline(stream, part, '/')) {
+        path_parts->push_back(url_decode(part));
+    }
+
+    const std::vector<std::string>& parts = *path_parts;
+    const size_t n = parts.size();
+    auto starts_with = [&parts, n](std::initializer_list<const char*> prefix) {
+        if (n < prefix.size()) {
+            return false;
+        }
+        size_t index = 0;
+        for (const char* prefix_part : prefix) {
+            if (parts[index++] != prefix_part) {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (n == 7 && starts_with({ "riot", "account", "v1", "accounts", "by-riot-id" })) {
+        return "account-v1.by-riot-id";
+    }
+    if (n == 7 && starts_with({ "lol", "match", "v5", "matches", "by-puuid" }) && parts[6] == "ids") {
+        return "match-v5.ids-by-puuid";
+    }
+    if (n == 6 && starts_with({ "lol", "match", "v5", "matches" }) && parts[5] == "timeline") {
+        return "match-v5.timeline";
+    }
+    if (n == 5 && starts_with({ "lol", "match", "v5", "matches" })) {
+        return "match-v5.match";
+    }
+    if (n == 5 && starts_with({ "lol", "challenges", "v1", "challenges", "config" })) {
+        return "challenges-v1.config";
+    }
+    if (n == 5 && starts_with({ "lol", "challenges", "v1", "player-data" })) {
+        return "challenges-v1.player-data";
+    }
+
+    return "";
+}
+
+std::string riot_mock_t::make_account(const std::vector<std::string>& path_parts) {
+    const std::string& game_name = path_parts[5];
+    const std::string& tag_line = path_parts[6];
+    nlohmann::json result = {
+        { "puuid", mock_puuid(std::hash<std::string>()(game_name + "#" + tag_line)) },
+        { "gameName", game_name },
+        { "tagLine", tag_line }
+    };
+    return result.dump();
+}
+
+std::string riot_mock_t::make_match_ids(const std::string& puuid, const std::string& query) {
+    size_t start = 0;
+    size_t count = 20;
+    std::stringstream stream(query);
+    std::string parameter;
+    while (std::getline(stream, parameter, '&')) {
+        if (parameter.rfind("start=", 0) == 0) {
+            start = strtoull(parameter.c_str() + 6, 0, 10);
+        } else if (parameter.rfind("count=", 0) == 0) {
+            count = std::min<size_t>(100, strtoull(parameter.c_str() + 6, 0, 10));
+        }
+    }
+
+    // a contiguous run of the match pool, most recent first, so players whose runs overlap share matches
+    const uint64_t first = splitmix64(m_config.seed ^ std::hash<std::string>()(puuid)) % std::max<size_t>(1, m_config.n_of_matches);
+    nlohmann::json result = nlohmann::json::array();
+    for (size_t index = start; index < std::min(start + count, m_config.n_of_matches_per_puuid); ++index) {
+        result.push_back("EUW1_" + std::to_string(RIOT_MOCK_FIRST_MATCH_ID + (first + m_config.n_of_matches_per_puuid - index) % std::max<size_t>(1, m_config.n_of_matches)));
+    }
+    return result.dump();
+}
+
+std::string riot_mock_t::make_match(const std::string& match_id) {
+    const uint64_t number = match_number(match_id);
+    uint64_t draw = splitmix64(m_config.seed ^ number);
+    auto next = [&draw]() {
+        draw = splitmix64(draw);
+        return draw;
+    };
+
+    nlohmann::json result;
+    result["metadata"]["matchId"] = match_id;
+    nlohmann::json& info = result["info"];
+    info["gameCreation"] = 1700000000000ll + static_cast<int64_t>(number - RIOT_MOCK_FIRST_MATCH_ID) * 600000;
+    info["gameDuration"] = 1200 + next() % 1200;
+    info["gameEndTimestamp"] = info["gameCreation"].get<int64_t>() + info["gameDuration"].get<int64_t>() * 1000;
+    info["queueId"] = next() % 4 ? 420 : 440;
+    const bool is_blue_win = next() % 2;
+    for (int participant = 0; participant < 10; ++participant) {
+        const std::string puuid = participant_puuid(m_config.seed, number, participant);
+        result["metadata"]["participants"].push_back(puuid);
+        nlohmann::json participant_info;
+        participant_info["puuid"] = puuid;
+        participant_info["participantId"] = participant + 1;
+        participant_info["championName"] = champion_names[next() % (sizeof(champion_names) / sizeof(champion_names[0]))];
+        participant_info["championId"] = 1 + next() % 900;
+        participant_info["teamPosition"] = team_positions[participant % 5];
+        participant_info["teamId"] = participant < 5 ? 100 : 200;
+        participant_info["win"] = (participant < 5) == is_blue_win;
+        participant_info["kills"] = next() % 20;
+        participant_info["deaths"] = next() % 20;
+        participant_info["assists"] = next() % 30;
+        participant_info["totalDamageDealtToChampions"] = next() % 60000;
+        participant_info["goldEarned"] = 5000 + next() % 15000;
+        participant_info["totalMinionsKilled"] = next() % 300;
+        participant_info["visionScore"] = next() % 100;
+        participant_info["wardsPlaced"] = next() % 40;
+        participant_info["challenges"]["kda"] = to_unit(next()) * 10.0;
+        participant_info["challenges"]["killParticipation"] = to_unit(next());
+        participant_info["challenges"]["damagePerMinute"] = to_unit(next()) * 1500.0;
+        info["participants"].push_back(std::move(participant_info));
+    }
+    return result.dump();
+}
+
+std::string riot_mock_t::make_timeline(const std::string& match_id) {
+    const uint64_t number = match_number(match_id);
+    uint64_t draw = splitmix64(m_config.seed ^ number);
+    auto next = [&draw]() {
+        draw = splitmix64(draw);
+        return draw;
+    };
+
+    nlohmann::json result;
+    result["metadata"]["matchId"] = match_id;
+    for (int participant = 0; participant < 10; ++participant) {
+        result["metadata"]["participants"].push_back(participant_puuid(m_config.seed, number, participant));
+    }
+
+    nlohmann::json& frames = result["info"]["frames"];
+    const int n_of_frames = 20 + static_cast<int>(next() % 20);
+    for (int frame = 0; frame < n_of_frames; ++frame) {
+        nlohmann::json frame_info;
+        frame_info["timestamp"] = frame * 60000;
+        for (int participant = 1; participant <= 10; ++participant) {
+            nlohmann::json& participant_frame = frame_info["participantFrames"][std::to_string(participant)];
+            participant_frame["participantId"] = participant;
+            participant_frame["totalGold"] = 500 + frame * 350 + next() % 200;
+            participant_frame["xp"] = frame * 500 + next() % 300;
+            participant_frame["position"] = { { "x", next() % 15000 }, { "y", next() % 15000 } };
+        }
+        frame_info["events"] = nlohmann::json::array();
+        const int n_of_events = frame ? 4 + static_cast<int>(next() % 12) : 0;
+        for (int event = 0; event < n_of_events; ++event) {
+            nlohmann::json event_info;
+            event_info["timestamp"] = (frame - 1) * 60000 + static_cast<int64_t>(next() % 60000);
+            const int participant = 1 + static_cast<int>(next() % 10);
+            switch (next() % 3) {
+            case 0: {
+                event_info["type"] = "CHAMPION_KILL";
+                event_info["killerId"] = participant;
+                event_info["victimId"] = participant <= 5 ? 6 + static_cast<int>(next() % 5) : 1 + static_cast<int>(next() % 5);
+                event_info["position"] = { { "x", next() % 15000 }, { "y", next() % 15000 } };
+                event_info["assistingParticipantIds"] = { participant <= 5 ? 1 + static_cast<int>(next() % 5) : 6 + static_cast<int>(next() % 5) };
+            } break ;
+            case 1: {
+                event_info["type"] = "WARD_PLACED";
+                event_info["creatorId"] = participant;
+                event_info["wardType"] = ward_types[next() % (sizeof(ward_types) / sizeof(ward_types[0]))];
+            } break ;
+            default: {
+                event_info["type"] = "ITEM_PURCHASED";
+                event_info["participantId"] = participant;
+                event_info["itemId"] = 1001 + next() % 6000;
+            } break ;
+            }
+            frame_info["events"].push_back(std::move(event_info));
+        }
+        frames.push_back(std::move(frame_info));
+    }
+    result["info"]["frameInterval"] = 60000;
+    return result.dump();
+}
+
+void riot_mock_t::handle(const http_server_request_t& request, http_response_t* response) {
+    ++m_stats.n_of_requests;
+
+    std::vector<std::string> path_parts;
+    const std::string method_name = route(request.path_name, &path_parts);
+    int latency_ms;
+    int64_t retry_after_s = 0;
+    bool is_app_limited = false;
+    bool is_injected_error = false;
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+
+        latency_ms = m_config.latency_ms + (m_config.latency_jitter_ms ? static_cast<int>(splitmix64(m_config.seed + m_n_of_draws++) % (m_config.latency_jitter_ms + 1)) : 0);
+        if (!method_name.empty() && request.find_header("x-riot-token")) {
+            const int64_t now = now_ms();
+            std::vector<window_t>& method_windows = m_method_name_to_windows.try_emplace(method_name, parse_rate_limits(m_config.method_rate_limits)).first->second;
+            // like Riot, a request refused by one scope is not counted by the other
+            retry_after_s = acquire(&m_app_windows, now);
+            is_app_limited = retry_after_s != 0;
+            if (!is_app_limited) {
+                retry_after_s = acquire(&method_windows, now);
+                if (retry_after_s) {
+                    for (window_t& window : m_app_windows) {
+                        --window.count;
+                    }
+                }
+            }
+            is_injected_error = !retry_after_s && m_config.error_rate != 0.0 && to_unit(splitmix64(m_config.seed + m_n_of_draws++)) < m_config.error_rate;
+
+            response->headers.push_back({ .name = "X-App-Rate-Limit", .value = m_app_rate_limits_header });
+            response->headers.push_back({ .name = "X-App-Rate-Limit-Count", .value = windows_to_str(m_app_windows, true) });
+            response->headers.push_back({ .name = "X-Method-Rate-Limit", .value = m_method_rate_limits_header });
+            response->headers.push_back({ .name = "X-Method-Rate-Limit-Count", .value = windows_to_str(method_windows, true) });
+        }
+    }
+    if (latency_ms) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(latency_ms));
+    }
+
+    response->headers.push_back({ .name = "Content-Type", .value = "application/json;charset=utf-8" });
+    if (method_name.empty()) {
+        ++m_stats.n_of_not_found;
+        response->status = 404;
+        response->body = "{\"status\":{\"message\":\"Data not found\",\"status_code\":404}}";
+        return ;
+    }
+    if (!request.find_header("x-riot-token")) {
+        ++m_stats.n_of_unauthorized;
+        response->status = 401;
+        response->body = "{\"status\":{\"message\":\"Unauthorized\",\"status_code\":401}}";
+        return ;
+    }
+    if (retry_after_s) {
+        ++m_stats.n_of_rate_limited;
+        response->status = 429;
+        response->headers.push_back({ .name = "Retry-After", .value = std::to_string(retry_after_s) });
+        response->headers.push_back({ .name = "X-Rate-Limit-Type", .value = is_app_limited ? "application" : "method" });
+        response->body = "{\"status\":{\"message\":\"Rate limit exceeded\",\"status_code\":429}}";
+        return ;
+    }
+    if (is_injected_error) {
+        ++m_stats.n_of_injected_errors;
+        response->status = m_stats.n_of_injected_errors % 2 ? 503 : 500;
+        response->body = "{\"status\":{\"message\":\"Injected error\",\"status_code\":" + std::to_string(response->status) + "}}";
+        return ;
+    }
+
+    ++m_stats.n_of_ok;
+    response->status = 200;
+    if (method_name == "account-v1.by-riot-id") {
+        response->body = make_account(path_parts);
+    } else if (method_name == "match-v5.ids-by-puuid") {
+        const size_t query_begin = request.path_name.find('?');
+        response->body = make_match_ids(path_parts[5], query_begin == std::string::npos ? "" : request.path_name.substr(query_begin + 1));
+    } else if (method_name == "match-v5.match") {
+        response->body = make_match(path_parts[4]);
+    } else if (method_name == "match-v5.timeline") {
+        response->body = make_timeline(path_parts[4]);
+    } else if (method_name == "challenges-v1.config") {
+        response->headers.push_back({ .name = "ETag", .value = m_global_challenges_etag });
+        const std::string* if_none_match = request.find_header("if-none-match");
+        if (if_none_match && *if_none_match == m_global_challenges_etag) {
+            ++m_stats.n_of_not_modified;
+            response->status = 304;
+        } else {
+            response->body = m_global_challenges;
+        }
+    } else {
+        response->body = m_account_challenges;
+    }
+}
@@ -0,0 +1,98 @@
+#ifndef RIOT_MOCK_H
+# define RIOT_MOCK_H
+
+# include <string>
+# include <vector>
+# include <unordered_map>
+# include <mutex>
+# include <atomic>
+# include <cstdint>
+
+# include "http_server.h"
+
+struct riot_mock_config_t {
+    // served as they are for challenges-v1 config and player-data
+    std::string global_challenges_path = "build/global_challenges.json";
+    std::string account_challenges_path = "build/account_challenges.json";
+    // added before every response, uniform in [latency_ms, latency_ms + latency_jitter_ms]
+    int         latency_ms = 0;
+    int         latency_jitter_ms = 0;
+    // fraction of the requests within the limits answered with a 500 or 503 instead
+    double      error_rate = 0.0;
+    // "limit:seconds" windows as in the X-App-Rate-Limit header, enforced over every request, empty for no limit
+    std::string app_rate_limits = "20:1,100:120";
+    // enforced per method, e.g. every match-v5.match request shares one set of windows
+    std::string method_rate_limits = "2000:10";
+    // match ids handed out by ids-by-puuid are drawn from this many matches, players share matches once it is small
+    size_t      n_of_matches = 100000;
+    // matches every puuid has played, the end of its match history
+    size_t      n_of_matches_per_puuid = 1000;
+    // same seed, same responses
+    uint64_t    seed = 42;
+};
+
+struct riot_mock_stats_t {
+    std::atomic<size_t> n_of_requests{ 0 };
+    std::atomic<size_t> n_of_ok{ 0 };
+    std::atomic<size_t> n_of_rate_limited{ 0 };
+    std::atomic<size_t> n_of_injected_errors{ 0 };
+    std::atomic<size_t> n_of_not_found{ 0 };
+    std::atomic<size_t> n_of_unauthorized{ 0 };
+    // revalidations answered with a 304, counted in n_of_ok as well
+    std::atomic<size_t> n_of_not_modified{ 0 };
+};
+
+/**
+ * Stand-in for the Riot API endpoints riot_client_t calls, meant as the handler of an http_server_t.
+ * Challenge responses are the checked-in ones, accounts, match ids, matches and timelines are generated from the seed and the ids asked for,
+ * so the same requests get the same bodies across runs. Rate limits are counted like Riot counts them,
+ * with the X-App-Rate-Limit(-Count) and X-Method-Rate-Limit(-Count) headers on every answer and a 429 with Retry-After past them.
+ * The challenge config carries an ETag and is answered with a 304 when If-None-Match names it.
+ *
+ * Example call:
+ * riot_mock_t riot_mock;
+ * riot_mock.init(riot_mock_config_t());
+ * http_server_t server;
+ * server.init(http_server_config_t(), [&riot_mock](const http_server_request_t& request, http_response_t* response) {
+ *   riot_mock.handle(request, response);
+ * });
+ * riot.m_scheme = "http";
+ * riot.m_host_name_override = "127.0.0.1";
+ * riot.m_port = server.m_port;
+*/
+struct riot_mock_t {
+    int  init(const riot_mock_config_t& config);
+    // thread safe, sleeps for the configured latency
+    void handle(const http_server_request_t& request, http_response_t* response);
+
+    struct window_t {
+        int64_t  duration_ms;
+        uint32_t limit;
+        uint32_t count;
+        int64_t  start_ms;
+    };
+
+    // m_mutex must be held, returns 0 and counts the request if every window has room, otherwise the seconds until the fullest one resets
+    int64_t     acquire(std::vector<window_t>* windows, int64_t now_ms);
+    // the method name riot_client_t uses for the path, empty if the mock does not serve it
+    std::string route(const std::string& path_name, std::vector<std::string>* path_parts);
+    std::string make_account(const std::vector<std::string>& path_parts);
+    std::string make_match_ids(const std::string& puuid, const std::string& query);
+    std::string make_match(const std::string& match_id);
+    std::string make_timeline(const std::string& match_id);
+
+    riot_mock_config_t                                     m_config;
+    riot_mock_stats_t                                      m_stats;
+    std::string                                            m_global_challenges;
+    std::string                                            m_global_challenges_etag;
+    std::string                                            m_account_challenges;
+    std::string                                            m_app_rate_limits_header;
+    std::string                                            m_method_rate_limits_header;
+
+    std::mutex                                             m_mutex;
+    std::vector<window_t>                                  m_app_windows;
+    std::unordered_map<std::string, std::vector<window_t>> m_method_name_to_windows;
+    uint64_t                                               m_n_of_draws = 0;
+};
+
+#endif // RIOT_MOCK_H
@@ -0,0 +1,89 @@
+#include "riot_mock.h"
+#include "http_server.h"
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <csignal>
+
+/**
+ * Serves riot_mock_t until interrupted, printing what it answered every few seconds.
+ * Point the tracker at it with --riot-address, any api key is accepted.
+ *
+ * Example call:
+ * ./riot_mock_server --port 8443 --latency 40 --jitter 30 --error-rate 0.02 --app-limits 20:1,100:120
+ * ./tracker mock-key --riot-address http://127.0.0.1:8443
+*/
+
+static volatile sig_atomic_t should_stop = 0;
+
+static void on_interrupt(int) {
+    should_stop = 1;
+}
+
+int main(int argc, char** argv) {
+    riot_mock_config_t mock_config;
+    http_server_config_t server_config;
+    server_config.port = 8443;
+    bool are_args_valid = true;
+    for (int arg_index = 1; arg_index < argc && are_args_valid; ++arg_index) {
+        const bool has_value = arg_index + 1 < argc;
+        if (!strcmp(argv[arg_index], "--port") && has_value) {
+            server_config.port = std::stoul(argv[++arg_index]);
+        } else if (!strcmp(argv[arg_index], "--https")) {
+            server_config.is_tls = true;
+        } else if (!strcmp(argv[arg_index], "--latency") && has_value) {
+            mock_config.latency_ms = std::stoi(argv[++arg_index]);
+        } else if (!strcmp(argv[arg_index], "--jitter") && has_value) {
+            mock_config.latency_jitter_ms = std::stoi(argv[++arg_index]);
+        } else if (!strcmp(argv[arg_index], "--error-rate") && has_value) {
+            mock_config.error_rate = std::stod(argv[++arg_index]);
+        } else if (!strcmp(argv[arg_index], "--app-limits") && has_value) {
+            mock_config.app_rate_limits = argv[++arg_index];
+        } else if (!strcmp(argv[arg_index], "--method-limits") && has_value) {
+            mock_config.method_rate_limits = argv[++arg_index];
+        } else if (!strcmp(argv[arg_index], "--matches") && has_value) {
+            mock_config.n_of_matches = std::stoul(argv[++arg_index]);
+        } else if (!strcmp(argv[arg_index], "--seed") && has_value) {
+            mock_config.seed = std::stoull(argv[++arg_index]);
+        } else {
+            are_args_valid = false;
+        }
+    }
+    if (!are_args_valid) {
+        std::cerr << "usage: <riot_mock_server_bin> [--port <port>] [--https] [--latency <ms>] [--jitter <ms>] [--error-rate <0..1>] "
+                     "[--app-limits <limit:seconds,...>] [--method-limits <limit:seconds,...>] [--matches <n>] [--seed <n>]" << std::endl;
+        return 1;
+    }
+
+    riot_mock_t riot_mock;
+    if (riot_mock.init(mock_config)) {
+        return 1;
+    }
+    http_server_t server;
+    if (server.init(server_config, [&riot_mock](const http_server_request_t& request, http_response_t* response) {
+        riot_mock.handle(request, response);
+    })) {
+        return 1;
+    }
+    std::cout << "serving on " << (server_config.is_tls ? "https" : "http") << "://" << server_config.host_name << ":" << server.m_port << std::endl;
+
+    signal(SIGINT, &on_interrupt);
+    signal(SIGTERM, &on_interrupt);
+    size_t n_of_reported_requests = 0;
+    auto report_time = std::chrono::steady_clock::now();
+    while (!should_stop) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (std::chrono::steady_clock::now() - report_time < std::chrono::seconds(5) || riot_mock.m_stats.n_of_requests == n_of_reported_requests) {
+            continue ;
+        }
+        report_time = std::chrono::steady_clock::now();
+        n_of_reported_requests = riot_mock.m_stats.n_of_requests;
+        std::cout << n_of_reported_requests << " requests: " << riot_mock.m_stats.n_of_ok << " ok, " << riot_mock.m_stats.n_of_rate_limited << " rate limited, "
+                  << riot_mock.m_stats.n_of_injected_errors << " injected errors, " << riot_mock.m_stats.n_of_not_found << " not found over "
+                  << server.m_stats.n_of_connections << " connections" << std::endl;
+    }
+
+    return 0;
+}
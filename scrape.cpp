@@ -1,19 +1,24 @@
-#include "gil_asset_manager/gil_web/web.cpp"
+#include "http.cpp"
+#include "executor.cpp"
+#include "http_cache.cpp"
+#include "mapped_file.cpp"
 
 #include <iostream>
-#include <chrono>
-#include <thread>
 #include <regex>
 #include <fstream>
+#include <cassert>
 
-void get_async(
-    const std::string& scheme, const std::string& host_name, size_t port, const std::string& path_name,
-    const std::function<void(const unsigned char* serialized_data, size_t serialized_data_size)>& on_success,
-    const std::function<void()>& on_failure
-);
+static http_pool_t  pool;
+static http_cache_t cache;
+static task_group_t group;
 
 int main() {
-    get_async(
+    pool.init();
+    // champion jsons only change on patch days, unchanged ones are revalidated instead of downloaded
+    if (cache.init(&pool, "http_cache")) {
+        return 1;
+    }
+    cache.get_async(
         "https", "raw.communitydragon.org", 443, "latest/plugins/rcp-be-lol-game-data/global/default/v1/champions/",
         [](const unsigned char* serialized_data, size_t serialized_data_size) {
             std::string result(serialized_data, serialized_data + serialized_data_size);
@@ -29,16 +34,17 @@ int main() {
                     std::string::size_type p = match_str.find_first_of('"');
                     assert(p != std::string::npos);
                     std::string json_file_name = match_str.substr(p + 1);
-                    get_async(
+                    cache.get_async(
                         "https", "raw.communitydragon.org", 443, "latest/plugins/rcp-be-lol-game-data/global/default/v1/champions/" + json_file_name,
-                        [&json_file_name](const unsigned char* serialized_data, size_t serialized_data_size) {
+                        [json_file_name](const unsigned char* serialized_data, size_t serialized_data_size) {
                             std::cout << "writing subresult to json_files/" << json_file_name << std::endl;
-                            std::ofstream of("json_files/" + json_file_name);
-                            of << std::string(serialized_data, serialized_data + serialized_data_size);
+                            std::ofstream of("json_files/" + json_file_name, std::ios::binary);
+                            of.write(reinterpret_cast<const char*>(serialized_data), serialized_data_size);
                         },
                         []() {
                             std::cout << "subresult not found" << std::endl;
-                        }
+                        },
+                        &group
                     );
                     std::cout << "Found match: " << match_str << std::endl;
                 }
@@ -48,10 +54,12 @@ int main() {
         },
         []() {
             std::cout << "failed" << std::endl;
-        }
+        },
+        &group
     );
 
-    std::this_thread::sleep_for(std::chrono::duration<double, std::ratio<1, 1>>(5));
+    group.wait();
+    pool.destroy();
 
     return 0;
 }
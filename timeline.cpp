@@ -0,0 +1,636 @@
+#include "timeline.h"
+
+#include "json.hpp"
+
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+#include <charconv>
+
+#define TIMELINE_MAX_PARTICIPANTS 16
+
+// Riot's event type names
+static const char* const event_kind_names[_TIMELINE_EVENT_SIZE] = {
+    "CHAMPION_KILL",
+    "WARD_PLACED",
+    "WARD_KILL",
+    "ITEM_PURCHASED",
+    "ITEM_SOLD",
+    "ITEM_DESTROYED",
+    "ITEM_UNDO",
+    "ELITE_MONSTER_KILL",
+    "BUILDING_KILL",
+    "TURRET_PLATE_DESTROYED"
+};
+
+const char* timeline_event_kind_to_str(timeline_event_kind_t kind) {
+    return kind < _TIMELINE_EVENT_SIZE ? event_kind_names[kind] : "UNKNOWN";
+}
+
+void match_timeline_t::clear() {
+    puuids.clear();
+    n_of_participants = 0;
+    frame_timestamps_ms.clear();
+    total_gold.clear();
+    xp.clear();
+    positions.clear();
+    kills.clear();
+    wards.clear();
+    items.clear();
+    objectives.clear();
+}
+
+size_t match_timeline_t::memory_size() const {
+    size_t result = sizeof(*this);
+    for (const std::string& puuid : puuids) {
+        result += sizeof(puuid) + puuid.capacity();
+    }
+    result += frame_timestamps_ms.capacity() * sizeof(int32_t);
+    result += total_gold.capacity() * sizeof(int32_t);
+    result += xp.capacity() * sizeof(int32_t);
+    result += positions.capacity() * sizeof(timeline_position_t);
+    result += (kills.capacity() + wards.capacity() + items.capacity() + objectives.capacity()) * sizeof(timeline_event_t);
+
+    return result;
+}
+
+const std::vector<timeline_event_t>& match_timeline_t::events(timeline_event_kind_t kind) const {
+    switch (kind) {
+    case TIMELINE_EVENT_CHAMPION_KILL: return kills;
+    case TIMELINE_EVENT_WARD_PLACED:
+    case TIMELINE_EVENT_WARD_KILL: return wards;
+    case TIMELINE_EVENT_ITEM_PURCHASED:
+    case TIMELINE_EVENT_ITEM_SOLD:
+    case TIMELINE_EVENT_ITEM_DESTROYED:
+    case TIMELINE_EVENT_ITEM_UNDO: return items;
+    default: return objectives;
+    }
+}
+
+int match_timeline_t::participant_id(const std::string& puuid) const {
+    for (size_t participant = 0; participant < puuids.size(); ++participant) {
+        if (puuids[participant] == puuid) {
+            return static_cast<int>(participant) + 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Only the path from the root to the current value is tracked, values outside of the fields we keep are dropped as they stream by.
+*/
+struct timeline_sax_t : nlohmann::json_sax<nlohmann::json> {
+    enum context_t : uint8_t {
+        CONTEXT_ROOT,
+        CONTEXT_METADATA,
+        CONTEXT_METADATA_PARTICIPANTS,
+        CONTEXT_INFO,
+        CONTEXT_FRAMES,
+        CONTEXT_FRAME,
+        CONTEXT_EVENTS,
+        CONTEXT_EVENT,
+        CONTEXT_EVENT_POSITION,
+        CONTEXT_EVENT_ASSISTS,
+        CONTEXT_PARTICIPANT_FRAMES,
+        CONTEXT_PARTICIPANT_FRAME,
+        CONTEXT_PARTICIPANT_POSITION,
+        CONTEXT_IGNORED
+    };
+
+    // fields of the event being decoded, turned into a timeline_event_t when its object ends
+    struct event_scratch_t {
+        int      kind; // timeline_event_kind_t, -1 for the events we skip
+        int64_t  timestamp_ms;
+        int      killer_id;
+        int      victim_id;
+        int      creator_id;
+        int      participant_id;
+        int      item_id;
+        int      team_id;        // owner of a building
+        int      killer_team_id;
+        uint16_t detail;
+        int      x;
+        int      y;
+        bool     has_position;
+        uint16_t assisting_participants;
+    };
+
+    explicit timeline_sax_t(match_timeline_t* result) : m_result(result) {
+        m_contexts.reserve(16);
+    }
+
+    context_t top() const {
+        return m_contexts.empty() ? CONTEXT_IGNORED : m_contexts.back();
+    }
+
+    bool is_key(const char* key) const {
+        return m_key == key;
+    }
+
+    // context of an object or array opened under the current context and key
+    context_t child_context() const {
+        if (m_contexts.empty()) {
+            return CONTEXT_ROOT;
+        }
+        switch (top()) {
+        case CONTEXT_ROOT: {
+            if (is_key("metadata")) return CONTEXT_METADATA;
+            if (is_key("info")) return CONTEXT_INFO;
+        } break ;
+        case CONTEXT_METADATA: {
+            if (is_key("participants")) return CONTEXT_METADATA_PARTICIPANTS;
+        } break ;
+        case CONTEXT_INFO: {
+            if (is_key("frames")) return CONTEXT_FRAMES;
+        } break ;
+        case CONTEXT_FRAMES: {
+            return CONTEXT_FRAME;
+        }
+        case CONTEXT_FRAME: {
+            if (is_key("events")) return CONTEXT_EVENTS;
+            if (is_key("participantFrames")) return CONTEXT_PARTICIPANT_FRAMES;
+        } break ;
+        case CONTEXT_EVENTS: {
+            return CONTEXT_EVENT;
+        }
+        case CONTEXT_EVENT: {
+            if (is_key("position")) return CONTEXT_EVENT_POSITION;
+            if (is_key("assistingParticipantIds")) return CONTEXT_EVENT_ASSISTS;
+        } break ;
+        case CONTEXT_PARTICIPANT_FRAMES: {
+            return CONTEXT_PARTICIPANT_FRAME;
+        }
+        case CONTEXT_PARTICIPANT_FRAME: {
+            if (is_key("position")) return CONTEXT_PARTICIPANT_POSITION;
+        } break ;
+        default: break ;
+        }
+
+        return CONTEXT_IGNORED;
+    }
+
+    bool start_object(std::size_t) override {
+        const context_t context = child_context();
+        if (context == CONTEXT_EVENT) {
+            memset(&m_event, 0, sizeof(m_event));
+            m_event.kind = -1;
+        } else if (context == CONTEXT_FRAME) {
+            m_frame_timestamp_ms = 0;
+            m_n_of_frame_participants = 0;
+        } else if (context == CONTEXT_PARTICIPANT_FRAME) {
+            m_participant = atoi(m_key.c_str());
+        }
+        m_contexts.push_back(context);
+        return true;
+    }
+
+    bool end_object() override {
+        const context_t context = top();
+        m_contexts.pop_back();
+        if (context == CONTEXT_EVENT) {
+            end_event();
+        } else if (context == CONTEXT_FRAME) {
+            end_frame();
+        }
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        m_contexts.push_back(child_context());
+        return true;
+    }
+
+    bool end_array() override {
+        m_contexts.pop_back();
+        return true;
+    }
+
+    bool key(string_t& value) override {
+        m_key.swap(value);
+        return true;
+    }
+
+    bool number(int64_t value) {
+        switch (top()) {
+        case CONTEXT_FRAME: {
+            if (is_key("timestamp")) m_frame_timestamp_ms = value;
+        } break ;
+        case CONTEXT_EVENT: {
+            if (is_key("timestamp")) m_event.timestamp_ms = value;
+            else if (is_key("killerId")) m_event.killer_id = static_cast<int>(value);
+            else if (is_key("victimId")) m_event.victim_id = static_cast<int>(value);
+            else if (is_key("creatorId")) m_event.creator_id = static_cast<int>(value);
+            else if (is_key("participantId")) m_event.participant_id = static_cast<int>(value);
+            else if (is_key("itemId") || is_key("beforeId")) m_event.item_id = static_cast<int>(value);
+            else if (is_key("teamId")) m_event.team_id = static_cast<int>(value);
+            else if (is_key("killerTeamId")) m_event.killer_team_id = static_cast<int>(value);
+        } break ;
+        case CONTEXT_EVENT_POSITION: {
+            if (is_key("x")) m_event.x = static_cast<int>(value);
+            else if (is_key("y")) m_event.y = static_cast<int>(value);
+            m_event.has_position = true;
+        } break ;
+        case CONTEXT_EVENT_ASSISTS: {
+            if (1 <= value && value <= TIMELINE_MAX_PARTICIPANTS) m_event.assisting_participants |= static_cast<uint16_t>(1u << (value - 1));
+        } break ;
+        case CONTEXT_PARTICIPANT_FRAME: {
+            if (m_participant < 1 || TIMELINE_MAX_PARTICIPANTS < m_participant) break ;
+            if (is_key("totalGold")) m_frame_gold[m_participant - 1] = static_cast<int32_t>(value);
+            else if (is_key("xp")) m_frame_xp[m_participant - 1] = static_cast<int32_t>(value);
+            m_n_of_frame_participants = std::max(m_n_of_frame_participants, m_participant);
+        } break ;
+        case CONTEXT_PARTICIPANT_POSITION: {
+            if (m_participant < 1 || TIMELINE_MAX_PARTICIPANTS < m_participant) break ;
+            if (is_key("x")) m_last_positions[m_participant - 1].x = static_cast<int16_t>(value);
+            else if (is_key("y")) m_last_positions[m_participant - 1].y = static_cast<int16_t>(value);
+        } break ;
+        default: break ;
+        }
+        return true;
+    }
+
+    bool number_integer(number_integer_t value) override {
+        return number(value);
+    }
+
+    bool number_unsigned(number_unsigned_t value) override {
+        return number(static_cast<int64_t>(value));
+    }
+
+    bool number_float(number_float_t value, const string_t&) override {
+        return number(static_cast<int64_t>(value));
+    }
+
+    bool string(string_t& value) override {
+        const context_t context = top();
+        if (context == CONTEXT_METADATA_PARTICIPANTS) {
+            m_result->puuids.push_back(std::move(value));
+        } else if (context == CONTEXT_EVENT) {
+            if (is_key("type")) {
+                m_event.kind = event_kind(value);
+            } else if (is_key("wardType")) {
+                m_event.detail = ward_detail(value);
+            } else if (is_key("monsterType") || is_key("buildingType")) {
+                m_event.detail = objective_detail(value);
+            }
+        }
+        return true;
+    }
+
+    bool null() override {
+        return true;
+    }
+
+    bool boolean(bool) override {
+        return true;
+    }
+
+    bool binary(binary_t&) override {
+        return true;
+    }
+
+    bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& e) override {
+        std::cerr << "CLIENT failed to decode timeline at byte " << position << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    static int event_kind(const std::string& type) {
+        for (int kind = 0; kind < _TIMELINE_EVENT_SIZE; ++kind) {
+            if (type == event_kind_names[kind]) {
+                return kind;
+            }
+        }
+        return -1;
+    }
+
+    static uint16_t ward_detail(const std::string& ward_type) {
+        if (ward_type == "YELLOW_TRINKET") return TIMELINE_WARD_YELLOW_TRINKET;
+        if (ward_type == "CONTROL_WARD") return TIMELINE_WARD_CONTROL_WARD;
+        if (ward_type == "SIGHT_WARD") return TIMELINE_WARD_SIGHT_WARD;
+        if (ward_type == "BLUE_TRINKET") return TIMELINE_WARD_BLUE_TRINKET;
+        if (ward_type == "TEEMO_MUSHROOM") return TIMELINE_WARD_TEEMO_MUSHROOM;
+        return TIMELINE_WARD_UNDEFINED;
+    }
+
+    static uint16_t objective_detail(const std::string& type) {
+        if (type == "DRAGON") return TIMELINE_OBJECTIVE_DRAGON;
+        if (type == "BARON_NASHOR") return TIMELINE_OBJECTIVE_BARON_NASHOR;
+        if (type == "RIFTHERALD") return TIMELINE_OBJECTIVE_RIFTHERALD;
+        if (type == "HORDE") return TIMELINE_OBJECTIVE_HORDE;
+        if (type == "ATAKHAN") return TIMELINE_OBJECTIVE_ATAKHAN;
+        if (type == "TOWER_BUILDING") return TIMELINE_OBJECTIVE_TOWER;
+        if (type == "INHIBITOR_BUILDING") return TIMELINE_OBJECTIVE_INHIBITOR;
+        return TIMELINE_OBJECTIVE_OTHER;
+    }
+
+    void end_event() {
+        if (m_event.kind < 0) {
+            return ;
+        }
+
+        timeline_event_t event;
+        memset(&event, 0, sizeof(event));
+        event.timestamp_ms = static_cast<int32_t>(m_event.timestamp_ms);
+        event.kind = static_cast<timeline_event_kind_t>(m_event.kind);
+        event.detail = m_event.detail;
+        event.assisting_participants = m_event.assisting_participants;
+        std::vector<timeline_event_t>* events = 0;
+        switch (event.kind) {
+        case TIMELINE_EVENT_CHAMPION_KILL: {
+            event.participant_id = static_cast<uint8_t>(m_event.killer_id);
+            event.victim_id = static_cast<uint8_t>(m_event.victim_id);
+            events = &m_result->kills;
+        } break ;
+        case TIMELINE_EVENT_WARD_PLACED: {
+            event.participant_id = static_cast<uint8_t>(m_event.creator_id);
+            events = &m_result->wards;
+        } break ;
+        case TIMELINE_EVENT_WARD_KILL: {
+            event.participant_id = static_cast<uint8_t>(m_event.killer_id);
+            events = &m_result->wards;
+        } break ;
+        case TIMELINE_EVENT_ITEM_PURCHASED:
+        case TIMELINE_EVENT_ITEM_SOLD:
+        case TIMELINE_EVENT_ITEM_DESTROYED:
+        case TIMELINE_EVENT_ITEM_UNDO: {
+            event.participant_id = static_cast<uint8_t>(m_event.participant_id);
+            event.detail = static_cast<uint16_t>(m_event.item_id);
+            events = &m_result->items;
+        } break ;
+        case TIMELINE_EVENT_ELITE_MONSTER_KILL:
+        case TIMELINE_EVENT_BUILDING_KILL:
+        case TIMELINE_EVENT_TURRET_PLATE_DESTROYED: {
+            event.participant_id = static_cast<uint8_t>(m_event.killer_id);
+            if (event.kind == TIMELINE_EVENT_TURRET_PLATE_DESTROYED) {
+                event.detail = TIMELINE_OBJECTIVE_TURRET_PLATE;
+            }
+            // building events name the team that lost the building
+            int team_id = m_event.killer_team_id;
+            if (!team_id && m_event.team_id) {
+                team_id = m_event.team_id == 100 ? 200 : 100;
+            }
+            event.team_id = team_id == 100 ? 1 : team_id == 200 ? 2 : 0;
+            events = &m_result->objectives;
+        } break ;
+        default: return ;
+        }
+
+        if (m_event.has_position) {
+            event.position = { static_cast<int16_t>(m_event.x), static_cast<int16_t>(m_event.y) };
+        } else if (1 <= event.participant_id && event.participant_id <= TIMELINE_MAX_PARTICIPANTS) {
+            event.position = m_last_positions[event.participant_id - 1];
+        }
+        events->push_back(event);
+    }
+
+    void end_frame() {
+        if (m_result->n_of_participants == 0) {
+            m_result->n_of_participants = m_result->puuids.empty() ? m_n_of_frame_participants : std::min<size_t>(m_result->puuids.size(), TIMELINE_MAX_PARTICIPANTS);
+        }
+        m_result->frame_timestamps_ms.push_back(static_cast<int32_t>(m_frame_timestamp_ms));
+        for (size_t participant = 0; participant < m_result->n_of_participants; ++participant) {
+            m_result->total_gold.push_back(m_frame_gold[participant]);
+            m_result->xp.push_back(m_frame_xp[participant]);
+            m_result->positions.push_back(m_last_positions[participant]);
+        }
+    }
+
+    match_timeline_t*      m_result;
+    std::vector<context_t> m_contexts;
+    std::string            m_key;
+    event_scratch_t        m_event;
+    int64_t                m_frame_timestamp_ms = 0;
+    int                    m_participant = 0;
+    int                    m_n_of_frame_participants = 0;
+    int32_t                m_frame_gold[TIMELINE_MAX_PARTICIPANTS] = { 0 };
+    int32_t                m_frame_xp[TIMELINE_MAX_PARTICIPANTS] = { 0 };
+    // positions of the latest participant frame, also used for the events that carry none
+    timeline_position_t    m_last_positions[TIMELINE_MAX_PARTICIPANTS] = {};
+};
+
+int match_timeline_decode(const char* data, size_t size, match_timeline_t* result) {
+    result->clear();
+    // a frame is roughly a dozen items and a handful of wards and kills, reserving avoids most regrowth
+    result->items.reserve(256);
+    result->wards.reserve(128);
+
+    timeline_sax_t sax(result);
+    if (!nlohmann::json::sax_parse(data, data + size, &sax)) {
+        result->clear();
+        return 1;
+    }
+    result->kills.shrink_to_fit();
+    result->wards.shrink_to_fit();
+    result->items.shrink_to_fit();
+    result->objectives.shrink_to_fit();
+
+    return 0;
+}
+
+match_timeline_decoder_t::match_timeline_decoder_t(match_timeline_t* result) : m_result(result) {
+    reset();
+}
+
+match_timeline_decoder_t::~match_timeline_decoder_t() = default;
+
+void match_timeline_decoder_t::reset() {
+    m_result->clear();
+    m_result->items.reserve(256);
+    m_result->wards.reserve(128);
+    m_sax = std::make_unique<timeline_sax_t>(m_result);
+    m_is_object.clear();
+    m_expected = EXPECTED_VALUE;
+    m_is_container_empty = false;
+    m_token = TOKEN_NONE;
+    m_token_text.clear();
+    m_is_escaped = false;
+    m_has_escapes = false;
+    m_is_done = false;
+    m_is_failed = false;
+}
+
+int match_timeline_decoder_t::fail() {
+    m_is_failed = true;
+    return 1;
+}
+
+int match_timeline_decoder_t::begin_value() {
+    if (m_expected != EXPECTED_VALUE || m_is_done) {
+        return 1;
+    }
+    m_is_container_empty = false;
+    return 0;
+}
+
+int match_timeline_decoder_t::end_value() {
+    m_expected = EXPECTED_SEPARATOR;
+    m_is_done = m_is_object.empty();
+    return 0;
+}
+
+int match_timeline_decoder_t::end_string() {
+    m_token = TOKEN_NONE;
+    if (m_has_escapes) {
+        try {
+            m_token_text = nlohmann::json::parse("\"" + m_token_text + "\"").get<std::string>();
+        } catch (std::exception&) {
+            return 1;
+        }
+    }
+    if (m_expected == EXPECTED_KEY) {
+        m_expected = EXPECTED_COLON;
+        return !m_sax->key(m_token_text);
+    }
+    return !m_sax->string(m_token_text) || end_value();
+}
+
+int match_timeline_decoder_t::end_literal() {
+    m_token = TOKEN_NONE;
+    const char* first = m_token_text.data();
+    const char* last = first + m_token_text.size();
+    bool is_accepted = false;
+    if (m_token_text == "true" || m_token_text == "false") {
+        is_accepted = m_sax->boolean(m_token_text == "true");
+    } else if (m_token_text == "null") {
+        is_accepted = m_sax->null();
+    } else if (m_token_text.find_first_of(".eE") != std::string::npos) {
+        double value = 0.0;
+        const std::from_chars_result parsed = std::from_chars(first, last, value);
+        is_accepted = parsed.ec == std::errc() && parsed.ptr == last && m_sax->number_float(value, m_token_text);
+    } else if (m_token_text[0] == '-') {
+        int64_t value = 0;
+        const std::from_chars_result parsed = std::from_chars(first, last, value);
+        is_accepted = parsed.ec == std::errc() && parsed.ptr == last && m_sax->number_integer(value);
+    } else {
+        uint64_t value = 0;
+        const std::from_chars_result parsed = std::from_chars(first, last, value);
+        is_accepted = parsed.ec == std::errc() && parsed.ptr == last && m_sax->number_unsigned(value);
+    }
+    return !is_accepted || end_value();
+}
+
+int match_timeline_decoder_t::write(const char* data, size_t size) {
+    if (m_is_failed) {
+        return 1;
+    }
+
+    const char* cur = data;
+    const char* end = data + size;
+    while (cur < end) {
+        if (m_token == TOKEN_STRING) {
+            const char* start = cur;
+            while (cur < end) {
+                if (m_is_escaped) {
+                    m_is_escaped = false;
+                } else if (*cur == '\\') {
+                    m_is_escaped = true;
+                    m_has_escapes = true;
+                } else if (*cur == '"') {
+                    break ;
+                }
+                ++cur;
+            }
+            m_token_text.append(start, cur - start);
+            if (cur == end) {
+                break ;
+            }
+            ++cur;
+            if (end_string()) {
+                return fail();
+            }
+            continue ;
+        }
+        if (m_token == TOKEN_LITERAL) {
+            const char* start = cur;
+            while (cur < end && (isalnum(static_cast<unsigned char>(*cur)) || *cur == '-' || *cur == '+' || *cur == '.')) {
+                ++cur;
+            }
+            m_token_text.append(start, cur - start);
+            if (cur == end) {
+                break ;
+            }
+            if (end_literal()) {
+                return fail();
+            }
+            continue ;
+        }
+
+        switch (*cur) {
+        case ' ': case '\t': case '\n': case '\r': break ;
+        case '"': {
+            if (m_expected == EXPECTED_KEY) {
+                m_is_container_empty = false;
+            } else if (begin_value()) {
+                return fail();
+            }
+            m_token = TOKEN_STRING;
+            m_token_text.clear();
+            m_has_escapes = false;
+        } break ;
+        case '{': case '[': {
+            const bool is_object = *cur == '{';
+            if (begin_value() || !(is_object ? m_sax->start_object(static_cast<size_t>(-1)) : m_sax->start_array(static_cast<size_t>(-1)))) {
+                return fail();
+            }
+            m_is_object.push_back(is_object);
+            m_expected = is_object ? EXPECTED_KEY : EXPECTED_VALUE;
+            m_is_container_empty = true;
+        } break ;
+        case '}': case ']': {
+            const bool is_object = *cur == '}';
+            const bool is_closable =
+                !m_is_object.empty() && m_is_object.back() == is_object &&
+                (m_expected == EXPECTED_SEPARATOR || (m_is_container_empty && m_expected == (is_object ? EXPECTED_KEY : EXPECTED_VALUE)));
+            if (!is_closable || !(is_object ? m_sax->end_object() : m_sax->end_array())) {
+                return fail();
+            }
+            m_is_object.pop_back();
+            m_is_container_empty = false;
+            end_value();
+        } break ;
+        case ':': {
+            if (m_expected != EXPECTED_COLON) {
+                return fail();
+            }
+            m_expected = EXPECTED_VALUE;
+        } break ;
+        case ',': {
+            if (m_expected != EXPECTED_SEPARATOR || m_is_object.empty()) {
+                return fail();
+            }
+            m_expected = m_is_object.back() ? EXPECTED_KEY : EXPECTED_VALUE;
+        } break ;
+        default: {
+            if (begin_value() || !(isdigit(static_cast<unsigned char>(*cur)) || *cur == '-' || *cur == 't' || *cur == 'f' || *cur == 'n')) {
+                return fail();
+            }
+            m_token = TOKEN_LITERAL;
+            m_token_text.clear();
+            // the literal is read from this character on
+            continue ;
+        }
+        }
+        ++cur;
+    }
+
+    return 0;
+}
+
+int match_timeline_decoder_t::finish() {
+    // a number at the root only ends with the body
+    if (!m_is_failed && m_token == TOKEN_LITERAL && end_literal()) {
+        fail();
+    }
+    if (m_is_failed || m_token != TOKEN_NONE || !m_is_done) {
+        m_result->clear();
+        return 1;
+    }
+    m_result->kills.shrink_to_fit();
+    m_result->wards.shrink_to_fit();
+    m_result->items.shrink_to_fit();
+    m_result->objectives.shrink_to_fit();
+
+    return 0;
+}
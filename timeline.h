@@ -0,0 +1,171 @@
+#ifndef TIMELINE_H
+# define TIMELINE_H
+
+# include <string>
+# include <vector>
+# include <memory>
+# include <cstddef>
+# include <cstdint>
+
+enum timeline_event_kind_t : uint8_t {
+    TIMELINE_EVENT_CHAMPION_KILL,
+    TIMELINE_EVENT_WARD_PLACED,
+    TIMELINE_EVENT_WARD_KILL,
+    TIMELINE_EVENT_ITEM_PURCHASED,
+    TIMELINE_EVENT_ITEM_SOLD,
+    TIMELINE_EVENT_ITEM_DESTROYED,
+    TIMELINE_EVENT_ITEM_UNDO,
+    TIMELINE_EVENT_ELITE_MONSTER_KILL,
+    TIMELINE_EVENT_BUILDING_KILL,
+    TIMELINE_EVENT_TURRET_PLATE_DESTROYED,
+
+    _TIMELINE_EVENT_SIZE
+};
+// Riot's event type name, e.g. "CHAMPION_KILL"
+const char* timeline_event_kind_to_str(timeline_event_kind_t kind);
+
+// detail of ward events
+enum timeline_ward_t : uint16_t {
+    TIMELINE_WARD_UNDEFINED,
+    TIMELINE_WARD_YELLOW_TRINKET,
+    TIMELINE_WARD_CONTROL_WARD,
+    TIMELINE_WARD_SIGHT_WARD,
+    TIMELINE_WARD_BLUE_TRINKET,
+    TIMELINE_WARD_TEEMO_MUSHROOM
+};
+
+// detail of objective events
+enum timeline_objective_t : uint16_t {
+    TIMELINE_OBJECTIVE_OTHER,
+    TIMELINE_OBJECTIVE_DRAGON,
+    TIMELINE_OBJECTIVE_BARON_NASHOR,
+    TIMELINE_OBJECTIVE_RIFTHERALD,
+    TIMELINE_OBJECTIVE_HORDE,
+    TIMELINE_OBJECTIVE_ATAKHAN,
+    TIMELINE_OBJECTIVE_TOWER,
+    TIMELINE_OBJECTIVE_INHIBITOR,
+    TIMELINE_OBJECTIVE_TURRET_PLATE
+};
+
+struct timeline_position_t {
+    int16_t x;
+    int16_t y;
+};
+
+/**
+ * 16 bytes, participant ids are 1 based as in Riot's timeline and 0 for minions, monsters and turrets.
+ * Wards and items have no position in the timeline, they get the participant's position from the previous frame.
+*/
+struct timeline_event_t {
+    int32_t               timestamp_ms;
+    timeline_position_t   position;
+    timeline_event_kind_t kind;
+    uint8_t               participant_id;         // killer, ward creator or killer, item owner
+    uint8_t               victim_id;              // champion kills only
+    uint8_t               team_id;                // objectives: 1 for the blue side (100) killing, 2 for the red side (200)
+    uint16_t              detail;                 // item id, timeline_ward_t or timeline_objective_t
+    uint16_t              assisting_participants; // bit participant_id - 1
+};
+
+/**
+ * Compact decoded match-v5 timeline, the per frame vectors are indexed [frame * n_of_participants + participant_id - 1].
+*/
+struct match_timeline_t {
+    std::vector<std::string>         puuids; // indexed by participant_id - 1
+    size_t                           n_of_participants = 0;
+    std::vector<int32_t>             frame_timestamps_ms;
+    std::vector<int32_t>             total_gold;
+    std::vector<int32_t>             xp;
+    std::vector<timeline_position_t> positions;
+    std::vector<timeline_event_t>    kills;
+    std::vector<timeline_event_t>    wards;
+    std::vector<timeline_event_t>    items;
+    std::vector<timeline_event_t>    objectives;
+
+    void   clear();
+    // heap bytes held, for comparing against a json document of the same timeline
+    size_t memory_size() const;
+    // the vector holding events of that kind, filter it by kind
+    const std::vector<timeline_event_t>& events(timeline_event_kind_t kind) const;
+    // 0 if the puuid did not play in the match
+    int    participant_id(const std::string& puuid) const;
+};
+
+/**
+ * Streams a match-v5 timeline response into result without building a json document,
+ * unknown fields and events are skipped. Returns 0 on success.
+ *
+ * Example call:
+ * match_timeline_t timeline;
+ * if (match_timeline_decode(response.body.data(), response.body.size(), &timeline) == 0) {
+ *   for (const timeline_event_t& kill : timeline.kills) {
+ *     // kill.position, kill.participant_id ...
+ *   }
+ * }
+*/
+int match_timeline_decode(const char* data, size_t size, match_timeline_t* result);
+
+struct timeline_sax_t;
+
+/**
+ * match_timeline_decode for a response that arrives in pieces, e.g. from http_pool_t::request_streamed.
+ * Each piece is tokenized as it comes, only a string or number cut by the end of a piece is kept until the next one,
+ * so the body is never held whole.
+ *
+ * Example call:
+ * match_timeline_t timeline;
+ * match_timeline_decoder_t decoder(&timeline);
+ * pool.request_streamed(request, &response, [&decoder](const char* data, size_t size) {
+ *   return decoder.write(data, size);
+ * });
+ * if (decoder.finish() == 0) {
+ *   // timeline.kills ...
+ * }
+*/
+struct match_timeline_decoder_t {
+    explicit match_timeline_decoder_t(match_timeline_t* result);
+    match_timeline_decoder_t(const match_timeline_decoder_t&) = delete;
+    match_timeline_decoder_t& operator=(const match_timeline_decoder_t&) = delete;
+    ~match_timeline_decoder_t();
+
+    // clears the result and starts over
+    void reset();
+    // returns 0 if the pieces so far are the start of a well formed timeline
+    int  write(const char* data, size_t size);
+    // returns 0 if the pieces since the reset are a whole timeline, the result is cleared otherwise
+    int  finish();
+
+    enum token_t : uint8_t {
+        TOKEN_NONE,
+        TOKEN_STRING,
+        TOKEN_LITERAL // number, true, false or null
+    };
+    enum expected_t : uint8_t {
+        EXPECTED_VALUE,
+        EXPECTED_KEY,
+        EXPECTED_COLON,
+        EXPECTED_SEPARATOR // ',' or the end of the container
+    };
+
+    int  begin_value();
+    int  end_value();
+    int  end_string();
+    int  end_literal();
+    int  fail();
+
+    match_timeline_t*               m_result;
+    std::unique_ptr<timeline_sax_t> m_sax;
+    // open containers, true for objects
+    std::vector<bool>               m_is_object;
+    expected_t                      m_expected = EXPECTED_VALUE;
+    // the innermost container has no element yet
+    bool                            m_is_container_empty = false;
+    token_t                         m_token = TOKEN_NONE;
+    std::string                     m_token_text;
+    bool                            m_is_escaped = false;
+    bool                            m_has_escapes = false;
+    bool                            m_is_done = false;
+    bool                            m_is_failed = false;
+};
+
+#endif // TIMELINE_H
@@ -0,0 +1,375 @@
+// the ui state and its draw functions are static in main.cpp, the bench is compiled together with it to reach them
+#define main tracker_main
+#include "main.cpp"
+#undef main
+
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * Hot paths of the tracker over the checked-in data: parsing the challenge jsons, building the catalog,
+ * find_parent_id over every id, fitting text into rectangles and laying out the current challenge.
+ * The draw cases render into a texture of a hidden window, so they need a display (e.g. xvfb-run on a headless machine),
+ * without one they are reported as skipped and the rest still runs.
+ * Results are written in google benchmark's json format, two runs can be compared with its tools/compare.py.
+ *
+ * Example call:
+ * ./tracker_bench --out before.json
+ * ./tracker_bench --filter draw_ --min-time 2 --out after.json
+ * compare.py benchmarks before.json after.json
+*/
+
+struct bench_case_t {
+    std::string           name;
+    // one iteration
+    std::function<void()> run;
+    size_t                n_of_items_per_iteration = 0;
+    size_t                n_of_bytes_per_iteration = 0;
+    // not empty if the case cannot run in this environment
+    std::string           skip_reason;
+};
+
+struct bench_result_t {
+    std::string name;
+    uint64_t    n_of_iterations = 0;
+    double      real_ns = 0.0; // per iteration
+    double      cpu_ns = 0.0;
+    double      items_per_second = 0.0;
+    double      bytes_per_second = 0.0;
+    std::string skip_reason;
+};
+
+static volatile int64_t bench_sink;
+
+static double process_cpu_ns() {
+    timespec cpu_time;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu_time);
+    return static_cast<double>(cpu_time.tv_sec) * 1e9 + static_cast<double>(cpu_time.tv_nsec);
+}
+
+static bench_result_t run_bench_case(const bench_case_t& bench_case, double min_seconds) {
+    bench_result_t result;
+    result.name = bench_case.name;
+    result.skip_reason = bench_case.skip_reason;
+    if (!result.skip_reason.empty()) {
+        return result;
+    }
+
+    // the first iteration warms caches and loads whatever is loaded lazily, e.g. the challenge icons
+    bench_case.run();
+
+    // grows the batch until one takes at least min_seconds, the way google benchmark picks its iteration count
+    uint64_t n_of_iterations = 1;
+    while (true) {
+        const double cpu_begin = process_cpu_ns();
+        const auto real_begin = std::chrono::steady_clock::now();
+        for (uint64_t iteration = 0; iteration < n_of_iterations; ++iteration) {
+            bench_case.run();
+        }
+        const double real_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - real_begin).count();
+        const double cpu_ns = process_cpu_ns() - cpu_begin;
+
+        if (min_seconds * 1e9 <= real_ns || 1000000000ull <= n_of_iterations) {
+            result.n_of_iterations = n_of_iterations;
+            result.real_ns = real_ns / static_cast<double>(n_of_iterations);
+            result.cpu_ns = cpu_ns / static_cast<double>(n_of_iterations);
+            result.items_per_second = static_cast<double>(bench_case.n_of_items_per_iteration * n_of_iterations) / (real_ns / 1e9);
+            result.bytes_per_second = static_cast<double>(bench_case.n_of_bytes_per_iteration * n_of_iterations) / (real_ns / 1e9);
+            return result;
+        }
+
+        const double multiplier = real_ns <= 0.0 ? 10.0 : std::clamp(min_seconds * 1e9 * 1.4 / real_ns, 2.0, 10.0);
+        n_of_iterations = static_cast<uint64_t>(static_cast<double>(n_of_iterations) * multiplier);
+    }
+}
+
+static nlohmann::json bench_context(const char* executable) {
+    nlohmann::json result;
+
+    char date[64];
+    const time_t now = time(0);
+    strftime(date, ARRAY_SIZE(date), "%Y-%m-%dT%H:%M:%S%z", localtime(&now));
+    result["date"] = date;
+    char host_name[256] = { 0 };
+    gethostname(host_name, ARRAY_SIZE(host_name) - 1);
+    result["host_name"] = host_name;
+    result["executable"] = executable;
+    result["num_cpus"] = std::thread::hardware_concurrency();
+#if defined(NDEBUG)
+    result["library_build_type"] = "release";
+#else
+    result["library_build_type"] = "debug";
+#endif
+    result["tracker_version"] = std::to_string(LEAGUE_TRACKER_VERSION_MAJOR) + "." + std::to_string(LEAGUE_TRACKER_VERSION_MINOR);
+
+    return result;
+}
+
+static nlohmann::json bench_result_to_json(const bench_result_t& bench_result) {
+    nlohmann::json result;
+    result["name"] = bench_result.name;
+    result["run_name"] = bench_result.name;
+    result["run_type"] = "iteration";
+    result["repetitions"] = 1;
+    result["repetition_index"] = 0;
+    result["threads"] = 1;
+    result["iterations"] = bench_result.n_of_iterations;
+    result["real_time"] = bench_result.real_ns;
+    result["cpu_time"] = bench_result.cpu_ns;
+    result["time_unit"] = "ns";
+    if (0.0 < bench_result.items_per_second) {
+        result["items_per_second"] = bench_result.items_per_second;
+    }
+    if (0.0 < bench_result.bytes_per_second) {
+        result["bytes_per_second"] = bench_result.bytes_per_second;
+    }
+    if (!bench_result.skip_reason.empty()) {
+        result["error_occurred"] = true;
+        result["error_message"] = bench_result.skip_reason;
+    }
+
+    return result;
+}
+
+static int read_file(const std::string& path, std::string* result) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "CLIENT failed to open '" << path << "'" << std::endl;
+        return 1;
+    }
+    result->assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    std::string global_challenges_path = "build/global_challenges.json";
+    std::string account_challenges_path = "build/account_challenges.json";
+    std::string out_path;
+    std::string filter;
+    double min_seconds = 0.5;
+    bool are_args_valid = true;
+    for (int arg_index = 1; arg_index < argc && are_args_valid; ++arg_index) {
+        const bool has_value = arg_index + 1 < argc;
+        if (!strcmp(argv[arg_index], "--global-challenges") && has_value) {
+            global_challenges_path = argv[++arg_index];
+        } else if (!strcmp(argv[arg_index], "--account-challenges") && has_value) {
+            account_challenges_path = argv[++arg_index];
+        } else if (!strcmp(argv[arg_index], "--out") && has_value) {
+            out_path = argv[++arg_index];
+        } else if (!strcmp(argv[arg_index], "--filter") && has_value) {
+            filter = argv[++arg_index];
+        } else if (!strcmp(argv[arg_index], "--min-time") && has_value) {
+            min_seconds = std::stod(argv[++arg_index]);
+        } else {
+            are_args_valid = false;
+        }
+    }
+    if (!are_args_valid) {
+        std::cerr << "usage: <tracker_bench_bin> [--global-challenges <path>] [--account-challenges <path>] [--out <json path>] [--filter <substring of case names>] [--min-time <seconds per case>]" << std::endl;
+        return 1;
+    }
+
+    // parsed from memory, the cases measure the parser and not the disk
+    std::string global_challenges_text;
+    std::string challenges_local_text;
+    std::string account_challenges_text;
+    if (
+        read_file(global_challenges_path, &global_challenges_text) ||
+        read_file("assets/challenges.json", &challenges_local_text) ||
+        read_file(account_challenges_path, &account_challenges_text)
+    ) {
+        return 1;
+    }
+    const nlohmann::json global_challenges = nlohmann::json::parse(global_challenges_text);
+    _.challenges_local = nlohmann::json::parse(challenges_local_text);
+    if (_.catalog.build(global_challenges, _.challenges_local)) {
+        std::cerr << "CLIENT failed to build the challenge catalog" << std::endl;
+        return 1;
+    }
+    _.accounts.emplace_back();
+    if (_.accounts.back().load(_.catalog, nlohmann::json::parse(account_challenges_text))) {
+        std::cerr << "CLIENT failed to load '" << account_challenges_path << "'" << std::endl;
+        return 1;
+    }
+    _.current_account = 0;
+    _.window_w = 2400;
+    _.window_h = 1200;
+
+    std::vector<int> ids;
+    ids.reserve(_.catalog.m_challenges.size());
+    challenge_t* widest_node = _.catalog.m_root;
+    challenge_t* leaf_node = 0;
+    for (challenge_t& challenge : _.catalog.m_challenges) {
+        ids.push_back(challenge.id);
+        if (widest_node->children.size() < challenge.children.size()) {
+            widest_node = &challenge;
+        }
+        if (!leaf_node && challenge.children.empty()) {
+            leaf_node = &challenge;
+        }
+    }
+
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(_.window_w, _.window_h, "tracker_bench");
+    const bool is_window_ready = IsWindowReady();
+    std::string draw_skip_reason;
+    RenderTexture2D target = {};
+    if (is_window_ready) {
+        _.liberation_mono = LoadFont("assets/LiberationMono-Regular.ttf");
+        target = LoadRenderTexture(_.window_w, _.window_h);
+    } else {
+        draw_skip_reason = "no window could be opened, run under a display";
+    }
+
+    // about a tile of a 16 wide challenge grid and the description of the detailed view
+    const Rectangle short_description_rec = { .x = 0.0f, .y = 0.0f, .width = _.window_w * 0.98f / 16.0f * 0.6f, .height = _.window_h * 0.94f / 16.0f * 0.6f };
+    const Rectangle description_rec = { .x = 0.0f, .y = 0.0f, .width = _.window_w * 0.98f, .height = _.window_h * 0.94f * 0.9f * 0.25f };
+    auto draw_to_target = [&target](const std::function<void()>& draw_calls) {
+        BeginTextureMode(target);
+        ClearBackground(BLACK);
+        draw_calls();
+        EndTextureMode();
+    };
+    auto draw_current_challenge_case = [&](const std::string& name, challenge_t* node) {
+        bench_case_t result;
+        result.name = name;
+        result.run = [&draw_to_target, node]() {
+            _.current_challange = node;
+            draw_to_target([]() {
+                draw_current_challenge();
+            });
+        };
+        result.n_of_items_per_iteration = node->children.empty() ? 1 : node->children.size();
+        result.skip_reason = draw_skip_reason;
+        return result;
+    };
+
+    std::vector<bench_case_t> bench_cases;
+    bench_cases.push_back({
+        .name = "json_parse/global_challenges",
+        .run = [&global_challenges_text]() {
+            bench_sink = nlohmann::json::parse(global_challenges_text).size();
+        },
+        .n_of_items_per_iteration = 0,
+        .n_of_bytes_per_iteration = global_challenges_text.size(),
+        .skip_reason = ""
+    });
+    bench_cases.push_back({
+        .name = "json_parse/challenges_local",
+        .run = [&challenges_local_text]() {
+            bench_sink = nlohmann::json::parse(challenges_local_text).size();
+        },
+        .n_of_items_per_iteration = 0,
+        .n_of_bytes_per_iteration = challenges_local_text.size(),
+        .skip_reason = ""
+    });
+    bench_cases.push_back({
+        .name = "json_parse/account_challenges",
+        .run = [&account_challenges_text]() {
+            bench_sink = nlohmann::json::parse(account_challenges_text).size();
+        },
+        .n_of_items_per_iteration = 0,
+        .n_of_bytes_per_iteration = account_challenges_text.size(),
+        .skip_reason = ""
+    });
+    bench_cases.push_back({
+        .name = "catalog_build",
+        .run = [&global_challenges]() {
+            challenge_catalog_t catalog;
+            catalog.build(global_challenges, _.challenges_local);
+            bench_sink = catalog.m_challenges.size();
+        },
+        .n_of_items_per_iteration = _.catalog.m_challenges.size(),
+        .n_of_bytes_per_iteration = 0,
+        .skip_reason = ""
+    });
+    bench_cases.push_back({
+        .name = "find_parent_id/all_ids",
+        .run = [&ids]() {
+            int64_t parent_ids_sum = 0;
+            for (int id : ids) {
+                parent_ids_sum += find_parent_id(id);
+            }
+            bench_sink = parent_ids_sum;
+        },
+        .n_of_items_per_iteration = ids.size(),
+        .n_of_bytes_per_iteration = 0,
+        .skip_reason = ""
+    });
+    bench_cases.push_back({
+        .name = "draw_text_in_rec_helper/short_descriptions",
+        .run = [&draw_to_target, &short_description_rec]() {
+            draw_to_target([&short_description_rec]() {
+                for (const challenge_t& challenge : _.catalog.m_challenges) {
+                    draw_text_in_rec_helper(challenge.short_description.c_str(), short_description_rec, 1);
+                }
+            });
+        },
+        .n_of_items_per_iteration = _.catalog.m_challenges.size(),
+        .n_of_bytes_per_iteration = 0,
+        .skip_reason = draw_skip_reason
+    });
+    bench_cases.push_back({
+        .name = "draw_text_in_rec_helper/descriptions",
+        .run = [&draw_to_target, &description_rec]() {
+            draw_to_target([&description_rec]() {
+                for (const challenge_t& challenge : _.catalog.m_challenges) {
+                    draw_text_in_rec_helper(challenge.description.c_str(), description_rec, 1);
+                }
+            });
+        },
+        .n_of_items_per_iteration = _.catalog.m_challenges.size(),
+        .n_of_bytes_per_iteration = 0,
+        .skip_reason = draw_skip_reason
+    });
+    bench_cases.push_back(draw_current_challenge_case("draw_current_challenge/root", _.catalog.m_root));
+    bench_cases.push_back(draw_current_challenge_case("draw_current_challenge/widest", widest_node));
+    if (leaf_node) {
+        bench_cases.push_back(draw_current_challenge_case("draw_current_challenge/leaf", leaf_node));
+    }
+
+    nlohmann::json report;
+    report["context"] = bench_context(argv[0]);
+    report["benchmarks"] = nlohmann::json::array();
+    for (const bench_case_t& bench_case : bench_cases) {
+        if (!filter.empty() && bench_case.name.find(filter) == std::string::npos) {
+            continue ;
+        }
+
+        const bench_result_t bench_result = run_bench_case(bench_case, min_seconds);
+        report["benchmarks"].push_back(bench_result_to_json(bench_result));
+        if (!bench_result.skip_reason.empty()) {
+            std::cerr << bench_result.name << ": skipped, " << bench_result.skip_reason << std::endl;
+        } else {
+            std::cerr << bench_result.name << ": " << bench_result.real_ns / 1000.0 << " us real, " << bench_result.cpu_ns / 1000.0
+                      << " us cpu over " << bench_result.n_of_iterations << " iterations" << std::endl;
+        }
+    }
+
+    if (is_window_ready) {
+        for (Texture2D& icon : _.challenge_icons) {
+            if (icon.id != 0) {
+                UnloadTexture(icon);
+            }
+        }
+        UnloadRenderTexture(target);
+        UnloadFont(_.liberation_mono);
+        CloseWindow();
+    }
+
+    if (out_path.empty()) {
+        std::cout << report.dump(2) << std::endl;
+    } else {
+        std::ofstream out_file(out_path);
+        out_file << report.dump(2) << std::endl;
+        if (!out_file) {
+            std::cerr << "CLIENT failed to write '" << out_path << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}